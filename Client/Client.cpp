@@ -18,9 +18,186 @@
 
 #include "Client.h"
 
+#ifdef USE_TLS
+//   TCP    STRIPE_PORT  Ѵ.     Ű Ű ȯ Ŀ ȣȭϿ Ѵ.
+int SendFile( const char * pszIp, const char * pszFileName, int iMaxStream )
+{
+	CStripeSender clsSender;
+	struct timeval sttStart, sttEnd;
+	std::string strPsk;
+
+	signal( SIGPIPE, SIG_IGN );
+
+	if( LoadPsk( CLIENT_PSK_FILE, strPsk ) == false )
+	{
+		printf( "LoadPsk(%s) error - pre-shared key must be at least %d bytes and readable only by owner\n", CLIENT_PSK_FILE, AEAD_MIN_PSK_SIZE );
+		return 1;
+	}
+
+	clsSender.SetPsk( strPsk );
+	OPENSSL_cleanse( &strPsk[0], strPsk.length() );
+
+	gettimeofday( &sttStart, NULL );
+
+	if( clsSender.Send( pszIp, STRIPE_PORT, pszFileName, iMaxStream ) == false )
+	{
+		printf( "Send(%s) error\n", pszFileName );
+		return 1;
+	}
+
+	gettimeofday( &sttEnd, NULL );
+
+	double dSecond = ( sttEnd.tv_sec - sttStart.tv_sec ) + ( sttEnd.tv_usec - sttStart.tv_usec ) / 1000000.0;
+
+	printf( "%s " UNSIGNED_LONG_LONG_FORMAT " bytes %.2f sec %.2f MB/s stream(%d)\n", pszFileName, clsSender.GetFileSize(), dSecond
+		, dSecond > 0 ? clsSender.GetFileSize() / dSecond / 1000000 : 0, clsSender.GetStreamCount() );
+
+	return 0;
+}
+#endif
+
+#ifdef USE_TLS
+// ǥ Է ȣȭϿ  ϰ   shell  ǥ ¿ Ѵ.
+// ǥ Է terminal ̸ Է Ű ٷ ϵ raw  Ѵ.
+void Relay( Socket hSocket, CAeadCipher & clsCipher )
+{
+	struct termios sttOld, sttRaw;
+	char szFrame[AEAD_MAX_FRAME_SIZE];
+	pollfd sttPoll[2];
+	bool bTerminal = ( isatty( 0 ) == 1 ), bStdin = true;
+	int n, iPollCount;
+
+	if( bTerminal && tcgetattr( 0, &sttOld ) == 0 )
+	{
+		sttRaw = sttOld;
+		cfmakeraw( &sttRaw );
+		tcsetattr( 0, TCSANOW, &sttRaw );
+	}
+	else
+	{
+		bTerminal = false;
+	}
+
+	while( 1 )
+	{
+		TcpSetPollIn( sttPoll[0], hSocket );
+		iPollCount = 1;
+
+		// ǥ Է Ǹ  shell   ϰ    Ÿ Ѵ.
+		if( bStdin )
+		{
+			TcpSetPollIn( sttPoll[1], 0 );
+			iPollCount = 2;
+		}
+
+		n = poll( sttPoll, iPollCount, -1 );
+		if( n == -1 )
+		{
+			if( errno == EINTR ) continue;
+			break;
+		}
+
+		if( sttPoll[0].revents )
+		{
+			n = TcpRecvAead( hSocket, clsCipher, szFrame, sizeof(szFrame), 10 );
+			if( n < 0 ) break;
+
+			if( n > 0 && write( 1, szFrame + AEAD_HEADER_SIZE, n ) != n ) break;
+		}
+
+		if( iPollCount == 2 && sttPoll[1].revents )
+		{
+			n = read( 0, szFrame + AEAD_HEADER_SIZE, AEAD_MAX_PLAIN_SIZE );
+			if( n <= 0 )
+			{
+				bStdin = false;
+				continue;
+			}
+
+			if( TcpSendAead( hSocket, clsCipher, szFrame, n ) != n ) break;
+		}
+	}
+
+	if( bTerminal ) tcsetattr( 0, TCSANOW, &sttOld );
+}
+#endif
+
 int main( int argc, char * argv[] )
 {
+	if( argc < 2 )
+	{
+		printf( "[Usage] %s {server ip} {server port}\n", argv[0] );
+		printf( "        %s {server ip} -s {file} [max stream]\n", argv[0] );
+		return 0;
+	}
+
+	const char * pszIp = argv[1];
+	int iPort = 8888;
+
 	InitNetwork();
 
+#ifdef USE_TLS
+	if( argc >= 4 && !strcmp( argv[2], "-s" ) )
+	{
+		return SendFile( pszIp, argv[3], argc >= 5 ? atoi( argv[4] ) : STRIPE_MAX_STREAM );
+	}
+#endif
+
+	if( argc >= 3 ) iPort = atoi( argv[2] );
+
+	Socket hSocket = INVALID_SOCKET;
+
+#ifndef WIN32
+	//  ȣƮ  Ʈ ȣ شϴ Unix   Ѵ.
+	if( IsLocalHost( pszIp ) )
+	{
+		std::string strPath;
+
+		if( GetLocalSocketPath( iPort, strPath, false ) )
+		{
+			hSocket = UnixConnect( strPath.c_str() );
+		}
+	}
+#endif
+
+	if( hSocket == INVALID_SOCKET )
+	{
+		hSocket = TcpConnect( pszIp, iPort, 10 );
+	}
+
+	if( hSocket == INVALID_SOCKET )
+	{
+		printf( "TcpConnect(%s:%d) error(%d)\n", pszIp, iPort, GetError() );
+		return 0;
+	}
+
+#ifdef USE_TLS
+	CAeadCipher clsCipher;
+	std::string strPsk;
+
+	signal( SIGPIPE, SIG_IGN );
+
+	if( LoadPsk( CLIENT_PSK_FILE, strPsk ) == false )
+	{
+		printf( "LoadPsk(%s) error - pre-shared key must be at least %d bytes and readable only by owner\n", CLIENT_PSK_FILE, AEAD_MIN_PSK_SIZE );
+		closesocket( hSocket );
+		return 0;
+	}
+
+	bool bRes = clsCipher.Handshake( hSocket, false, 10, strPsk.c_str() );
+	OPENSSL_cleanse( &strPsk[0], strPsk.length() );
+
+	if( bRes == false )
+	{
+		printf( "Handshake() error\n" );
+	}
+	else
+	{
+		Relay( hSocket, clsCipher );
+	}
+#endif
+
+	closesocket( hSocket );
+
 	return 0;
 }
@@ -20,5 +20,16 @@
 #define _SERVER_H_
 
 #include "Tcp.h"
+#include "AeadCipher.h"
+#include "UnixSocket.h"
+#include "StripeTransfer.h"
+
+#ifndef WIN32
+#include <signal.h>
+#include <termios.h>
+#endif
+
+// Ű ȯ ϴ   Ű .  TelnetServer.psk   Ű ϸ ڸ   ־ Ѵ. ( chmod 600 )
+#define CLIENT_PSK_FILE		"TelnetClient.psk"
 
 #endif
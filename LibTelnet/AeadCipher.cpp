@@ -0,0 +1,1006 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "AeadCipher.h"
+
+#ifdef USE_TLS
+
+#include <openssl/crypto.h>
+#include <openssl/kdf.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "MemoryDebug.h"
+
+#ifdef WIN32
+#include <intrin.h>
+#endif
+
+#ifdef __linux__
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+#include <sys/sendfile.h>
+#include <pthread.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS		282
+#endif
+#endif
+
+#define AEAD_VERSION				1
+#define AEAD_KEY_BLOCK_SIZE	( ( AEAD_KEY_SIZE + AEAD_IV_SIZE ) * 2 )
+
+// hello ޽ flag
+#define AEAD_FLAG_KTLS			0x01
+
+/**
+ * @ingroup LibTelnet
+ * @brief Export / Import ϴ ȣȭ .  ȣƮ μ ϹǷ host byte order  Ѵ.
+ */
+typedef struct
+{
+	uint8_t		iSuite;
+	uint8_t		iKtls;
+	uint8_t		arrReserved[6];
+	uint8_t		szSendKey[AEAD_KEY_SIZE+AEAD_IV_SIZE];
+	uint8_t		szRecvKey[AEAD_KEY_SIZE+AEAD_IV_SIZE];
+	uint64_t	iSendSeq;
+	uint64_t	iRecvSeq;
+} AEAD_STATE;
+
+// kTLS Ű ġ Ŀ ȯϴ Ȯ ޽
+#define AEAD_FINISHED				"telnet-finished"
+#define AEAD_FINISHED_SIZE	16
+
+/**
+ * @ingroup LibTelnet
+ * @brief CPU  AES-NI  PCLMULQDQ ɾ ϴ ˻Ѵ.
+ *	- OpenSSL  ο CPU  ˻Ͽ AES-NI/PCLMUL/AVX2 Ŀ ϹǷ ⼭ ˰ ÿ Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CpuSupportAesNi()
+{
+#if defined WIN32
+	int arrInfo[4];
+
+	__cpuid( arrInfo, 1 );
+
+	return ( arrInfo[2] & ( 1 << 25 ) ) && ( arrInfo[2] & ( 1 << 1 ) );
+#elif defined __x86_64__ || defined __i386__
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports( "aes" ) && __builtin_cpu_supports( "pclmul" );
+#else
+	return false;
+#endif
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ͽ   Ű д´.
+ *	-  ù°    Ű Ѵ.
+ *	-  ̿ ڰ   ִ   ʴ´. ( chmod 600 )
+ * @param pszFileName	  Ű  
+ * @param strPsk			  Ű  
+ * @returns   Ű AEAD_MIN_PSK_SIZE ̸̻ true  ϰ ׷  false  Ѵ.
+ */
+bool LoadPsk( const char * pszFileName, std::string & strPsk )
+{
+	struct stat sttStat;
+	char szLine[1024];
+	int iLen;
+
+	strPsk.clear();
+
+	FILE * fd = fopen( pszFileName, "r" );
+	if( fd == NULL ) return false;
+
+	if( fstat( fileno( fd ), &sttStat ) == -1 || ( sttStat.st_mode & ( S_IRWXG | S_IRWXO ) ) )
+	{
+		fclose( fd );
+		return false;
+	}
+
+	if( fgets( szLine, sizeof(szLine), fd ) )
+	{
+		iLen = (int)strlen( szLine );
+		while( iLen > 0 && ( szLine[iLen-1] == '\r' || szLine[iLen-1] == '\n' ) ) --iLen;
+
+		strPsk.assign( szLine, iLen );
+	}
+
+	OPENSSL_cleanse( szLine, sizeof(szLine) );
+	fclose( fd );
+
+	if( strPsk.length() < AEAD_MIN_PSK_SIZE )
+	{
+		strPsk.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief monotonic ð milli second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicMs()
+{
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000 + sttTime.tv_nsec / 1000000;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CAeadCipher::CAeadCipher() : m_eSuite(E_AEAD_NULL), m_ePreferSuite(E_AEAD_NULL), m_bUseKtls(true), m_bKtls(false), m_psttSendCtx(NULL), m_psttRecvCtx(NULL)
+	, m_iSendSeq(0), m_iRecvSeq(0), m_eHandshake(E_AH_NULL), m_bServer(false), m_psttKey(NULL), m_iRecvLen(0)
+{
+	memset( m_szSendIv, 0, sizeof(m_szSendIv) );
+	memset( m_szRecvIv, 0, sizeof(m_szRecvIv) );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CAeadCipher::~CAeadCipher()
+{
+	Close();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ۽ X25519 Ű ȯ Ͽ ۽/ Ű Ѵ. Ű ȯ Ϸ   ʴ´.
+ * @param hSocket	 TCP  ڵ
+ * @param bServer	̸ true  Էϰ Ŭ̾Ʈ̸ false  ԷѴ.
+ * @param iSecond	Ű ȯ timeout (   )
+ * @param pszPsk	  Ű. AEAD_MIN_PSK_SIZE ̻̾ Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::Handshake( Socket hSocket, bool bServer, int iSecond, const char * pszPsk )
+{
+	if( HandshakeStart( hSocket, bServer, pszPsk ) == false ) return false;
+
+	uint64_t iDeadline = GetMonotonicMs() + iSecond * 1000;
+	pollfd sttPoll[1];
+	int n;
+
+	while( 1 )
+	{
+		n = HandshakeRecv( hSocket );
+		if( n == 1 ) return true;
+		if( n == -1 ) break;
+
+		uint64_t iNow = GetMonotonicMs();
+		if( iNow >= iDeadline ) break;
+
+		TcpSetPollIn( sttPoll[0], hSocket );
+		if( poll( sttPoll, 1, (int)( iDeadline - iNow ) ) == -1 && errno != EINTR ) break;
+	}
+
+	Close();
+
+	return false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief hello ޽ ( version, ȣ ˰, kTLS  , X25519 Ű )  Ͽ Ű ȯ Ѵ.
+ *	-  б   HandshakeRecv  ȣϿ Ű ȯ Ѵ.
+ *	-   kTLS  ϸ Ű Ͽ ġϿ Ŀο ȣȭϰ ׷  user-space  ȣȭѴ.
+ * @param hSocket	 TCP  ڵ
+ * @param bServer	̸ true  Էϰ Ŭ̾Ʈ̸ false  ԷѴ.
+ * @param pszPsk	  Ű. AEAD_MIN_PSK_SIZE ̻̾ Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::HandshakeStart( Socket hSocket, bool bServer, const char * pszPsk )
+{
+	uint8_t * pszMyHello = m_szTranscript + ( bServer ? AEAD_HELLO_SIZE : 0 );
+	EVP_PKEY_CTX * psttCtx;
+	size_t iLen;
+
+	Close();
+
+	// PSK  Ű ȯϸ ߰ Ű ȯ ߰ϴ ڸ   .
+	if( pszPsk == NULL || strlen( pszPsk ) < AEAD_MIN_PSK_SIZE ) return false;
+
+	psttCtx = EVP_PKEY_CTX_new_id( EVP_PKEY_X25519, NULL );
+	if( psttCtx == NULL ) return false;
+
+	if( EVP_PKEY_keygen_init( psttCtx ) <= 0 || EVP_PKEY_keygen( psttCtx, &m_psttKey ) <= 0 )
+	{
+		EVP_PKEY_CTX_free( psttCtx );
+		Close();
+		return false;
+	}
+
+	EVP_PKEY_CTX_free( psttCtx );
+
+	m_bServer = bServer;
+	m_strPsk = pszPsk;
+
+	pszMyHello[0] = AEAD_VERSION;
+	pszMyHello[1] = m_ePreferSuite;
+	if( m_ePreferSuite == E_AEAD_NULL ) pszMyHello[1] = CpuSupportAesNi() ? E_AEAD_AES_256_GCM : E_AEAD_CHACHA20_POLY1305;
+	pszMyHello[2] = ( m_bUseKtls && KtlsAvailable( pszMyHello[1] ) && KtlsAttach( hSocket ) ) ? AEAD_FLAG_KTLS : 0;
+	pszMyHello[3] = 0;
+
+	iLen = AEAD_PUBLIC_KEY_SIZE;
+	if( EVP_PKEY_get_raw_public_key( m_psttKey, pszMyHello + 4, &iLen ) <= 0 ||
+			TcpSend( hSocket, (char *)pszMyHello, AEAD_HELLO_SIZE ) != AEAD_HELLO_SIZE )
+	{
+		Close();
+		return false;
+	}
+
+	m_eHandshake = E_AH_HELLO;
+	m_iRecvLen = 0;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ͽ ŵ Ű ȯ ޽ óѴ.  block  ʴ´.
+ *	- Ű ȯ ޽ Ŀ ŵ ͸  ʵ ޽ ũ⸸ŭ Ѵ.
+ * @param hSocket	 TCP  ڵ
+ * @returns Ű ȯ ϷǸ 1  ϰ ޽  ؾ ϸ 0  ϸ ϸ -1  Ѵ.
+ */
+int CAeadCipher::HandshakeRecv( Socket hSocket )
+{
+	uint8_t * pszPeerHello = m_szTranscript + ( m_bServer ? 0 : AEAD_HELLO_SIZE );
+	int n, iSize;
+
+	while( m_eHandshake == E_AH_HELLO || m_eHandshake == E_AH_FINISHED )
+	{
+		if( m_eHandshake == E_AH_HELLO )
+		{
+			iSize = AEAD_HELLO_SIZE;
+			n = recv( hSocket, (char *)pszPeerHello + m_iRecvLen, iSize - m_iRecvLen, MSG_DONTWAIT );
+		}
+		else
+		{
+			iSize = m_bKtls ? AEAD_FINISHED_SIZE : AEAD_HEADER_SIZE + AEAD_TAG_SIZE;
+			n = recv( hSocket, m_szFinished + m_iRecvLen, iSize - m_iRecvLen, MSG_DONTWAIT );
+		}
+
+		if( n == -1 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ) return 0;
+		if( n <= 0 ) break;
+
+		m_iRecvLen += n;
+		if( m_iRecvLen < iSize ) continue;
+
+		m_iRecvLen = 0;
+
+		if( m_eHandshake == E_AH_HELLO )
+		{
+			if( RecvHello( hSocket ) == false ) break;
+			m_eHandshake = E_AH_FINISHED;
+			continue;
+		}
+
+		// kTLS  Ŀο ȣȭ Ȯ ޽ ϰ user-space    tag  Ѵ. PSK  ٸ ⼭ Ѵ.
+		if( m_bKtls )
+		{
+			if( memcmp( m_szFinished, AEAD_FINISHED, AEAD_FINISHED_SIZE ) ) break;
+		}
+		else if( Open( m_szFinished, AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) != 0 )
+		{
+			break;
+		}
+
+		m_eHandshake = E_AH_DONE;
+		OPENSSL_cleanse( &m_strPsk[0], m_strPsk.length() );
+		m_strPsk.clear();
+		EVP_PKEY_free( m_psttKey );
+		m_psttKey = NULL;
+
+		return 1;
+	}
+
+	if( m_eHandshake == E_AH_DONE ) return 1;
+
+	Close();
+
+	return -1;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ȣȭ context  Ѵ.
+ */
+void CAeadCipher::Close()
+{
+	if( m_psttSendCtx )
+	{
+		EVP_CIPHER_CTX_free( m_psttSendCtx );
+		m_psttSendCtx = NULL;
+	}
+
+	if( m_psttRecvCtx )
+	{
+		EVP_CIPHER_CTX_free( m_psttRecvCtx );
+		m_psttRecvCtx = NULL;
+	}
+
+	if( m_psttKey )
+	{
+		EVP_PKEY_free( m_psttKey );
+		m_psttKey = NULL;
+	}
+
+	if( m_strPsk.empty() == false )
+	{
+		OPENSSL_cleanse( &m_strPsk[0], m_strPsk.length() );
+		m_strPsk.clear();
+	}
+
+	OPENSSL_cleanse( m_szSendKey, sizeof(m_szSendKey) );
+	OPENSSL_cleanse( m_szRecvKey, sizeof(m_szRecvKey) );
+	OPENSSL_cleanse( m_szSendIv, sizeof(m_szSendIv) );
+	OPENSSL_cleanse( m_szRecvIv, sizeof(m_szRecvIv) );
+
+	m_eSuite = E_AEAD_NULL;
+	m_bKtls = false;
+	m_iSendSeq = 0;
+	m_iRecvSeq = 0;
+	m_eHandshake = E_AH_NULL;
+	m_iRecvLen = 0;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ۿ   ȣȭѴ. ȣȭ   ȿ ȴ.
+ * @param pszFrame	 .  pszFrame + AEAD_HEADER_SIZE ġ Ǿ ־ ϰ
+ *									 ڿ AEAD_TAG_SIZE ŭ   ־ Ѵ.
+ * @param iPlainLen	 
+ * @returns ϸ   ̸ ϰ ׷  -1  Ѵ.
+ */
+int CAeadCipher::Seal( char * pszFrame, int iPlainLen )
+{
+	uint8_t	szNonce[AEAD_IV_SIZE];
+	uint8_t * pszHeader = (uint8_t *)pszFrame;
+	uint8_t * pszBody = pszHeader + AEAD_HEADER_SIZE;
+	uint32_t iBodyLen = iPlainLen + AEAD_TAG_SIZE;
+	int n, iFinalLen;
+
+	if( m_psttSendCtx == NULL || iPlainLen < 0 || iPlainLen > AEAD_MAX_PLAIN_SIZE ) return -1;
+
+	pszHeader[0] = (uint8_t)( iBodyLen >> 24 );
+	pszHeader[1] = (uint8_t)( iBodyLen >> 16 );
+	pszHeader[2] = (uint8_t)( iBodyLen >> 8 );
+	pszHeader[3] = (uint8_t)( iBodyLen );
+
+	MakeNonce( m_szSendIv, m_iSendSeq, szNonce );
+
+	if( EVP_EncryptInit_ex( m_psttSendCtx, NULL, NULL, NULL, szNonce ) != 1 ) return -1;
+	if( EVP_EncryptUpdate( m_psttSendCtx, NULL, &n, pszHeader, AEAD_HEADER_SIZE ) != 1 ) return -1;
+	if( EVP_EncryptUpdate( m_psttSendCtx, pszBody, &n, pszBody, iPlainLen ) != 1 ) return -1;
+	if( EVP_EncryptFinal_ex( m_psttSendCtx, pszBody + n, &iFinalLen ) != 1 ) return -1;
+	if( EVP_CIPHER_CTX_ctrl( m_psttSendCtx, EVP_CTRL_AEAD_GET_TAG, AEAD_TAG_SIZE, pszBody + iPlainLen ) != 1 ) return -1;
+
+	++m_iSendSeq;
+
+	return AEAD_HEADER_SIZE + iBodyLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ȣȭѴ. ȣȭ   ȿ ȴ.
+ * @param pszFrame	 
+ * @param iFrameLen	 
+ * @returns ϸ pszFrame + AEAD_HEADER_SIZE ġ   ̸ ϰ ׷  -1  Ѵ.
+ */
+int CAeadCipher::Open( char * pszFrame, int iFrameLen )
+{
+	uint8_t	szNonce[AEAD_IV_SIZE];
+	uint8_t * pszHeader = (uint8_t *)pszFrame;
+	uint8_t * pszBody = pszHeader + AEAD_HEADER_SIZE;
+	uint32_t iBodyLen;
+	int n, iPlainLen, iFinalLen;
+
+	if( m_psttRecvCtx == NULL || iFrameLen < AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) return -1;
+
+	iBodyLen = ( (uint32_t)pszHeader[0] << 24 ) | ( (uint32_t)pszHeader[1] << 16 ) | ( (uint32_t)pszHeader[2] << 8 ) | pszHeader[3];
+	if( iBodyLen != (uint32_t)( iFrameLen - AEAD_HEADER_SIZE ) ) return -1;
+
+	iPlainLen = iBodyLen - AEAD_TAG_SIZE;
+
+	MakeNonce( m_szRecvIv, m_iRecvSeq, szNonce );
+
+	if( EVP_DecryptInit_ex( m_psttRecvCtx, NULL, NULL, NULL, szNonce ) != 1 ) return -1;
+	if( EVP_DecryptUpdate( m_psttRecvCtx, NULL, &n, pszHeader, AEAD_HEADER_SIZE ) != 1 ) return -1;
+	if( EVP_DecryptUpdate( m_psttRecvCtx, pszBody, &n, pszBody, iPlainLen ) != 1 ) return -1;
+	if( EVP_CIPHER_CTX_ctrl( m_psttRecvCtx, EVP_CTRL_AEAD_SET_TAG, AEAD_TAG_SIZE, pszBody + iPlainLen ) != 1 ) return -1;
+	if( EVP_DecryptFinal_ex( m_psttRecvCtx, pszBody + n, &iFinalLen ) != 1 ) return -1;
+
+	++m_iRecvSeq;
+
+	return iPlainLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ű ȯ ϷǾ ˻Ѵ.
+ * @returns Ű ȯ ϷǾ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::IsOpen()
+{
+	return ( m_eHandshake == E_AH_DONE );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ŀο ȣȭ/ȣȭϴ ˻Ѵ.
+ * @returns kTLS  ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::IsKtls()
+{
+	return m_bKtls;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief kTLS  θ Ѵ. Handshake ޼ҵ ȣ  ȣؾ Ѵ.
+ * @param bUseKtls	kTLS  Ϸ true  Էϰ user-space ȣȭ Ϸ false  ԷѴ.
+ */
+void CAeadCipher::SetUseKtls( bool bUseKtls )
+{
+	m_bUseKtls = bUseKtls;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief hello ޽  ȣ ˰ Ѵ.   AES-256-GCM  ȣϿ AES-256-GCM  Ѵ.
+ * @param eSuite	ȣ ˰. E_AEAD_NULL ̸ CPU  AES-NI  ϴ ˻Ͽ Ѵ.
+ */
+void CAeadCipher::SetSuite( EAeadSuite eSuite )
+{
+	m_ePreferSuite = eSuite;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵ ο μ  ȣȭ ¸ Ѵ.
+ *	- kTLS  Ű Ͽ ġǾ Ƿ ϸ ϸ ȴ.
+ *	- user-space ȣȭ ¿ Ű ԵǹǷ  Ŀ OPENSSL_cleanse  ؾ Ѵ.
+ * @param strState ȣȭ ¸ ߰ 
+ * @returns Ű ȯ ϷǾ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::Export( std::string & strState )
+{
+	AEAD_STATE sttState;
+
+	if( IsOpen() == false ) return false;
+
+	memset( &sttState, 0, sizeof(sttState) );
+	sttState.iSuite = (uint8_t)m_eSuite;
+	sttState.iKtls = m_bKtls ? 1 : 0;
+
+	if( m_bKtls == false )
+	{
+		memcpy( sttState.szSendKey, m_szSendKey, AEAD_KEY_SIZE );
+		memcpy( sttState.szSendKey + AEAD_KEY_SIZE, m_szSendIv, AEAD_IV_SIZE );
+		memcpy( sttState.szRecvKey, m_szRecvKey, AEAD_KEY_SIZE );
+		memcpy( sttState.szRecvKey + AEAD_KEY_SIZE, m_szRecvIv, AEAD_IV_SIZE );
+		sttState.iSendSeq = m_iSendSeq;
+		sttState.iRecvSeq = m_iRecvSeq;
+	}
+
+	strState.append( (char *)&sttState, sizeof(sttState) );
+	OPENSSL_cleanse( &sttState, sizeof(sttState) );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   μ Export  ȣȭ ¸ Ѵ.
+ * @param pszState		ȣȭ 
+ * @param iStateLen	ȣȭ  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::Import( const char * pszState, int iStateLen )
+{
+	AEAD_STATE sttState;
+	bool bRes = true;
+
+	Close();
+
+	if( iStateLen != (int)sizeof(sttState) ) return false;
+
+	memcpy( &sttState, pszState, sizeof(sttState) );
+
+	if( sttState.iSuite != E_AEAD_AES_256_GCM && sttState.iSuite != E_AEAD_CHACHA20_POLY1305 )
+	{
+		bRes = false;
+	}
+	else
+	{
+		m_eSuite = (EAeadSuite)sttState.iSuite;
+
+		if( sttState.iKtls )
+		{
+			m_bKtls = true;
+		}
+		else if( SetKey( sttState.szSendKey, sttState.szRecvKey ) )
+		{
+			m_iSendSeq = sttState.iSendSeq;
+			m_iRecvSeq = sttState.iRecvSeq;
+		}
+		else
+		{
+			bRes = false;
+		}
+	}
+
+	OPENSSL_cleanse( &sttState, sizeof(sttState) );
+
+	if( bRes == false )
+	{
+		Close();
+		return false;
+	}
+
+	m_eHandshake = E_AH_DONE;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  AEAD ˰ Ѵ.
+ * @returns  AEAD ˰ Ѵ.
+ */
+EAeadSuite CAeadCipher::GetSuite()
+{
+	return m_eSuite;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  hello ޽ Ű Ͽ ġϰ Ȯ ޽ Ѵ.
+ * @param hSocket	 TCP  ڵ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::RecvHello( Socket hSocket )
+{
+	uint8_t szSecret[AEAD_PUBLIC_KEY_SIZE], szKeyBlock[AEAD_KEY_BLOCK_SIZE];
+	char szFinished[AEAD_HEADER_SIZE+AEAD_TAG_SIZE];
+	uint8_t * pszMyHello = m_szTranscript + ( m_bServer ? AEAD_HELLO_SIZE : 0 );
+	uint8_t * pszPeerHello = m_szTranscript + ( m_bServer ? 0 : AEAD_HELLO_SIZE );
+	uint8_t * pszSendKey = szKeyBlock + ( m_bServer ? AEAD_KEY_SIZE + AEAD_IV_SIZE : 0 );
+	uint8_t * pszRecvKey = szKeyBlock + ( m_bServer ? 0 : AEAD_KEY_SIZE + AEAD_IV_SIZE );
+	EVP_PKEY * psttPeerKey = NULL;
+	EVP_PKEY_CTX * psttCtx = NULL;
+	size_t iLen;
+	bool bRes = false;
+
+	if( pszPeerHello[0] != AEAD_VERSION ) return false;
+
+	psttPeerKey = EVP_PKEY_new_raw_public_key( EVP_PKEY_X25519, NULL, pszPeerHello + 4, AEAD_PUBLIC_KEY_SIZE );
+	if( psttPeerKey == NULL ) goto FUNC_END;
+
+	psttCtx = EVP_PKEY_CTX_new( m_psttKey, NULL );
+	if( psttCtx == NULL ) goto FUNC_END;
+
+	iLen = sizeof(szSecret);
+	if( EVP_PKEY_derive_init( psttCtx ) <= 0 || EVP_PKEY_derive_set_peer( psttCtx, psttPeerKey ) <= 0 ||
+			EVP_PKEY_derive( psttCtx, szSecret, &iLen ) <= 0 ) goto FUNC_END;
+
+	if( pszMyHello[1] == E_AEAD_AES_256_GCM && pszPeerHello[1] == E_AEAD_AES_256_GCM )
+	{
+		m_eSuite = E_AEAD_AES_256_GCM;
+	}
+	else
+	{
+		m_eSuite = E_AEAD_CHACHA20_POLY1305;
+	}
+
+	if( DeriveKey( szSecret, (int)iLen, m_strPsk.c_str(), m_szTranscript, sizeof(m_szTranscript), szKeyBlock ) == false ) goto FUNC_END;
+
+	//   hello  Ű ġ ̸ ˻ϿǷ ġ ϴ  幰.
+	//  ڵ带  ʾǷ ġ ϸ user-space ȣȭ Ѵ.  kTLS  ϸ Ȯ ޽ ȯ Ѵ.
+	if( ( pszMyHello[2] & AEAD_FLAG_KTLS ) && ( pszPeerHello[2] & AEAD_FLAG_KTLS ) && KtlsInstall( hSocket, pszSendKey, pszRecvKey ) )
+	{
+		m_bKtls = true;
+
+		memcpy( szFinished, AEAD_FINISHED, AEAD_FINISHED_SIZE );
+		if( TcpSend( hSocket, szFinished, AEAD_FINISHED_SIZE ) != AEAD_FINISHED_SIZE ) goto FUNC_END;
+	}
+	else
+	{
+		if( SetKey( pszSendKey, pszRecvKey ) == false ) goto FUNC_END;
+
+		//   ȯϿ  Ű ġϴ ȮѴ.
+		if( Seal( szFinished, 0 ) != AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) goto FUNC_END;
+		if( TcpSend( hSocket, szFinished, AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) != AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) goto FUNC_END;
+	}
+
+	bRes = true;
+
+FUNC_END:
+	OPENSSL_cleanse( szSecret, sizeof(szSecret) );
+	OPENSSL_cleanse( szKeyBlock, sizeof(szKeyBlock) );
+	if( psttCtx ) EVP_PKEY_CTX_free( psttCtx );
+	if( psttPeerKey ) EVP_PKEY_free( psttPeerKey );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief X25519  а HKDF-SHA256  Ͽ ⺰ Ű/IV  Ѵ.
+ * @param pszSecret				X25519  а
+ * @param iSecretLen			pszSecret 
+ * @param pszPsk					  Ű
+ * @param pszTranscript		Ŭ̾Ʈ hello +  hello
+ * @param iTranscriptLen	pszTranscript 
+ * @param pszKeyBlock			Ŭ̾Ʈ key/IV +  key/IV   
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::DeriveKey( const uint8_t * pszSecret, int iSecretLen, const char * pszPsk, const uint8_t * pszTranscript, int iTranscriptLen, uint8_t * pszKeyBlock )
+{
+	static const char * pszLabel = "telnet aead key";
+	EVP_PKEY_CTX * psttCtx;
+	size_t iLen = AEAD_KEY_BLOCK_SIZE;
+	bool bRes = false;
+
+	psttCtx = EVP_PKEY_CTX_new_id( EVP_PKEY_HKDF, NULL );
+	if( psttCtx == NULL ) return false;
+
+	if( EVP_PKEY_derive_init( psttCtx ) <= 0 ||
+			EVP_PKEY_CTX_set_hkdf_md( psttCtx, EVP_sha256() ) <= 0 ||
+			EVP_PKEY_CTX_set1_hkdf_key( psttCtx, pszSecret, iSecretLen ) <= 0 ||
+			EVP_PKEY_CTX_add1_hkdf_info( psttCtx, (const unsigned char *)pszLabel, (int)strlen(pszLabel) ) <= 0 ||
+			EVP_PKEY_CTX_add1_hkdf_info( psttCtx, pszTranscript, iTranscriptLen ) <= 0 )
+	{
+		goto FUNC_END;
+	}
+
+	if( EVP_PKEY_CTX_set1_hkdf_salt( psttCtx, (const unsigned char *)pszPsk, (int)strlen(pszPsk) ) <= 0 ) goto FUNC_END;
+
+	if( EVP_PKEY_derive( psttCtx, pszKeyBlock, &iLen ) <= 0 ) goto FUNC_END;
+
+	bRes = true;
+
+FUNC_END:
+	EVP_PKEY_CTX_free( psttCtx );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief user-space ȣȭ/ȣȭ  EVP context  Ѵ.
+ * @param pszSendKey	۽ key + IV
+ * @param pszRecvKey	 key + IV
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::SetKey( const uint8_t * pszSendKey, const uint8_t * pszRecvKey )
+{
+	const EVP_CIPHER * psttCipher = ( m_eSuite == E_AEAD_AES_256_GCM ) ? EVP_aes_256_gcm() : EVP_chacha20_poly1305();
+
+	m_psttSendCtx = EVP_CIPHER_CTX_new();
+	m_psttRecvCtx = EVP_CIPHER_CTX_new();
+	if( m_psttSendCtx == NULL || m_psttRecvCtx == NULL ) return false;
+
+	if( EVP_EncryptInit_ex( m_psttSendCtx, psttCipher, NULL, pszSendKey, NULL ) != 1 ) return false;
+	if( EVP_DecryptInit_ex( m_psttRecvCtx, psttCipher, NULL, pszRecvKey, NULL ) != 1 ) return false;
+
+	memcpy( m_szSendKey, pszSendKey, AEAD_KEY_SIZE );
+	memcpy( m_szRecvKey, pszRecvKey, AEAD_KEY_SIZE );
+	memcpy( m_szSendIv, pszSendKey + AEAD_KEY_SIZE, AEAD_IV_SIZE );
+	memcpy( m_szRecvIv, pszRecvKey + AEAD_KEY_SIZE, AEAD_IV_SIZE );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ͽ TLS ULP  Ͽ kTLS    ִ ˻Ѵ.
+ *	- Ű ġϱ  ULP  Ͽ  ״ ۵ȴ.
+ * @param hSocket	 TCP  ڵ
+ * @returns kTLS     true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::KtlsAttach( Socket hSocket )
+{
+#ifdef __linux__
+	if( setsockopt( hSocket, SOL_TCP, TCP_ULP, "tls", sizeof("tls") ) == 0 ) return true;
+#endif
+
+	return false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Ű Ͽ ġϿ Ŀο TLS 1.3 ڵ ȣȭ/ȣȭϵ Ѵ.
+ * @param hSocket			 TCP  ڵ
+ * @param pszSendKey	۽ key + IV
+ * @param pszRecvKey	 key + IV
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::KtlsInstall( Socket hSocket, const uint8_t * pszSendKey, const uint8_t * pszRecvKey )
+{
+#ifdef __linux__
+	for( int i = 0; i < 2; ++i )
+	{
+		const uint8_t * pszKey = ( i == 0 ) ? pszSendKey : pszRecvKey;
+		int iType = ( i == 0 ) ? TLS_TX : TLS_RX;
+		int n;
+
+		if( m_eSuite == E_AEAD_AES_256_GCM )
+		{
+			struct tls12_crypto_info_aes_gcm_256 sttInfo;
+
+			memset( &sttInfo, 0, sizeof(sttInfo) );
+			sttInfo.info.version = TLS_1_3_VERSION;
+			sttInfo.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+			memcpy( sttInfo.key, pszKey, AEAD_KEY_SIZE );
+			memcpy( sttInfo.salt, pszKey + AEAD_KEY_SIZE, TLS_CIPHER_AES_GCM_256_SALT_SIZE );
+			memcpy( sttInfo.iv, pszKey + AEAD_KEY_SIZE + TLS_CIPHER_AES_GCM_256_SALT_SIZE, TLS_CIPHER_AES_GCM_256_IV_SIZE );
+
+			n = setsockopt( hSocket, SOL_TLS, iType, &sttInfo, sizeof(sttInfo) );
+			OPENSSL_cleanse( &sttInfo, sizeof(sttInfo) );
+		}
+		else
+		{
+			struct tls12_crypto_info_chacha20_poly1305 sttInfo;
+
+			memset( &sttInfo, 0, sizeof(sttInfo) );
+			sttInfo.info.version = TLS_1_3_VERSION;
+			sttInfo.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+			memcpy( sttInfo.key, pszKey, AEAD_KEY_SIZE );
+			memcpy( sttInfo.iv, pszKey + AEAD_KEY_SIZE, TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE );
+
+			n = setsockopt( hSocket, SOL_TLS, iType, &sttInfo, sizeof(sttInfo) );
+			OPENSSL_cleanse( &sttInfo, sizeof(sttInfo) );
+		}
+
+		if( n != 0 ) return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+#ifdef __linux__
+static pthread_once_t gsttKtlsProbeOnce = PTHREAD_ONCE_INIT;
+static bool garrKtlsSuite[3] = { false, false, false };
+#endif
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ִ  ˰ Ű Ͽ ġ  ִ ˻Ѵ.
+ *	- ULP  ǰ TLS 1.3  Ǵ ˰  ʴ Ŀο hello  kTLS  ǥ ʴ´.
+ * @param iPreferSuite	hello ޽ ϴ ȣ ˰
+ * @returns Ű ġ   true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::KtlsAvailable( uint8_t iPreferSuite )
+{
+#ifdef __linux__
+	pthread_once( &gsttKtlsProbeOnce, KtlsProbe );
+
+	// AES-256-GCM  ȣϿ  ȣ  ChaCha20-Poly1305  Ѵ.
+	if( garrKtlsSuite[E_AEAD_CHACHA20_POLY1305] == false ) return false;
+	if( iPreferSuite == E_AEAD_AES_256_GCM && garrKtlsSuite[E_AEAD_AES_256_GCM] == false ) return false;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief μ   ˰򺰷 kTLS Ű ġ ˻Ѵ.
+ */
+void CAeadCipher::KtlsProbe()
+{
+#ifdef __linux__
+	garrKtlsSuite[E_AEAD_AES_256_GCM] = KtlsProbeSuite( E_AEAD_AES_256_GCM );
+	garrKtlsSuite[E_AEAD_CHACHA20_POLY1305] = KtlsProbeSuite( E_AEAD_CHACHA20_POLY1305 );
+#endif
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief loopback TCP ῡ ӽ Ű ġϿ kTLS ۽/    ִ ˻Ѵ.
+ * @param eSuite	AEAD ˰
+ * @returns Ű ġ   true  ϰ ׷  false  Ѵ.
+ */
+bool CAeadCipher::KtlsProbeSuite( EAeadSuite eSuite )
+{
+	bool bRes = false;
+
+#ifdef __linux__
+	CAeadCipher clsCipher;
+	uint8_t szKey[AEAD_KEY_SIZE+AEAD_IV_SIZE];
+	struct sockaddr_in sttAddr;
+	socklen_t iAddrLen = sizeof(sttAddr);
+	Socket hListen, hConnect = INVALID_SOCKET, hAccept = INVALID_SOCKET;
+
+	hListen = TcpListen( 0, 1, "127.0.0.1" );
+	if( hListen == INVALID_SOCKET ) return false;
+
+	if( getsockname( hListen, (struct sockaddr *)&sttAddr, &iAddrLen ) == 0 )
+	{
+		hConnect = TcpConnect( "127.0.0.1", ntohs( sttAddr.sin_port ), 1 );
+		if( hConnect != INVALID_SOCKET ) hAccept = accept( hListen, NULL, NULL );
+	}
+
+	if( hAccept != INVALID_SOCKET )
+	{
+		memset( szKey, 0, sizeof(szKey) );
+		clsCipher.m_eSuite = eSuite;
+		bRes = clsCipher.KtlsAttach( hConnect ) && clsCipher.KtlsInstall( hConnect, szKey, szKey );
+		closesocket( hAccept );
+	}
+
+	if( hConnect != INVALID_SOCKET ) closesocket( hConnect );
+	closesocket( hListen );
+#endif
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief IV  sequence ȣ XOR Ͽ nonce  Ѵ.
+ * @param pszIv			IV
+ * @param iSeq			sequence ȣ
+ * @param pszNonce	nonce  
+ */
+void CAeadCipher::MakeNonce( const uint8_t * pszIv, uint64_t iSeq, uint8_t * pszNonce )
+{
+	memcpy( pszNonce, pszIv, AEAD_IV_SIZE );
+
+	for( int i = 0; i < 8; ++i )
+	{
+		pszNonce[AEAD_IV_SIZE-1-i] ^= (uint8_t)( iSeq >> ( i * 8 ) );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ȣȭϿ Ѵ.
+ * @param fd				 ڵ
+ * @param clsCipher	Ű ȯ Ϸ ȣȭ ü
+ * @param pszFrame	 . CAeadCipher::Seal ޼ҵ  ϶.
+ * @param iPlainLen	 
+ * @returns ϸ iPlainLen  ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int TcpSendAead( Socket fd, CAeadCipher & clsCipher, char * pszFrame, int iPlainLen )
+{
+	if( clsCipher.IsKtls() )
+	{
+		return TcpSend( fd, pszFrame + AEAD_HEADER_SIZE, iPlainLen );
+	}
+
+	int iFrameLen = clsCipher.Seal( pszFrame, iPlainLen );
+	if( iFrameLen == -1 ) return SOCKET_ERROR;
+
+	if( TcpSend( fd, pszFrame, iFrameLen ) == SOCKET_ERROR ) return SOCKET_ERROR;
+
+	return iPlainLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ϳ  Ͽ ȣȭѴ.
+ *	- kTLS  ϴ 쿡 Ŀο ȣȭ  Ѵ.
+ * @param fd					 ڵ
+ * @param clsCipher		Ű ȯ Ϸ ȣȭ ü
+ * @param pszFrame		 . ȣȭ  pszFrame + AEAD_HEADER_SIZE ġ ȴ.
+ * @param iFrameSize	  ũ
+ * @param iSecond			 timeout (   )
+ * @returns ϸ  ̸ ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int TcpRecvAead( Socket fd, CAeadCipher & clsCipher, char * pszFrame, int iFrameSize, int iSecond )
+{
+	const uint8_t * pszHeader = (const uint8_t *)pszFrame;
+	uint32_t iBodyLen;
+
+	if( iFrameSize < AEAD_HEADER_SIZE + AEAD_TAG_SIZE ) return SOCKET_ERROR;
+
+	if( clsCipher.IsKtls() )
+	{
+		int n = TcpRecv( fd, pszFrame + AEAD_HEADER_SIZE, iFrameSize - AEAD_HEADER_SIZE - AEAD_TAG_SIZE, iSecond );
+		if( n <= 0 ) return SOCKET_ERROR;
+
+		return n;
+	}
+	if( TcpRecvSize( fd, pszFrame, AEAD_HEADER_SIZE, iSecond ) == SOCKET_ERROR ) return SOCKET_ERROR;
+
+	iBodyLen = ( (uint32_t)pszHeader[0] << 24 ) | ( (uint32_t)pszHeader[1] << 16 ) | ( (uint32_t)pszHeader[2] << 8 ) | pszHeader[3];
+	if( iBodyLen < AEAD_TAG_SIZE || iBodyLen > (uint32_t)( iFrameSize - AEAD_HEADER_SIZE ) ) return SOCKET_ERROR;
+
+	if( TcpRecvSize( fd, pszFrame + AEAD_HEADER_SIZE, iBodyLen, iSecond ) == SOCKET_ERROR ) return SOCKET_ERROR;
+
+	int iPlainLen = clsCipher.Open( pszFrame, AEAD_HEADER_SIZE + iBodyLen );
+	if( iPlainLen == -1 ) return SOCKET_ERROR;
+
+	return iPlainLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ȣȭϿ Ѵ.
+ *	- kTLS  ϴ 쿡 Ŀο ȣȭϹǷ sendfile()  zero-copy Ѵ.
+ *	- ׷     о user-space  ȣȭ , Ѵ.
+ * @param fd				 ڵ
+ * @param clsCipher	Ű ȯ Ϸ ȣȭ ü
+ * @param iFileFd		  descriptor
+ * @param iOffset		   ġ
+ * @param iSize			 ũ
+ * @returns ϸ  ũ⸦ ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int64_t TcpSendFileAead( Socket fd, CAeadCipher & clsCipher, int iFileFd, int64_t iOffset, int64_t iSize )
+{
+	int64_t iSendLen = 0;
+	int n;
+
+#ifdef __linux__
+	if( clsCipher.IsKtls() )
+	{
+		off_t iPos = (off_t)iOffset;
+
+		while( iSendLen < iSize )
+		{
+			ssize_t iWrite = sendfile( fd, iFileFd, &iPos, (size_t)( iSize - iSendLen ) );
+			if( iWrite <= 0 ) return SOCKET_ERROR;
+
+			iSendLen += iWrite;
+		}
+
+		return iSendLen;
+	}
+#endif
+
+	char * pszFrame = (char *)malloc( AEAD_MAX_FRAME_SIZE );
+	if( pszFrame == NULL ) return SOCKET_ERROR;
+
+	while( iSendLen < iSize )
+	{
+		n = AEAD_MAX_PLAIN_SIZE;
+		if( iSize - iSendLen < n ) n = (int)( iSize - iSendLen );
+
+		n = (int)pread( iFileFd, pszFrame + AEAD_HEADER_SIZE, n, (off_t)( iOffset + iSendLen ) );
+		if( n <= 0 || TcpSendAead( fd, clsCipher, pszFrame, n ) == SOCKET_ERROR )
+		{
+			free( pszFrame );
+			return SOCKET_ERROR;
+		}
+
+		iSendLen += n;
+	}
+
+	free( pszFrame );
+
+	return iSendLen;
+}
+
+#endif
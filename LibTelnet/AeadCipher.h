@@ -0,0 +1,167 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _AEAD_CIPHER_H_
+#define _AEAD_CIPHER_H_
+
+#include "Define.h"
+#include "Tcp.h"
+
+#ifdef USE_TLS
+
+#include <openssl/evp.h>
+
+#define AEAD_KEY_SIZE					32
+#define AEAD_IV_SIZE					12
+#define AEAD_TAG_SIZE					16
+#define AEAD_PUBLIC_KEY_SIZE	32
+
+// hello ޽ ũ : version(1) + ȣ ˰(1) + flag(1) + (1) + X25519 Ű
+#define AEAD_HELLO_SIZE				( 4 + AEAD_PUBLIC_KEY_SIZE )
+
+//   Ű ּ . Ű ȯ ߰ϴ ڰ PSK   ϵ   Ѵ.
+#define AEAD_MIN_PSK_SIZE			16
+
+// ȣȭ   ( 4 byte   ) ũ
+#define AEAD_HEADER_SIZE			4
+
+// ϳ ӿ   ִ ִ  ũ
+#define AEAD_MAX_PLAIN_SIZE		16384
+
+//    ּ ũ
+#define AEAD_MAX_FRAME_SIZE		( AEAD_HEADER_SIZE + AEAD_MAX_PLAIN_SIZE + AEAD_TAG_SIZE )
+
+/**
+ * @ingroup LibTelnet
+ * @brief AEAD ȣȭ ˰
+ */
+enum EAeadSuite
+{
+	E_AEAD_NULL = 0,
+	E_AEAD_AES_256_GCM,
+	E_AEAD_CHACHA20_POLY1305
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ű ȯ  
+ */
+enum EAeadHandshake
+{
+	E_AH_NULL = 0,
+
+	/** hello ޽ ϰ  hello ޽ ٸ. */
+	E_AH_HELLO,
+
+	/** Ű ġϰ  Ȯ ޽ ٸ. */
+	E_AH_FINISHED,
+
+	E_AH_DONE
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ۽ X25519 Ű ȯ ϰ   AEAD ȣȭ/ȣȭ ϴ Ŭ
+ *	-  CPU   AES-NI/PCLMUL  ϸ AES-256-GCM  ϰ ׷  ChaCha20-Poly1305  Ѵ.
+ *	-   : [ 4 byte ȣ  ][ ȣ ][ 16 byte tag ]
+ *	-   kTLS  ϸ Ű Ͽ ġϰ   Ŀ ϴ TLS 1.3 ڵ Ѵ.
+ *	-   Ű HKDF salt  ϹǷ  PSK    Ű ȯ Ѵ.
+ *	- ̺Ʈ  HandshakeStart  ȣ Ŀ  б   HandshakeRecv  ȣѴ.
+ *	-  ׷̵ Export  ¸ ο μ Import ϸ Ű ȯ  ȣȭ Ѵ.
+ */
+class CAeadCipher
+{
+public:
+	CAeadCipher();
+	~CAeadCipher();
+
+	bool Handshake( Socket hSocket, bool bServer, int iSecond, const char * pszPsk );
+	bool HandshakeStart( Socket hSocket, bool bServer, const char * pszPsk );
+	int HandshakeRecv( Socket hSocket );
+	void Close();
+
+	int Seal( char * pszFrame, int iPlainLen );
+	int Open( char * pszFrame, int iFrameLen );
+
+	bool IsOpen();
+	bool IsKtls();
+	EAeadSuite GetSuite();
+
+	void SetUseKtls( bool bUseKtls );
+	void SetSuite( EAeadSuite eSuite );
+
+	bool Export( std::string & strState );
+	bool Import( const char * pszState, int iStateLen );
+
+private:
+	bool RecvHello( Socket hSocket );
+	bool DeriveKey( const uint8_t * pszSecret, int iSecretLen, const char * pszPsk, const uint8_t * pszTranscript, int iTranscriptLen, uint8_t * pszKeyBlock );
+	bool SetKey( const uint8_t * pszSendKey, const uint8_t * pszRecvKey );
+	bool KtlsAttach( Socket hSocket );
+	bool KtlsInstall( Socket hSocket, const uint8_t * pszSendKey, const uint8_t * pszRecvKey );
+	bool KtlsAvailable( uint8_t iPreferSuite );
+
+	static void KtlsProbe();
+	static bool KtlsProbeSuite( EAeadSuite eSuite );
+	void MakeNonce( const uint8_t * pszIv, uint64_t iSeq, uint8_t * pszNonce );
+
+	EAeadSuite	m_eSuite;
+
+	/** hello ޽ ϴ ȣ ˰. E_AEAD_NULL ̸ CPU  Ѵ. */
+	EAeadSuite	m_ePreferSuite;
+
+	bool	m_bUseKtls;
+	bool	m_bKtls;
+
+	EVP_CIPHER_CTX * m_psttSendCtx;
+	EVP_CIPHER_CTX * m_psttRecvCtx;
+
+	/**  ׷̵ ο μ ϴ user-space ȣȭ Ű */
+	uint8_t	m_szSendKey[AEAD_KEY_SIZE];
+	uint8_t	m_szRecvKey[AEAD_KEY_SIZE];
+
+	uint8_t	m_szSendIv[AEAD_IV_SIZE];
+	uint8_t	m_szRecvIv[AEAD_IV_SIZE];
+
+	uint64_t	m_iSendSeq;
+	uint64_t	m_iRecvSeq;
+
+	/** Ű ȯ ߿ ϴ  */
+	EAeadHandshake	m_eHandshake;
+	bool	m_bServer;
+	std::string	m_strPsk;
+	EVP_PKEY * m_psttKey;
+
+	/** Ŭ̾Ʈ hello +  hello */
+	uint8_t	m_szTranscript[AEAD_HELLO_SIZE*2];
+
+	/**    Ȯ ޽ */
+	char	m_szFinished[AEAD_HEADER_SIZE+AEAD_TAG_SIZE];
+	int		m_iRecvLen;
+};
+
+bool CpuSupportAesNi();
+bool LoadPsk( const char * pszFileName, std::string & strPsk );
+
+int TcpSendAead( Socket fd, CAeadCipher & clsCipher, char * pszFrame, int iPlainLen );
+int TcpRecvAead( Socket fd, CAeadCipher & clsCipher, char * pszFrame, int iFrameSize, int iSecond );
+int64_t TcpSendFileAead( Socket fd, CAeadCipher & clsCipher, int iFileFd, int64_t iOffset, int64_t iSize );
+
+#endif
+
+#endif
@@ -0,0 +1,600 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "Cgroup.h"
+
+#ifndef WIN32
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "Log.h"
+#include "MemoryDebug.h"
+
+/**
+ * @ingroup LibTelnet
+ * @brief monotonic ð milli second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicMs()
+{
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000 + sttTime.tv_nsec / 1000000;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup Ͽ  Ѵ.
+ * @param strFileName	cgroup  
+ * @param pszValue		 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool WriteFile( const std::string & strFileName, const char * pszValue )
+{
+	int fd = open( strFileName.c_str(), O_WRONLY | O_CLOEXEC );
+	if( fd == -1 ) return false;
+
+	int iLen = (int)strlen( pszValue );
+	bool bRes = ( write( fd, pszValue, iLen ) == iLen );
+
+	close( fd );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   д´.
+ * @param strFileName	 
+ * @param strText			   
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool ReadFile( const std::string & strFileName, std::string & strText )
+{
+	char szBuf[4096];
+	int n;
+
+	strText.clear();
+
+	int fd = open( strFileName.c_str(), O_RDONLY | O_CLOEXEC );
+	if( fd == -1 ) return false;
+
+	while( ( n = read( fd, szBuf, sizeof(szBuf) ) ) > 0 )
+	{
+		strText.append( szBuf, n );
+	}
+
+	close( fd );
+
+	return ( n == 0 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief "key value"   cgroup  Ͽ key   ´.
+ * @param strText	cgroup   
+ * @param pszName	key
+ * @returns key  ϸ  ϰ ׷  0  Ѵ.
+ */
+static uint64_t GetStatValue( const std::string & strText, const char * pszName )
+{
+	size_t iNameLen = strlen( pszName );
+	size_t iPos = 0;
+
+	while( iPos < strText.length() )
+	{
+		if( !strncmp( strText.c_str() + iPos, pszName, iNameLen ) && strText[iPos+iNameLen] == ' ' )
+		{
+			return strtoull( strText.c_str() + iPos + iNameLen + 1, NULL, 10 );
+		}
+
+		iPos = strText.find( '\n', iPos );
+		if( iPos == std::string::npos ) break;
+		++iPos;
+	}
+
+	return 0;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup 丮 Ѵ. ̹ ϸ  óѴ.
+ * @param strPath cgroup 丮 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool MakeDir( const std::string & strPath )
+{
+	if( mkdir( strPath.c_str(), 0755 ) == -1 && errno != EEXIST ) return false;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CCgroupStat::CCgroupStat() : m_iCpuUsec(0), m_iThrottledCount(0), m_iThrottledUsec(0), m_iMemory(0), m_iMemoryPeak(0), m_iOomKill(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CCgroup::CCgroup() : m_iMemoryMax(0), m_bOpen(false)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  μ relay cgroup  ̵ϰ  cgroup  θ cgroup  Ѵ.
+ *	 μ  thread  relay cgroup  ̵ϹǷ reactor thread  Open Ŀ Ͽ ȴ.
+ * @param pszCpuMax		 cgroup  cpu.max . NULL ̰ų  ڿ̸  ʴ´.
+ * @param iMemoryMax	 cgroup  memory.max  ( byte  ). 0 ̸  ʴ´.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::Open( const char * pszCpuMax, int64_t iMemoryMax )
+{
+	std::string strRelay, strSession;
+	char szValue[21];
+
+	Close();
+
+	if( GetPath( m_strPath ) == false ) return false;
+
+	strRelay = m_strPath + "/" CGROUP_RELAY_NAME;
+	strSession = m_strPath + "/" CGROUP_SESSION_NAME;
+
+	if( MakeDir( strRelay ) == false ) return false;
+
+	// μ ϴ cgroup   cgroup  controller  Ȱȭ  Ƿ  μ relay cgroup  ̵Ѵ.
+	snprintf( szValue, sizeof(szValue), "%d", getpid() );
+	if( WriteFile( strRelay + "/cgroup.procs", szValue ) == false ) return false;
+
+	if( WriteFile( m_strPath + "/cgroup.subtree_control", "+cpu +memory" ) == false ) return false;
+	if( MakeDir( strSession ) == false ) return false;
+	if( WriteFile( strSession + "/cgroup.subtree_control", "+cpu +memory" ) == false ) return false;
+
+	snprintf( szValue, sizeof(szValue), "%d", CGROUP_RELAY_CPU_WEIGHT );
+	if( WriteFile( strRelay + "/cpu.weight", szValue ) == false ) return false;
+
+	snprintf( szValue, sizeof(szValue), "%d", CGROUP_SESSION_CPU_WEIGHT );
+	if( WriteFile( strSession + "/cpu.weight", szValue ) == false ) return false;
+
+	snprintf( szValue, sizeof(szValue), "%d", CGROUP_RELAY_MEMORY_MIN );
+	if( WriteFile( strRelay + "/memory.min", szValue ) == false ) return false;
+
+	// ׷̵  μ    cgroup  Ѵ. μ  ִ cgroup   ʴ´.
+	DIR * psttDir = opendir( strSession.c_str() );
+	if( psttDir )
+	{
+		struct dirent * psttEntry;
+
+		while( ( psttEntry = readdir( psttDir ) ) != NULL )
+		{
+			if( psttEntry->d_name[0] < '0' || psttEntry->d_name[0] > '9' ) continue;
+
+			rmdir( ( strSession + "/" + psttEntry->d_name ).c_str() );
+		}
+
+		closedir( psttDir );
+	}
+
+	if( pszCpuMax ) m_strCpuMax = pszCpuMax;
+	m_iMemoryMax = iMemoryMax;
+	m_bOpen = true;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ʱȭѴ.  ׷̵ Ŀ  ǵ  cgroup   ʴ´.
+ */
+void CCgroup::Close()
+{
+	CGROUP_REMOVE_LIST::iterator itList;
+
+	for( itList = m_clsRemoveList.begin(); itList != m_clsRemoveList.end(); ++itList )
+	{
+		close( itList->m_iEventFd );
+	}
+
+	m_strPath.clear();
+	m_strCpuMax.clear();
+	m_iMemoryMax = 0;
+	m_clsSessionMap.clear();
+	m_clsPidMap.clear();
+	m_clsRemoveList.clear();
+	m_bOpen = false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Open  Ͽ ˻Ѵ.
+ * @returns Open  Ͽ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::IsOpen()
+{
+	return m_bOpen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  cgroup  ϰ  μ ̵Ѵ.
+ *	 μ exec ϱ  ȣϿ  μ Ŀ ϴ  ڽ μ  cgroup  Եȴ.
+ *	 ׷̵ Ŀ ̹  cgroup  Ե  μ ٽ ϱ Ͽ ȣѴ.
+ * @param iSessionId	 ̵
+ * @param iPid				 μ ̵
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::AddSession( int iSessionId, int iPid )
+{
+	std::string strGroup;
+	char szValue[21];
+
+	if( m_bOpen == false ) return false;
+
+	GetSessionGroup( iSessionId, strGroup );
+
+	if( MakeDir( strGroup ) == false ) return false;
+
+	if( m_strCpuMax.empty() == false && WriteFile( strGroup + "/cpu.max", m_strCpuMax.c_str() ) == false ) goto FUNC_ERROR;
+
+	if( m_iMemoryMax > 0 )
+	{
+		snprintf( szValue, sizeof(szValue), LONG_LONG_FORMAT, m_iMemoryMax );
+		if( WriteFile( strGroup + "/memory.max", szValue ) == false ) goto FUNC_ERROR;
+	}
+
+	snprintf( szValue, sizeof(szValue), "%d", iPid );
+	if( WriteFile( strGroup + "/cgroup.procs", szValue ) == false ) goto FUNC_ERROR;
+
+	m_clsSessionMap[iSessionId] = iPid;
+	m_clsPidMap[iPid] = iSessionId;
+
+	return true;
+
+FUNC_ERROR:
+	rmdir( strGroup.c_str() );
+	return false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  cgroup   ִ μ ϰ  cgroup  Ѵ.
+ *	 μ waitpid  ȸ Ŀ ȣѴ. μ   ٸ ʰ   Ͽ ߰ϸ
+ *	̺Ʈ  Process  μ   Ŀ Ѵ.
+ * @param iSessionId  ̵
+ * @returns Ͽų   Ͽ ߰Ͽ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::RemoveSession( int iSessionId )
+{
+	std::map< int, int >::iterator itMap;
+	std::string strGroup;
+
+	if( m_bOpen == false ) return false;
+
+	itMap = m_clsSessionMap.find( iSessionId );
+	if( itMap != m_clsSessionMap.end() )
+	{
+		m_clsPidMap.erase( itMap->second );
+		m_clsSessionMap.erase( itMap );
+	}
+
+	GetSessionGroup( iSessionId, strGroup );
+
+	// cgroup.events    cgroup.kill  populated  ̺Ʈ ġ ʴ´.
+	int iEventFd = open( ( strGroup + "/cgroup.events" ).c_str(), O_RDONLY | O_CLOEXEC );
+	if( iEventFd == -1 ) return ( errno == ENOENT );
+
+	//  shell  background   μ   cgroup    .
+	WriteFile( strGroup + "/cgroup.kill", "1" );
+
+	if( rmdir( strGroup.c_str() ) == 0 || errno == ENOENT )
+	{
+		close( iEventFd );
+		return true;
+	}
+
+	if( errno != EBUSY )
+	{
+		close( iEventFd );
+		return false;
+	}
+
+	CCgroupRemove clsRemove;
+
+	clsRemove.m_iSessionId = iSessionId;
+	clsRemove.m_iEventFd = iEventFd;
+	clsRemove.m_iDeadline = GetMonotonicMs() + CGROUP_REMOVE_SECOND * 1000;
+	clsRemove.m_iPollIndex = -1;
+
+	m_clsRemoveList.push_back( clsRemove );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  μ ̵  ̵ ´.
+ * @param iPid  μ ̵
+ * @returns  cgroup  ϵ μ̸  ̵ ϰ ׷  -1  Ѵ.
+ */
+int CCgroup::GetSessionId( int iPid )
+{
+	std::map< int, int >::iterator itMap = m_clsPidMap.find( iPid );
+	if( itMap == m_clsPidMap.end() ) return -1;
+
+	return itMap->second;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ٸ  cgroup  cgroup.events  poll Ͽ ߰Ѵ.
+ * @param clsPollList poll 
+ */
+void CCgroup::SetPoll( std::vector< pollfd > & clsPollList )
+{
+	CGROUP_REMOVE_LIST::iterator itList;
+	pollfd sttPoll;
+
+	for( itList = m_clsRemoveList.begin(); itList != m_clsRemoveList.end(); ++itList )
+	{
+		sttPoll.fd = itList->m_iEventFd;
+		sttPoll.events = POLLPRI;
+		sttPoll.revents = 0;
+
+		itList->m_iPollIndex = (int)clsPollList.size();
+		clsPollList.push_back( sttPoll );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup.events  Ǿų  ð ʰ  cgroup  Ѵ.
+ * @param clsPollList poll 
+ */
+void CCgroup::Process( std::vector< pollfd > & clsPollList )
+{
+	CGROUP_REMOVE_LIST::iterator itList, itNext;
+	std::string strGroup;
+	uint64_t iNow = GetMonotonicMs();
+
+	for( itList = m_clsRemoveList.begin(); itList != m_clsRemoveList.end(); itList = itNext )
+	{
+		itNext = itList;
+		++itNext;
+
+		bool bEvent = ( itList->m_iPollIndex >= 0 && itList->m_iPollIndex < (int)clsPollList.size() && clsPollList[itList->m_iPollIndex].revents );
+
+		if( bEvent == false && iNow < itList->m_iDeadline ) continue;
+
+		if( bEvent )
+		{
+			//  ٽ о   ̺Ʈ POLLPRI  ߻ ʴ´.
+			char szBuf[256];
+
+			if( lseek( itList->m_iEventFd, 0, SEEK_SET ) == -1 || read( itList->m_iEventFd, szBuf, sizeof(szBuf) ) == -1 )
+			{
+				//  rmdir   ȮѴ.
+			}
+		}
+
+		GetSessionGroup( itList->m_iSessionId, strGroup );
+
+		if( rmdir( strGroup.c_str() ) == -1 && errno == EBUSY && iNow < itList->m_iDeadline ) continue;
+
+		if( iNow >= itList->m_iDeadline && access( strGroup.c_str(), 0 ) == 0 )
+		{
+			CLog::Print( LOG_ERROR, "%s session(%d) cgroup is not removed - processes are still running", __FUNCTION__, itList->m_iSessionId );
+		}
+
+		close( itList->m_iEventFd );
+		m_clsRemoveList.erase( itList );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ð   ʰǴ  cgroup   ð ´.
+ * @returns  ٸ  cgroup    ð ( milli second )  ϰ  -1  Ѵ.
+ */
+int CCgroup::GetTimeout()
+{
+	CGROUP_REMOVE_LIST::iterator itList;
+	uint64_t iNow = GetMonotonicMs();
+	int iTimeout = -1;
+
+	for( itList = m_clsRemoveList.begin(); itList != m_clsRemoveList.end(); ++itList )
+	{
+		int n = ( itList->m_iDeadline > iNow ) ? (int)( itList->m_iDeadline - iNow ) : 0;
+
+		if( iTimeout == -1 || n < iTimeout ) iTimeout = n;
+	}
+
+	return iTimeout;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief relay cgroup  ڿ 뷮 ´.
+ * @param clsStat ڿ 뷮  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::GetRelayStat( CCgroupStat & clsStat )
+{
+	if( m_bOpen == false ) return false;
+
+	return GetStat( m_strPath + "/" CGROUP_RELAY_NAME, clsStat );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  cgroup  ڿ 뷮 ´.
+ * @param iSessionId	 ̵
+ * @param clsStat			ڿ 뷮  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::GetSessionStat( int iSessionId, CCgroupStat & clsStat )
+{
+	std::string strGroup;
+
+	if( m_bOpen == false ) return false;
+
+	GetSessionGroup( iSessionId, strGroup );
+
+	return GetStat( strGroup, clsStat );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup  Ե   ڿ 뷮 ´.
+ * @param clsMap  ̵ ڿ 뷮  
+ */
+void CCgroup::GetSessionStatMap( CGROUP_STAT_MAP & clsMap )
+{
+	std::map< int, int >::iterator itMap;
+	CCgroupStat clsStat;
+
+	clsMap.clear();
+
+	for( itMap = m_clsSessionMap.begin(); itMap != m_clsSessionMap.end(); ++itMap )
+	{
+		if( GetSessionStat( itMap->first, clsStat ) )
+		{
+			clsMap.insert( CGROUP_STAT_MAP::value_type( itMap->first, clsStat ) );
+		}
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup v2 mount ο /proc/self/cgroup   μ  cgroup θ ´.
+ *	 ׷̵ Ŀ ̹ relay cgroup   Ƿ relay cgroup  θ θ ´.
+ * @param strPath cgroup θ  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::GetPath( std::string & strPath )
+{
+	std::string strText, strMount, strGroup;
+	size_t iPos = 0, iEnd;
+
+	// mountinfo  : {mount id} {parent id} {major:minor} {root} {mount point} {options} ... - {fs type} ...
+	if( ReadFile( "/proc/self/mountinfo", strText ) == false ) return false;
+
+	while( ( iEnd = strText.find( '\n', iPos ) ) != std::string::npos )
+	{
+		std::string strLine = strText.substr( iPos, iEnd - iPos );
+		iPos = iEnd + 1;
+
+		if( strLine.find( " - cgroup2 " ) == std::string::npos ) continue;
+
+		size_t iStart = 0;
+		for( int i = 0; i < 4 && iStart != std::string::npos; ++i )
+		{
+			iStart = strLine.find( ' ', iStart );
+			if( iStart != std::string::npos ) ++iStart;
+		}
+
+		if( iStart == std::string::npos ) continue;
+
+		strMount = strLine.substr( iStart, strLine.find( ' ', iStart ) - iStart );
+		break;
+	}
+
+	if( strMount.empty() ) return false;
+
+	// cgroup v2  "0::{}"  ǥõȴ.
+	if( ReadFile( "/proc/self/cgroup", strText ) == false ) return false;
+
+	iPos = strText.find( "0::" );
+	if( iPos == std::string::npos || ( iPos > 0 && strText[iPos-1] != '\n' ) ) return false;
+
+	iEnd = strText.find( '\n', iPos );
+	strGroup = strText.substr( iPos + 3, iEnd == std::string::npos ? std::string::npos : iEnd - iPos - 3 );
+
+	const char * pszRelay = "/" CGROUP_RELAY_NAME;
+	size_t iRelayLen = strlen( pszRelay );
+
+	if( strGroup.length() >= iRelayLen && !strcmp( strGroup.c_str() + strGroup.length() - iRelayLen, pszRelay ) )
+	{
+		strGroup.erase( strGroup.length() - iRelayLen );
+	}
+
+	if( strGroup == "/" ) strGroup.clear();
+
+	strPath = strMount + strGroup;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup  Ͽ ڿ 뷮 ´.
+ * @param strGroup	cgroup 
+ * @param clsStat		ڿ 뷮  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCgroup::GetStat( const std::string & strGroup, CCgroupStat & clsStat )
+{
+	std::string strText;
+
+	if( ReadFile( strGroup + "/cpu.stat", strText ) == false ) return false;
+
+	clsStat.m_iCpuUsec = GetStatValue( strText, "usage_usec" );
+	clsStat.m_iThrottledCount = GetStatValue( strText, "nr_throttled" );
+	clsStat.m_iThrottledUsec = GetStatValue( strText, "throttled_usec" );
+
+	clsStat.m_iMemory = 0;
+	clsStat.m_iMemoryPeak = 0;
+	clsStat.m_iOomKill = 0;
+
+	if( ReadFile( strGroup + "/memory.current", strText ) ) clsStat.m_iMemory = strtoull( strText.c_str(), NULL, 10 );
+
+	// memory.peak  linux 5.19 Ŀ Ѵ.
+	if( ReadFile( strGroup + "/memory.peak", strText ) ) clsStat.m_iMemoryPeak = strtoull( strText.c_str(), NULL, 10 );
+	if( ReadFile( strGroup + "/memory.events", strText ) ) clsStat.m_iOomKill = GetStatValue( strText, "oom_kill" );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  cgroup θ ´.
+ * @param iSessionId	 ̵
+ * @param strGroup		 cgroup θ  
+ */
+void CCgroup::GetSessionGroup( int iSessionId, std::string & strGroup )
+{
+	char szName[21];
+
+	snprintf( szName, sizeof(szName), "/%d", iSessionId );
+
+	strGroup = m_strPath + "/" CGROUP_SESSION_NAME;
+	strGroup.append( szName );
+}
+
+#endif
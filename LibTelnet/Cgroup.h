@@ -0,0 +1,152 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _CGROUP_H_
+#define _CGROUP_H_
+
+#include "Define.h"
+
+#ifndef WIN32
+
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+#include "Tcp.h"
+
+// relay/reactor thread  Ǵ cgroup   cgroup  θ cgroup ̸
+#define CGROUP_RELAY_NAME				"relay"
+#define CGROUP_SESSION_NAME			"session"
+
+// CPU ս relay cgroup   cgroup  켱ϵ cpu.weight  Ѵ.
+#define CGROUP_RELAY_CPU_WEIGHT		10000
+#define CGROUP_SESSION_CPU_WEIGHT	100
+
+// ޸ ÿ relay cgroup  ȸ ʴ ޸ ũ (memory.min)
+#define CGROUP_RELAY_MEMORY_MIN		( 64 * 1024 * 1024 )
+
+// cgroup.kill Ŀ μ     cgroup   ٸ ִ ð (   )
+#define CGROUP_REMOVE_SECOND			10
+
+/**
+ * @ingroup LibTelnet
+ * @brief cgroup ڿ 뷮
+ */
+class CCgroupStat
+{
+public:
+	CCgroupStat();
+
+	/** CPU  ð ( micro second  ) */
+	uint64_t	m_iCpuUsec;
+
+	/** cpu.max  Ͽ CPU  ѵ Ƚ  ð ( micro second  ) */
+	uint64_t	m_iThrottledCount;
+	uint64_t	m_iThrottledUsec;
+
+	/**  ޸ 뷮  ִ ޸ 뷮 */
+	uint64_t	m_iMemory;
+	uint64_t	m_iMemoryPeak;
+
+	/** memory.max  ʰϿ OOM killer   Ƚ */
+	uint64_t	m_iOomKill;
+};
+
+// key   ̵̴.
+typedef std::map< int, CCgroupStat > CGROUP_STAT_MAP;
+
+/**
+ * @ingroup LibTelnet
+ * @brief μ  Ǳ⸦ ٸ  cgroup
+ */
+class CCgroupRemove
+{
+public:
+	int	m_iSessionId;
+
+	/** cgroup.events file descriptor. populated  Ǹ POLLPRI ̺Ʈ ߻Ѵ. */
+	int	m_iEventFd;
+
+	/**  ð  ϸ  Ѵ. ( monotonic milli second ) */
+	uint64_t	m_iDeadline;
+
+	/** poll Ͽ ġ */
+	int	m_iPollIndex;
+};
+
+typedef std::list< CCgroupRemove > CGROUP_REMOVE_LIST;
+
+/**
+ * @ingroup LibTelnet
+ * @brief  μ cgroup v2 leaf  Ͽ CPU/޸ 뷮 ϰ Ѵ.
+ *	-  μ  cgroup Ʒ relay, session/{ ̵} cgroup  Ѵ.
+ *	-  μ relay cgroup  ̵ϰ cpu.weight, memory.min  ȣȴ.
+ *	- systemd    Delegate=yes  cgroup  Ͽ Ѵ.
+ *	-  μ Ǹ RemoveSession  cgroup.kill  ûϰ, μ   ̺Ʈ  SetPoll / Process 
+ *	  cgroup.events  ϴٰ populated  0  Ǹ cgroup  Ѵ.
+ */
+class CCgroup
+{
+public:
+	CCgroup();
+
+	bool Open( const char * pszCpuMax, int64_t iMemoryMax );
+	void Close();
+	bool IsOpen();
+
+	bool AddSession( int iSessionId, int iPid );
+	bool RemoveSession( int iSessionId );
+	int GetSessionId( int iPid );
+
+	void SetPoll( std::vector< pollfd > & clsPollList );
+	void Process( std::vector< pollfd > & clsPollList );
+	int GetTimeout();
+
+	bool GetRelayStat( CCgroupStat & clsStat );
+	bool GetSessionStat( int iSessionId, CCgroupStat & clsStat );
+	void GetSessionStatMap( CGROUP_STAT_MAP & clsMap );
+
+private:
+	bool GetPath( std::string & strPath );
+	bool GetStat( const std::string & strGroup, CCgroupStat & clsStat );
+	void GetSessionGroup( int iSessionId, std::string & strGroup );
+
+	/**  μ  cgroup  */
+	std::string	m_strPath;
+
+	/**  cgroup  cpu.max . ) "50000 100000"  CPU 0.5  Ѵ. */
+	std::string	m_strCpuMax;
+
+	/**  cgroup  memory.max . 0 ̸  ʴ´. */
+	int64_t	m_iMemoryMax;
+
+	/** cgroup  Ե  ̵ =>  μ ̵ */
+	std::map< int, int >	m_clsSessionMap;
+
+	/**  μ ̵ =>  ̵ */
+	std::map< int, int >	m_clsPidMap;
+
+	/**  ٸ  cgroup */
+	CGROUP_REMOVE_LIST	m_clsRemoveList;
+
+	bool	m_bOpen;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "CommandQueue.h"
+
+#ifndef WIN32
+#include <sys/eventfd.h>
+#endif
+
+#include "MemoryDebug.h"
+
+#ifdef WIN32
+#define AtomicExchangePointer(p,v)	InterlockedExchangePointer( (PVOID volatile *)(p), (v) )
+#define AtomicExchange(p,v)					InterlockedExchange( (p), (v) )
+#define AtomicLoad(p)								(*(p))
+#define AtomicStore(p,v)						(*(p) = (v))
+#else
+#define AtomicExchangePointer(p,v)	__atomic_exchange_n( (p), (v), __ATOMIC_ACQ_REL )
+#define AtomicExchange(p,v)					__atomic_exchange_n( (p), (v), __ATOMIC_SEQ_CST )
+#define AtomicLoad(p)								__atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define AtomicStore(p,v)						__atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+#endif
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ * @param eCommand		  
+ * @param iSessionId	 ̵
+ */
+CSessionCommand::CSessionCommand( ESessionCommand eCommand, int iSessionId ) : m_pclsNext(NULL), m_eCommand(eCommand), m_iSessionId(iSessionId), m_iRow(0), m_iCol(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CCommandQueue::CCommandQueue() : m_pclsHead(&m_clsStub), m_pclsTail(&m_clsStub), m_iSignal(0), m_hEventFd(INVALID_SOCKET)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CCommandQueue::~CCommandQueue()
+{
+	Close();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread    eventfd  Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CCommandQueue::Open()
+{
+#ifndef WIN32
+	if( m_hEventFd == INVALID_SOCKET )
+	{
+		m_hEventFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+		if( m_hEventFd == INVALID_SOCKET ) return false;
+	}
+#endif
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ť  ִ  ϰ eventfd  Ѵ.
+ *	-  producer thread  Push ȣ  Ŀ ȣؾ Ѵ.
+ */
+void CCommandQueue::Close()
+{
+	CSessionCommand * pclsCommand;
+
+	while( ( pclsCommand = Pop() ) != NULL )
+	{
+		delete pclsCommand;
+	}
+
+	if( m_hEventFd != INVALID_SOCKET )
+	{
+		closesocket( m_hEventFd );
+		m_hEventFd = INVALID_SOCKET;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ť ߰Ѵ.  thread  ÿ ȣ  ִ.
+ *	-  thread  ̺Ʈ  ó ʾ eventfd  ٽ  Ƿ  Ȳ system call  پ.
+ * @param pclsCommand	new    ü. Pop   thread  delete ؾ Ѵ.
+ */
+void CCommandQueue::Push( CSessionCommand * pclsCommand )
+{
+	Insert( pclsCommand );
+
+	if( AtomicExchange( &m_iSignal, 1 ) == 0 && m_hEventFd != INVALID_SOCKET )
+	{
+#ifndef WIN32
+		uint64_t iValue = 1;
+
+		if( write( m_hEventFd, &iValue, sizeof(iValue) ) != sizeof(iValue) )
+		{
+			// eventfd īͰ ̹ ϵǾ Ƿ  thread  .
+		}
+#endif
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ť  ´. ť  thread  ȣؾ Ѵ.
+ * @returns ť  ϸ  ü ϰ ׷  NULL  Ѵ.
+ *					ٸ thread   ߰ϴ ̸ NULL     ش thread  ߰ Ϸϸ ̺Ʈ ߻Ѵ.
+ */
+CSessionCommand * CCommandQueue::Pop()
+{
+	CSessionCommand * pclsTail = m_pclsTail;
+	CSessionCommand * pclsNext = AtomicLoad( &pclsTail->m_pclsNext );
+
+	if( pclsTail == &m_clsStub )
+	{
+		if( pclsNext == NULL ) return NULL;
+
+		m_pclsTail = pclsNext;
+		pclsTail = pclsNext;
+		pclsNext = AtomicLoad( &pclsNext->m_pclsNext );
+	}
+
+	if( pclsNext )
+	{
+		m_pclsTail = pclsNext;
+		return pclsTail;
+	}
+
+	if( pclsTail != AtomicLoad( &m_pclsHead ) ) return NULL;
+
+	Insert( &m_clsStub );
+
+	pclsNext = AtomicLoad( &pclsTail->m_pclsNext );
+	if( pclsNext )
+	{
+		m_pclsTail = pclsNext;
+		return pclsTail;
+	}
+
+	return NULL;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread  poll   eventfd  Ѵ.
+ * @returns eventfd  Ѵ. 쿡 INVALID_SOCKET  ϹǷ poll timeout  ť ˻ؾ Ѵ.
+ */
+Socket CCommandQueue::GetEventFd()
+{
+	return m_hEventFd;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief eventfd ̺Ʈ ʱȭѴ.  thread   ޼ҵ带 ȣ Ŀ Pop  ť   ; Ѵ.
+ *	- release store  ʱȭϸ  Pop  д  ʰ   ִ.   Push  m_iSignal  1 ̹Ƿ
+ *		eventfd   ʰ Pop  ߰   Ͽ wakeup  ǵȴ. ׷Ƿ seq_cst exchange  ʱȭѴ.
+ */
+void CCommandQueue::ClearEvent()
+{
+#ifndef WIN32
+	if( m_hEventFd != INVALID_SOCKET )
+	{
+		uint64_t iValue;
+
+		if( read( m_hEventFd, &iValue, sizeof(iValue) ) != sizeof(iValue) )
+		{
+			// ϵ ̺Ʈ .
+		}
+	}
+#endif
+
+	AtomicExchange( &m_iSignal, 0 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  head  Ѵ.
+ * @param pclsCommand  ü
+ */
+void CCommandQueue::Insert( CSessionCommand * pclsCommand )
+{
+	CSessionCommand * pclsPrev;
+
+	pclsCommand->m_pclsNext = NULL;
+	pclsPrev = (CSessionCommand *)AtomicExchangePointer( &m_pclsHead, pclsCommand );
+	AtomicStore( &pclsPrev->m_pclsNext, pclsCommand );
+}
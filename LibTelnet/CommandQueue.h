@@ -0,0 +1,104 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _COMMAND_QUEUE_H_
+#define _COMMAND_QUEUE_H_
+
+#include "Define.h"
+#include "Tcp.h"
+#include <string>
+
+/**
+ * @ingroup LibTelnet
+ * @brief   
+ */
+enum ESessionCommand
+{
+	E_SC_NULL = 0,
+	E_SC_BROADCAST,
+	E_SC_KILL,
+	E_SC_WINDOW_SIZE
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief ٸ thread    thread  ϴ  
+ */
+class CSessionCommand
+{
+public:
+	CSessionCommand( ESessionCommand eCommand = E_SC_NULL, int iSessionId = -1 );
+
+	/** ť ο ϴ   */
+	CSessionCommand * volatile m_pclsNext;
+
+	ESessionCommand	m_eCommand;
+
+	/**    ̵. -1 ̸ thread    ǿ  Ѵ. */
+	int	m_iSessionId;
+
+	/** E_SC_WINDOW_SIZE  ͹̳ ũ */
+	uint16_t	m_iRow;
+	uint16_t	m_iCol;
+
+	/** E_SC_BROADCAST   ޽ */
+	std::string	m_strData;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief reactor thread  ϳ ϴ lock-free multi-producer/single-consumer  ť
+ *	- Push   thread  ÿ ȣ  ְ Pop  ť  thread  ȣؾ Ѵ.
+ *	- ť  ִ ¿  ߰Ǹ eventfd  ̺Ʈ ϹǷ  thread  poll    ִ.
+ */
+class CCommandQueue
+{
+public:
+	CCommandQueue();
+	~CCommandQueue();
+
+	bool Open();
+	void Close();
+
+	void Push( CSessionCommand * pclsCommand );
+	CSessionCommand * Pop();
+
+	Socket GetEventFd();
+	void ClearEvent();
+
+private:
+	void Insert( CSessionCommand * pclsCommand );
+
+	/** producer   ߰ϴ ġ */
+	CSessionCommand * volatile m_pclsHead;
+
+	/** producer  consumer   cache line   ʵ Ѵ. */
+	char	m_szPadding[64];
+
+	/** consumer    ġ */
+	CSessionCommand * m_pclsTail;
+
+	CSessionCommand	m_clsStub;
+
+	/** eventfd  ̺Ʈ ϵǾ 1 ̴. */
+	volatile long	m_iSignal;
+
+	Socket	m_hEventFd;
+};
+
+#endif
@@ -65,6 +65,9 @@ typedef char int8_t;
 #define THREAD_API	void *
 #define LPVOID			void *
 
+// OpenSSL ̺귯    Ʒ  ּ ó϶.
+#define USE_TLS
+
 #endif
 
 #ifdef WIN32
@@ -0,0 +1,437 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "Handover.h"
+
+#ifndef WIN32
+
+#include <sys/uio.h>
+#include "MemoryDebug.h"
+
+#define HANDOVER_VERSION	3
+
+/**
+ * @ingroup LibTelnet
+ * @brief ׷̵ ޽ 
+ */
+enum EHandoverType
+{
+	E_HT_LISTEN = 1,
+	E_HT_SESSION,
+
+	/**  E_HT_SESSION ޽  Ϳ ̾  */
+	E_HT_DATA,
+	E_HT_END,
+
+	/**  FIN  ٸ  Ǵ ȸ  ڽ μ */
+	E_HT_TEARDOWN
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief ׷̵ ޽ .  ȣƮ μ ϹǷ host byte order  Ѵ.
+ */
+typedef struct
+{
+	uint16_t	iVersion;
+	uint16_t	iType;
+
+	/** E_HT_LISTEN ̸ listen  ̰ E_HT_SESSION, E_HT_TEARDOWN ̸ ڽ μ ̵̴. */
+	int32_t		iPid;
+	int32_t		iPtyFd;
+	uint32_t	iBufLen;
+} HANDOVER_HEADER;
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ * @param iKind		listen  
+ * @param hSocket	listen  ڵ
+ */
+CHandoverListen::CHandoverListen( int iKind, Socket hSocket ) : m_iKind(iKind), m_hSocket(hSocket)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CHandoverSession::CHandoverSession() : m_hSocket(INVALID_SOCKET), m_iPtyFd(-1), m_iPid(-1)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ * @param hSocket		 FIN  ٸ 
+ * @param iPid			ȸ  ڽ μ ̵
+ * @param iRemainMs	 RST  ϰų ڽ μ SIGKILL  ϱ  ð ( milli second  )
+ */
+CHandoverTeardown::CHandoverTeardown( Socket hSocket, int iPid, uint32_t iRemainMs ) : m_hSocket(hSocket), m_iPid(iPid), m_iRemainMs(iRemainMs)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CHandoverMessage::CHandoverMessage() : m_iFdCount(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ׷̵ ޽ Ͽ ߰Ѵ.
+ * @param clsMessageList	׷̵ ޽ 
+ * @param sttHeader			޽ . iBufLen   Լ Ѵ.
+ * @param pszData				 ڿ  
+ * @param iDataLen			 ڿ   
+ * @param piFd					 file descriptor 迭
+ * @param iFdCount			 file descriptor 
+ */
+static void AddMessage( HANDOVER_MESSAGE_LIST & clsMessageList, HANDOVER_HEADER & sttHeader, const char * pszData, int iDataLen, const int * piFd, int iFdCount )
+{
+	CHandoverMessage clsMessage;
+
+	sttHeader.iBufLen = (uint32_t)iDataLen;
+
+	clsMessage.m_strData.assign( (char *)&sttHeader, sizeof(sttHeader) );
+	if( iDataLen > 0 ) clsMessage.m_strData.append( pszData, iDataLen );
+
+	for( int i = 0; i < iFdCount; ++i )
+	{
+		clsMessage.m_arrFd[i] = piFd[i];
+	}
+
+	clsMessage.m_iFdCount = iFdCount;
+	clsMessageList.push_back( clsMessage );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Unix   file descriptor  ͸ Ѵ.
+ * @param hUnix			Unix   ڵ
+ * @param piFd			 file descriptor 迭
+ * @param iFdCount	 file descriptor 
+ * @param pszData		 
+ * @param iDataLen	  . 1 ̻̾ Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool SendFd( Socket hUnix, const int * piFd, int iFdCount, const char * pszData, int iDataLen )
+{
+	char szControl[CMSG_SPACE(sizeof(int) * HANDOVER_MAX_FD)];
+	struct msghdr sttMsg;
+	struct iovec sttIov;
+	int n;
+
+	if( iFdCount < 0 || iFdCount > HANDOVER_MAX_FD || iDataLen <= 0 ) return false;
+
+	memset( &sttMsg, 0, sizeof(sttMsg) );
+	memset( szControl, 0, sizeof(szControl) );
+
+	sttIov.iov_base = (void *)pszData;
+	sttIov.iov_len = iDataLen;
+
+	sttMsg.msg_iov = &sttIov;
+	sttMsg.msg_iovlen = 1;
+
+	if( iFdCount > 0 )
+	{
+		struct cmsghdr * psttCmsg;
+
+		sttMsg.msg_control = szControl;
+		sttMsg.msg_controllen = CMSG_SPACE(sizeof(int) * iFdCount);
+
+		psttCmsg = CMSG_FIRSTHDR( &sttMsg );
+		psttCmsg->cmsg_level = SOL_SOCKET;
+		psttCmsg->cmsg_type = SCM_RIGHTS;
+		psttCmsg->cmsg_len = CMSG_LEN(sizeof(int) * iFdCount);
+		memcpy( CMSG_DATA(psttCmsg), piFd, sizeof(int) * iFdCount );
+	}
+
+	do
+	{
+		n = sendmsg( hUnix, &sttMsg, MSG_NOSIGNAL );
+	} while( n == -1 && errno == EINTR );
+
+	return ( n == iDataLen );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Unix   file descriptor  ͸ Ѵ.
+ *	-  file descriptor  FD_CLOEXEC  ȴ.
+ * @param hUnix			Unix   ڵ
+ * @param piFd			 file descriptor   迭
+ * @param iFdSize		piFd 迭 ũ
+ * @param piFdCount	 file descriptor   
+ * @param pszData		 
+ * @param iDataSize	  ũ
+ * @param iSecond		 timeout (   )
+ * @returns ϸ   ̸ ϰ ׷  -1  Ѵ.
+ */
+int RecvFd( Socket hUnix, int * piFd, int iFdSize, int * piFdCount, char * pszData, int iDataSize, int iSecond )
+{
+	char szControl[CMSG_SPACE(sizeof(int) * HANDOVER_MAX_FD)];
+	struct msghdr sttMsg;
+	struct iovec sttIov;
+	struct cmsghdr * psttCmsg;
+	pollfd sttPoll[1];
+	int n, iCount = 0;
+
+	*piFdCount = 0;
+
+	TcpSetPollIn( sttPoll[0], hUnix );
+	if( poll( sttPoll, 1, 1000 * iSecond ) <= 0 ) return -1;
+
+	memset( &sttMsg, 0, sizeof(sttMsg) );
+
+	sttIov.iov_base = pszData;
+	sttIov.iov_len = iDataSize;
+
+	sttMsg.msg_iov = &sttIov;
+	sttMsg.msg_iovlen = 1;
+	sttMsg.msg_control = szControl;
+	sttMsg.msg_controllen = sizeof(szControl);
+
+	do
+	{
+		n = recvmsg( hUnix, &sttMsg, MSG_CMSG_CLOEXEC );
+	} while( n == -1 && errno == EINTR );
+
+	if( n <= 0 ) return -1;
+
+	for( psttCmsg = CMSG_FIRSTHDR( &sttMsg ); psttCmsg; psttCmsg = CMSG_NXTHDR( &sttMsg, psttCmsg ) )
+	{
+		if( psttCmsg->cmsg_level != SOL_SOCKET || psttCmsg->cmsg_type != SCM_RIGHTS ) continue;
+
+		int iFdCount = ( psttCmsg->cmsg_len - CMSG_LEN(0) ) / sizeof(int);
+		int * piRecvFd = (int *)CMSG_DATA(psttCmsg);
+
+		for( int i = 0; i < iFdCount; ++i )
+		{
+			if( iCount < iFdSize )
+			{
+				piFd[iCount++] = piRecvFd[i];
+			}
+			else
+			{
+				close( piRecvFd[i] );
+			}
+		}
+	}
+
+	*piFdCount = iCount;
+
+	if( sttMsg.msg_flags & ( MSG_TRUNC | MSG_CTRUNC ) )
+	{
+		for( int i = 0; i < iCount; ++i ) close( piFd[i] );
+		*piFdCount = 0;
+		return -1;
+	}
+
+	return n;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵带 ؼ listen ,  ,   ϰ ڽ μ ϴ ޽ Ѵ.
+ *	- ׷̵ ޽ fork  ڽ μ ϹǷ ޸𸮸 Ҵϴ ۾ fork   Լ  Ѵ.
+ * @param clsListenList		listen  Ʈ
+ * @param clsSessionList	  Ʈ
+ * @param clsTeardownList	  ϰ ȸ  ڽ μ Ʈ
+ * @param clsMessageList	 ޽  Ʈ
+ * @returns ϸ true  ϰ  Ͱ ʹ ũ false  Ѵ.
+ */
+bool HandoverBuild( HANDOVER_LISTEN_LIST & clsListenList, HANDOVER_SESSION_LIST & clsSessionList, HANDOVER_TEARDOWN_LIST & clsTeardownList, HANDOVER_MESSAGE_LIST & clsMessageList )
+{
+	HANDOVER_LISTEN_LIST::iterator itListen;
+	HANDOVER_SESSION_LIST::iterator itList;
+	HANDOVER_TEARDOWN_LIST::iterator itTeardown;
+	HANDOVER_HEADER sttHeader;
+	int arrFd[HANDOVER_MAX_FD];
+	int iFdCount, iPos, iLen;
+
+	clsMessageList.clear();
+
+	memset( &sttHeader, 0, sizeof(sttHeader) );
+	sttHeader.iVersion = HANDOVER_VERSION;
+	sttHeader.iType = E_HT_LISTEN;
+	sttHeader.iPtyFd = -1;
+
+	for( itListen = clsListenList.begin(); itListen != clsListenList.end(); ++itListen )
+	{
+		sttHeader.iPid = itListen->m_iKind;
+		arrFd[0] = itListen->m_hSocket;
+
+		AddMessage( clsMessageList, sttHeader, NULL, 0, arrFd, 1 );
+	}
+
+	for( itList = clsSessionList.begin(); itList != clsSessionList.end(); ++itList )
+	{
+		int iBufLen = (int)itList->m_strBuf.length();
+
+		if( itList->m_strBuf.length() > HANDOVER_MAX_SESSION_SIZE ) return false;
+
+		sttHeader.iType = E_HT_SESSION;
+		sttHeader.iPid = itList->m_iPid;
+		sttHeader.iPtyFd = ( itList->m_iPtyFd >= 0 ) ? 1 : -1;
+
+		iFdCount = 0;
+		arrFd[iFdCount++] = itList->m_hSocket;
+		if( itList->m_iPtyFd >= 0 ) arrFd[iFdCount++] = itList->m_iPtyFd;
+
+		iLen = ( iBufLen > HANDOVER_MAX_BUF_SIZE ) ? HANDOVER_MAX_BUF_SIZE : iBufLen;
+		AddMessage( clsMessageList, sttHeader, itList->m_strBuf.data(), iLen, arrFd, iFdCount );
+
+		// SOCK_SEQPACKET ޽ ũ    ũ ѵǹǷ  ʹ  Ѵ.
+		sttHeader.iType = E_HT_DATA;
+		sttHeader.iPid = -1;
+		sttHeader.iPtyFd = -1;
+
+		for( iPos = iLen; iPos < iBufLen; iPos += iLen )
+		{
+			iLen = iBufLen - iPos;
+			if( iLen > HANDOVER_MAX_BUF_SIZE ) iLen = HANDOVER_MAX_BUF_SIZE;
+
+			AddMessage( clsMessageList, sttHeader, itList->m_strBuf.data() + iPos, iLen, NULL, 0 );
+		}
+	}
+
+	sttHeader.iType = E_HT_TEARDOWN;
+	sttHeader.iPtyFd = -1;
+
+	for( itTeardown = clsTeardownList.begin(); itTeardown != clsTeardownList.end(); ++itTeardown )
+	{
+		sttHeader.iPid = itTeardown->m_iPid;
+		arrFd[0] = itTeardown->m_hSocket;
+
+		AddMessage( clsMessageList, sttHeader, (char *)&itTeardown->m_iRemainMs, sizeof(itTeardown->m_iRemainMs), arrFd, ( itTeardown->m_hSocket == INVALID_SOCKET ) ? 0 : 1 );
+	}
+
+	sttHeader.iType = E_HT_END;
+	sttHeader.iPid = -1;
+	sttHeader.iPtyFd = -1;
+
+	AddMessage( clsMessageList, sttHeader, NULL, 0, NULL, 0 );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief HandoverBuild   ޽ ο μ Ѵ.
+ *	- ޸𸮸 Ҵ ʰ sendmsg  ȣϹǷ  thread   μ fork  ڽ μ ȣ  ִ.
+ *	-  Լ ϵ Ŀ ȣ μ  close Ͽ ο μ  ȴ.
+ * @param hUnix						SOCK_SEQPACKET Unix   ڵ
+ * @param clsMessageList	HandoverBuild   ޽ Ʈ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool HandoverSend( Socket hUnix, const HANDOVER_MESSAGE_LIST & clsMessageList )
+{
+	for( size_t i = 0; i < clsMessageList.size(); ++i )
+	{
+		const CHandoverMessage & clsMessage = clsMessageList[i];
+
+		if( SendFd( hUnix, clsMessage.m_arrFd, clsMessage.m_iFdCount, clsMessage.m_strData.data(), (int)clsMessage.m_strData.length() ) == false ) return false;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   μ  listen ,  ,   ϰ ڽ μ Ѵ.
+ * @param hUnix						SOCK_SEQPACKET Unix   ڵ
+ * @param clsListenList		listen   Ʈ
+ * @param clsSessionList	   Ʈ
+ * @param clsTeardownList	  ϰ ȸ  ڽ μ  Ʈ
+ * @param iSecond					޽  timeout (   )
+ * @returns ϸ true  ϰ ׷  false  Ѵ. Ͽ   Ʈ Ǿ ִ.
+ */
+bool HandoverRecv( Socket hUnix, HANDOVER_LISTEN_LIST & clsListenList, HANDOVER_SESSION_LIST & clsSessionList, HANDOVER_TEARDOWN_LIST & clsTeardownList, int iSecond )
+{
+	HANDOVER_HEADER sttHeader;
+	int arrFd[HANDOVER_MAX_FD];
+	int n, iFdCount = 0;
+	bool bRes = false;
+
+	char * pszData = (char *)malloc( sizeof(sttHeader) + HANDOVER_MAX_BUF_SIZE );
+	if( pszData == NULL ) return false;
+
+	while( 1 )
+	{
+		n = RecvFd( hUnix, arrFd, HANDOVER_MAX_FD, &iFdCount, pszData, sizeof(sttHeader) + HANDOVER_MAX_BUF_SIZE, iSecond );
+		if( n < (int)sizeof(sttHeader) ) break;
+
+		memcpy( &sttHeader, pszData, sizeof(sttHeader) );
+		if( sttHeader.iVersion != HANDOVER_VERSION || sttHeader.iBufLen != n - sizeof(sttHeader) ) break;
+
+		if( sttHeader.iType == E_HT_END )
+		{
+			bRes = ( iFdCount == 0 );
+			break;
+		}
+		else if( sttHeader.iType == E_HT_LISTEN && iFdCount == 1 )
+		{
+			clsListenList.push_back( CHandoverListen( sttHeader.iPid, arrFd[0] ) );
+			iFdCount = 0;
+		}
+		else if( sttHeader.iType == E_HT_SESSION && iFdCount == ( sttHeader.iPtyFd >= 0 ? 2 : 1 ) )
+		{
+			CHandoverSession clsSession;
+
+			clsSession.m_hSocket = arrFd[0];
+			if( iFdCount == 2 ) clsSession.m_iPtyFd = arrFd[1];
+			clsSession.m_iPid = sttHeader.iPid;
+			clsSession.m_strBuf.append( pszData + sizeof(sttHeader), sttHeader.iBufLen );
+
+			clsSessionList.push_back( clsSession );
+			iFdCount = 0;
+		}
+		else if( sttHeader.iType == E_HT_DATA && iFdCount == 0 && clsSessionList.empty() == false &&
+			clsSessionList.back().m_strBuf.length() + sttHeader.iBufLen <= HANDOVER_MAX_SESSION_SIZE )
+		{
+			clsSessionList.back().m_strBuf.append( pszData + sizeof(sttHeader), sttHeader.iBufLen );
+		}
+		else if( sttHeader.iType == E_HT_TEARDOWN && sttHeader.iBufLen == sizeof(uint32_t) && iFdCount <= 1 && ( iFdCount == 1 || sttHeader.iPid > 0 ) )
+		{
+			CHandoverTeardown clsTeardown( iFdCount == 1 ? arrFd[0] : INVALID_SOCKET, sttHeader.iPid );
+
+			memcpy( &clsTeardown.m_iRemainMs, pszData + sizeof(sttHeader), sizeof(uint32_t) );
+
+			clsTeardownList.push_back( clsTeardown );
+			iFdCount = 0;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	for( int i = 0; i < iFdCount; ++i )
+	{
+		close( arrFd[i] );
+	}
+
+	free( pszData );
+
+	return bRes;
+}
+
+#endif
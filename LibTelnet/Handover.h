@@ -0,0 +1,125 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _HANDOVER_H_
+#define _HANDOVER_H_
+
+#include "Define.h"
+#include "Tcp.h"
+
+#ifndef WIN32
+
+#include <list>
+#include <vector>
+
+// ϳ ޽ ϴ ִ   ũ. ū  ʹ  ޽  Ѵ.
+#define HANDOVER_MAX_BUF_SIZE		65536
+
+// ϳ ǿ   ִ ִ  ũ
+#define HANDOVER_MAX_SESSION_SIZE	( 4 * 1024 * 1024 )
+
+// ϳ ޽   ִ ִ file descriptor 
+#define HANDOVER_MAX_FD		4
+
+// CHandoverTeardown  ڽ μ SIGKILL   ʴ´.
+#define HANDOVER_NO_DEADLINE	0xFFFFFFFF
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵ ο μ ϴ listen 
+ */
+class CHandoverListen
+{
+public:
+	CHandoverListen( int iKind = 0, Socket hSocket = INVALID_SOCKET );
+
+	/** listen  .    Ѵ. */
+	int			m_iKind;
+	Socket	m_hSocket;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵ ο μ ϴ  
+ */
+class CHandoverSession
+{
+public:
+	CHandoverSession();
+
+	/** Ŭ̾Ʈ TCP  */
+	Socket	m_hSocket;
+
+	/** PTY master file descriptor.  -1 ̴. */
+	int			m_iPtyFd;
+
+	/**  shell μ ̵.  -1 ̴. */
+	int			m_iPid;
+
+	/**   ( ȣȭ ,      ).    Ѵ. */
+	std::string	m_strBuf;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵ ο μ ϴ    Ǵ ȸ  ڽ μ
+ */
+class CHandoverTeardown
+{
+public:
+	CHandoverTeardown( Socket hSocket = INVALID_SOCKET, int iPid = -1, uint32_t iRemainMs = HANDOVER_NO_DEADLINE );
+
+	/**  FIN  ٸ .  INVALID_SOCKET ̴. */
+	Socket	m_hSocket;
+
+	/** ȸ  ڽ μ ̵.  -1 ̴. */
+	int			m_iPid;
+
+	/**  RST  ϰų ڽ μ SIGKILL  ϱ  ð ( milli second  ) */
+	uint32_t	m_iRemainMs;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief fork  ϴ ׷̵ ޽
+ */
+class CHandoverMessage
+{
+public:
+	CHandoverMessage();
+
+	std::string	m_strData;
+	int	m_arrFd[HANDOVER_MAX_FD];
+	int	m_iFdCount;
+};
+
+typedef std::list< CHandoverListen > HANDOVER_LISTEN_LIST;
+typedef std::list< CHandoverSession > HANDOVER_SESSION_LIST;
+typedef std::list< CHandoverTeardown > HANDOVER_TEARDOWN_LIST;
+typedef std::vector< CHandoverMessage > HANDOVER_MESSAGE_LIST;
+
+bool SendFd( Socket hUnix, const int * piFd, int iFdCount, const char * pszData, int iDataLen );
+int RecvFd( Socket hUnix, int * piFd, int iFdSize, int * piFdCount, char * pszData, int iDataSize, int iSecond );
+
+bool HandoverBuild( HANDOVER_LISTEN_LIST & clsListenList, HANDOVER_SESSION_LIST & clsSessionList, HANDOVER_TEARDOWN_LIST & clsTeardownList, HANDOVER_MESSAGE_LIST & clsMessageList );
+bool HandoverSend( Socket hUnix, const HANDOVER_MESSAGE_LIST & clsMessageList );
+bool HandoverRecv( Socket hUnix, HANDOVER_LISTEN_LIST & clsListenList, HANDOVER_SESSION_LIST & clsSessionList, HANDOVER_TEARDOWN_LIST & clsTeardownList, int iSecond );
+
+#endif
+
+#endif
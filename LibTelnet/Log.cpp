@@ -0,0 +1,892 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "Log.h"
+#include <string>
+#include <list>
+#include <time.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include "MemoryDebug.h"
+
+#ifdef WIN32
+#define AtomicExchange(p,v)		InterlockedExchange( (p), (v) )
+#define AtomicIncrement(p)		InterlockedIncrement64( (p) )
+#define AtomicLoad(p)					(*(p))
+#define AtomicStore(p,v)			(*(p) = (v))
+#define THREAD_LOCAL					__declspec(thread)
+#else
+#define AtomicExchange(p,v)		__atomic_exchange_n( (p), (v), __ATOMIC_ACQ_REL )
+#define AtomicIncrement(p)		__atomic_add_fetch( (p), 1, __ATOMIC_RELAXED )
+#define AtomicLoad(p)					__atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define AtomicStore(p,v)			__atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+#define THREAD_LOCAL					__thread
+#endif
+
+// ׶ thread  ring  ˻ϴ ֱ ( milli second  )
+#define LOG_WRITE_PERIOD		10
+
+// Ͽ ѹ ϴ ִ ũ
+#define LOG_WRITE_BUF_SIZE	( 64 * 1024 )
+
+/**
+ * @ingroup LibTelnet
+ * @brief α ڵ忡 Ǵ  
+ */
+enum ELogArgType
+{
+	E_LAT_INT = 1,
+	E_LAT_INT64,
+	E_LAT_DOUBLE,
+	E_LAT_STRING,
+	E_LAT_POINTER
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief α ڵ .  ڿ {  1 byte}{ }   ŭ ȴ.
+ */
+typedef struct
+{
+	/**   ڵ ũ ( 8   ). 0 ̸ ring    ʴ´. */
+	uint16_t	iSize;
+	uint8_t		iLevel;
+	uint8_t		iReserved[5];
+
+	/** α  ð ( 1970   micro second  ) */
+	uint64_t	iTime;
+
+	/**  ڿ ( format id ) */
+	const char * pszFormat;
+} LOG_RECORD_HEADER;
+
+/**
+ * @ingroup LibTelnet
+ * @brief thread  α ڵ single-producer/single-consumer ring
+ */
+class CLogRing
+{
+public:
+	CLogRing() : m_iHead(0), m_iTail(0), m_iClosed(0), m_iThreadId(0)
+	{
+	}
+
+	bool Write( const char * pszRecord, uint32_t iSize );
+	int Read( std::string & strBuf );
+
+	/** producer   ġ */
+	volatile uint32_t	m_iHead;
+	char	m_szPadding1[60];
+
+	/** consumer   ġ */
+	volatile uint32_t	m_iTail;
+	char	m_szPadding2[60];
+
+	/** producer thread  Ǿ 1 ̴. */
+	volatile long	m_iClosed;
+
+	unsigned long	m_iThreadId;
+
+	char	m_szBuf[LOG_RING_SIZE];
+};
+
+typedef std::list< CLogRing * > LOG_RING_LIST;
+
+int CLog::m_iLevel = LOG_ERROR | LOG_INFO;
+
+static LOG_RING_LIST gclsRingList;
+static volatile long giRingListLock = 0;
+static THREAD_LOCAL CLogRing * gpclsRing = NULL;
+
+static volatile long giStart = 0;
+static volatile long giStop = 0;
+static volatile int64_t giDropCount = 0;
+static FILE * gpsttFile = NULL;
+
+#ifdef WIN32
+static HANDLE ghThread = NULL;
+static DWORD giRingKey = FLS_OUT_OF_INDEXES;
+#else
+static pthread_t gsttThread;
+static pthread_key_t gsttRingKey;
+static pthread_once_t gsttRingKeyOnce = PTHREAD_ONCE_INIT;
+#endif
+
+static void FormatRecord( unsigned long iThreadId, const char * pszRecord, std::string & strBuf );
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring  spin lock  ȹѴ. ring  thread  ù° α   ׶ thread  Ѵ.
+ */
+static void LockRingList()
+{
+	while( AtomicExchange( &giRingListLock, 1 ) )
+	{
+#ifdef WIN32
+		Sleep( 0 );
+#else
+		sched_yield();
+#endif
+	}
+}
+
+static void UnlockRingList()
+{
+	AtomicStore( &giRingListLock, 0 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief thread  Ǹ ring   · Ѵ. ׶ thread   ڵ带  Ŀ ring  Ѵ.
+ *	WIN32  __declspec(thread)  Ҹ Լ Ƿ FlsAlloc  callback  ȣȴ.
+ * @param pArg CLogRing ü
+ */
+#ifdef WIN32
+static VOID WINAPI CloseRing( PVOID pArg )
+#else
+static void CloseRing( void * pArg )
+#endif
+{
+	if( pArg ) AtomicStore( &((CLogRing *)pArg)->m_iClosed, 1 );
+}
+
+#ifndef WIN32
+static void CreateRingKey()
+{
+	pthread_key_create( &gsttRingKey, CloseRing );
+}
+#endif
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread  ring  ´. ring   Ͽ ring Ͽ ߰Ѵ.
+ * @returns  thread  ring  Ѵ.
+ */
+static CLogRing * GetRing()
+{
+	if( gpclsRing ) return gpclsRing;
+
+	CLogRing * pclsRing = new CLogRing();
+
+#ifdef WIN32
+	pclsRing->m_iThreadId = GetCurrentThreadId();
+
+	if( giRingKey != FLS_OUT_OF_INDEXES ) FlsSetValue( giRingKey, pclsRing );
+#else
+	pclsRing->m_iThreadId = syscall( SYS_gettid );
+
+	pthread_once( &gsttRingKeyOnce, CreateRingKey );
+	pthread_setspecific( gsttRingKey, pclsRing );
+#endif
+
+	LockRingList();
+	gclsRingList.push_back( pclsRing );
+	UnlockRingList();
+
+	gpclsRing = pclsRing;
+
+	return pclsRing;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ð micro second  ´.
+ * @returns 1970   micro second  Ѵ.
+ */
+static uint64_t GetTimeUs()
+{
+#ifdef WIN32
+	FILETIME sttTime;
+	uint64_t iTime;
+
+	GetSystemTimeAsFileTime( &sttTime );
+	iTime = ( (uint64_t)sttTime.dwHighDateTime << 32 ) | sttTime.dwLowDateTime;
+
+	// 1601   100 nano second  ȯѴ.
+	return iTime / 10 - 11644473600000000ULL;
+#else
+	struct timespec sttTime;
+
+	// CLOCK_REALTIME  е  ( 1 ~ 4 ms ) ȣ  ۴.
+#ifdef CLOCK_REALTIME_COARSE
+	clock_gettime( CLOCK_REALTIME_COARSE, &sttTime );
+#else
+	clock_gettime( CLOCK_REALTIME, &sttTime );
+#endif
+
+	return (uint64_t)sttTime.tv_sec * 1000000 + sttTime.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring  ڵ带 Ѵ.  ϸ  ʰ false  Ѵ.
+ * @param pszRecord	ڵ
+ * @param iSize			ڵ ũ ( 8   )
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CLogRing::Write( const char * pszRecord, uint32_t iSize )
+{
+	uint32_t iHead = m_iHead;
+	uint32_t iFree = LOG_RING_SIZE - ( iHead - AtomicLoad( &m_iTail ) );
+	uint32_t iPos = iHead & ( LOG_RING_SIZE - 1 );
+	uint32_t iLast = LOG_RING_SIZE - iPos;
+
+	// ڵ ring     ʴ´.
+	if( iLast < iSize )
+	{
+		if( iFree < iLast + iSize ) return false;
+
+		((LOG_RECORD_HEADER *)( m_szBuf + iPos ))->iSize = 0;
+		iHead += iLast;
+		iPos = 0;
+	}
+	else if( iFree < iSize )
+	{
+		return false;
+	}
+
+	memcpy( m_szBuf + iPos, pszRecord, iSize );
+	AtomicStore( &m_iHead, iHead + iSize );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring    ڵ带 ڿ ȯѴ.
+ * @param strBuf ȯ ڿ ߰ 
+ * @returns ȯ ڵ  Ѵ.
+ */
+int CLogRing::Read( std::string & strBuf )
+{
+	uint32_t iTail = m_iTail;
+	uint32_t iHead = AtomicLoad( &m_iHead );
+	int iCount = 0;
+
+	while( iTail != iHead )
+	{
+		uint32_t iPos = iTail & ( LOG_RING_SIZE - 1 );
+		LOG_RECORD_HEADER * psttHeader = (LOG_RECORD_HEADER *)( m_szBuf + iPos );
+
+		if( psttHeader->iSize == 0 )
+		{
+			iTail += LOG_RING_SIZE - iPos;
+		}
+		else
+		{
+			FormatRecord( m_iThreadId, m_szBuf + iPos, strBuf );
+			iTail += psttHeader->iSize;
+			++iCount;
+		}
+
+		AtomicStore( &m_iTail, iTail );
+	}
+
+	return iCount;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief α  ڿ ´.
+ * @param iLevel α 
+ * @returns α  ڿ Ѵ.
+ */
+static const char * GetLevelString( int iLevel )
+{
+	switch( iLevel )
+	{
+	case LOG_ERROR: return "ERROR";
+	case LOG_INFO: return "INFO";
+	case LOG_DEBUG: return "DEBUG";
+	case LOG_NETWORK: return "NETWORK";
+	}
+
+	return "UNKNOWN";
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief α  ð, thread ̵,  ڿ Ѵ.
+ * @param iTime			α  ð ( micro second  )
+ * @param iThreadId	thread ̵
+ * @param iLevel		α 
+ * @param pszBuf		ڿ  
+ * @param iBufSize	pszBuf  ũ
+ * @returns  ڿ ̸ Ѵ.
+ */
+static int GetLinePrefix( uint64_t iTime, unsigned long iThreadId, int iLevel, char * pszBuf, int iBufSize )
+{
+	time_t iSecond = (time_t)( iTime / 1000000 );
+	struct tm sttTm;
+
+#ifdef WIN32
+	localtime_s( &sttTm, &iSecond );
+#else
+	localtime_r( &iSecond, &sttTm );
+#endif
+
+	return snprintf( pszBuf, iBufSize, "[%04d/%02d/%02d %02d:%02d:%02d.%03u] [%lu] [%s] "
+		, sttTm.tm_year + 1900, sttTm.tm_mon + 1, sttTm.tm_mday, sttTm.tm_hour, sttTm.tm_min, sttTm.tm_sec
+		, (unsigned int)( iTime % 1000000 / 1000 ), iThreadId, GetLevelString( iLevel ) );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ڵ忡 ڸ Ѵ.
+ * @param pszRecord	ڵ
+ * @param iPos			ڵ  ġ
+ * @param cType			 
+ * @param pValue		 
+ * @param iLen			  ũ
+ * @returns ϸ true  ϰ ڵ  ϸ false  Ѵ.
+ */
+static bool PutArg( char * pszRecord, int & iPos, char cType, const void * pValue, int iLen )
+{
+	//   ǥø  1 byte  ܵд.
+	if( iPos + 1 + iLen >= LOG_MAX_RECORD_SIZE ) return false;
+
+	pszRecord[iPos++] = cType;
+	memcpy( pszRecord + iPos, pValue, iLen );
+	iPos += iLen;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ڿ мϿ  ڸ ڵ忡 Ѵ. ڿ ڴ LOG_MAX_STRING_SIZE  Ѵ.
+ * @param pszRecord	ڵ
+ * @param iPos			ڵ  ġ
+ * @param fmt				 ڿ
+ * @param ap				 
+ */
+static void PutArgList( char * pszRecord, int & iPos, const char * fmt, va_list ap )
+{
+	const char * p = fmt;
+	int32_t iValue;
+	int64_t iValue64;
+	double dbValue;
+	void * pValue;
+
+	//  ڿ Ϲ ڴ strchr  ǳʶڴ.
+	while( ( p = strchr( p, '%' ) ) != NULL )
+	{
+		++p;
+		if( *p == '%' )
+		{
+			++p;
+			continue;
+		}
+
+		while( *p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' ) ++p;
+
+		for( int i = 0; i < 2; ++i )
+		{
+			if( *p == '*' )
+			{
+				iValue = va_arg( ap, int );
+				if( PutArg( pszRecord, iPos, E_LAT_INT, &iValue, sizeof(iValue) ) == false ) return;
+				++p;
+			}
+			else
+			{
+				while( *p >= '0' && *p <= '9' ) ++p;
+			}
+
+			if( i == 0 )
+			{
+				if( *p != '.' ) break;
+				++p;
+			}
+		}
+
+		// 0 : int, 1 : long, 2 : long long, 3 : size_t, 4 : long double
+		int iLength = 0;
+
+		for( bool bLength = true; bLength; )
+		{
+			switch( *p )
+			{
+			case 'h': break;
+			case 'l': ++iLength; break;
+			case 'q': case 'j': iLength = 2; break;
+			case 'z': case 't': iLength = 3; break;
+			case 'L': iLength = 4; break;
+			default: bLength = false; continue;
+			}
+
+			++p;
+		}
+
+		switch( *p )
+		{
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+			if( iLength == 0 || *p == 'c' )
+			{
+				iValue = va_arg( ap, int );
+				if( PutArg( pszRecord, iPos, E_LAT_INT, &iValue, sizeof(iValue) ) == false ) return;
+				break;
+			}
+
+			if( iLength == 1 ) iValue64 = va_arg( ap, long );
+			else if( iLength == 3 ) iValue64 = va_arg( ap, size_t );
+			else iValue64 = va_arg( ap, long long );
+
+			if( *p != 'd' && *p != 'i' )
+			{
+				// ȣ    ũ⸦ Ѵ.
+				if( iLength == 1 && sizeof(long) == 4 ) iValue64 = (uint32_t)iValue64;
+				else if( iLength == 3 && sizeof(size_t) == 4 ) iValue64 = (uint32_t)iValue64;
+			}
+
+			if( PutArg( pszRecord, iPos, E_LAT_INT64, &iValue64, sizeof(iValue64) ) == false ) return;
+			break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+			if( iLength == 4 ) dbValue = (double)va_arg( ap, long double );
+			else dbValue = va_arg( ap, double );
+
+			if( PutArg( pszRecord, iPos, E_LAT_DOUBLE, &dbValue, sizeof(dbValue) ) == false ) return;
+			break;
+		case 's':
+			{
+				const char * pszValue = va_arg( ap, const char * );
+				if( pszValue == NULL ) pszValue = "(null)";
+
+				uint16_t iLen = (uint16_t)strnlen( pszValue, LOG_MAX_STRING_SIZE );
+				if( iPos + 1 + (int)sizeof(iLen) + iLen >= LOG_MAX_RECORD_SIZE ) return;
+
+				pszRecord[iPos++] = E_LAT_STRING;
+				memcpy( pszRecord + iPos, &iLen, sizeof(iLen) );
+				iPos += sizeof(iLen);
+				memcpy( pszRecord + iPos, pszValue, iLen );
+				iPos += iLen;
+			}
+			break;
+		case 'p':
+			pValue = va_arg( ap, void * );
+			if( PutArg( pszRecord, iPos, E_LAT_POINTER, &pValue, sizeof(pValue) ) == false ) return;
+			break;
+		case 'n':
+			va_arg( ap, int * );
+			break;
+		case '\0':
+			return;
+		}
+
+		++p;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ڵ带 ڿ ȯѴ. ȯ     ´  ڷ Ͽ snprintf  ȯѴ.
+ * @param iThreadId	ڵ带  thread ̵
+ * @param pszRecord	ڵ
+ * @param strBuf		ȯ ڿ ߰ 
+ */
+static void FormatRecord( unsigned long iThreadId, const char * pszRecord, std::string & strBuf )
+{
+	const LOG_RECORD_HEADER * psttHeader = (const LOG_RECORD_HEADER *)pszRecord;
+	const char * pszArg = pszRecord + sizeof(LOG_RECORD_HEADER);
+	const char * pszArgEnd = pszRecord + psttHeader->iSize;
+	const char * p = psttHeader->pszFormat;
+	char szSpec[64], szText[LOG_MAX_STRING_SIZE + 64], szString[LOG_MAX_STRING_SIZE + 1];
+	int iSpecLen, n;
+
+	n = GetLinePrefix( psttHeader->iTime, iThreadId, psttHeader->iLevel, szText, sizeof(szText) );
+	strBuf.append( szText, n );
+
+	while( *p )
+	{
+		const char * pszStart = p;
+
+		while( *p && *p != '%' ) ++p;
+		strBuf.append( pszStart, p - pszStart );
+
+		if( *p == '\0' ) break;
+
+		if( p[1] == '%' )
+		{
+			strBuf.push_back( '%' );
+			p += 2;
+			continue;
+		}
+
+		//  ڰ    ڿ ״ Ѵ.
+		if( pszArg >= pszArgEnd || *pszArg == 0 )
+		{
+			strBuf.append( p );
+			break;
+		}
+
+		szSpec[0] = *p++;
+		iSpecLen = 1;
+
+		while( *p && strchr( "-+ #0123456789.*", *p ) && iSpecLen < 40 )
+		{
+			if( *p == '*' && pszArg < pszArgEnd && *pszArg == E_LAT_INT )
+			{
+				int32_t iValue;
+
+				memcpy( &iValue, pszArg + 1, sizeof(iValue) );
+				pszArg += 1 + sizeof(iValue);
+				iSpecLen += snprintf( szSpec + iSpecLen, sizeof(szSpec) - iSpecLen, "%d", iValue );
+			}
+			else
+			{
+				szSpec[iSpecLen++] = *p;
+			}
+
+			++p;
+		}
+
+		while( *p && strchr( "hlLqjzt", *p ) ) ++p;
+
+		if( *p == '\0' ) break;
+
+		char cConversion = *p++;
+
+		// PutArgList  ڸ  ʴ ȯ   ʴ´.
+		if( strchr( "diuxXoceEfFgGaAsp", cConversion ) == NULL ) continue;
+
+		char cType = *pszArg++;
+
+		switch( cType )
+		{
+		case E_LAT_INT:
+			{
+				int32_t iValue;
+
+				memcpy( &iValue, pszArg, sizeof(iValue) );
+				pszArg += sizeof(iValue);
+
+				szSpec[iSpecLen] = cConversion;
+				szSpec[iSpecLen+1] = '\0';
+				n = snprintf( szText, sizeof(szText), szSpec, iValue );
+			}
+			break;
+		case E_LAT_INT64:
+			{
+				long long iValue;
+
+				memcpy( &iValue, pszArg, sizeof(iValue) );
+				pszArg += sizeof(iValue);
+
+				szSpec[iSpecLen] = 'l';
+				szSpec[iSpecLen+1] = 'l';
+				szSpec[iSpecLen+2] = cConversion;
+				szSpec[iSpecLen+3] = '\0';
+				n = snprintf( szText, sizeof(szText), szSpec, iValue );
+			}
+			break;
+		case E_LAT_DOUBLE:
+			{
+				double dbValue;
+
+				memcpy( &dbValue, pszArg, sizeof(dbValue) );
+				pszArg += sizeof(dbValue);
+
+				szSpec[iSpecLen] = cConversion;
+				szSpec[iSpecLen+1] = '\0';
+				n = snprintf( szText, sizeof(szText), szSpec, dbValue );
+			}
+			break;
+		case E_LAT_STRING:
+			{
+				uint16_t iLen;
+
+				memcpy( &iLen, pszArg, sizeof(iLen) );
+				pszArg += sizeof(iLen);
+				memcpy( szString, pszArg, iLen );
+				szString[iLen] = '\0';
+				pszArg += iLen;
+
+				szSpec[iSpecLen] = 's';
+				szSpec[iSpecLen+1] = '\0';
+				n = snprintf( szText, sizeof(szText), szSpec, szString );
+			}
+			break;
+		case E_LAT_POINTER:
+			{
+				void * pValue;
+
+				memcpy( &pValue, pszArg, sizeof(pValue) );
+				pszArg += sizeof(pValue);
+
+				szSpec[iSpecLen] = 'p';
+				szSpec[iSpecLen+1] = '\0';
+				n = snprintf( szText, sizeof(szText), szSpec, pValue );
+			}
+			break;
+		default:
+			n = 0;
+			pszArgEnd = pszArg;
+			break;
+		}
+
+		if( n > (int)sizeof(szText) - 1 ) n = sizeof(szText) - 1;
+		if( n > 0 ) strBuf.append( szText, n );
+	}
+
+	strBuf.push_back( '\n' );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief α   ׶ thread  Ѵ. Start  ȣϱ  Print  stdout  ٷ Ѵ.
+ * @param pszFileName α  . NULL ̸ stdout  Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CLog::Start( const char * pszFileName )
+{
+	if( AtomicLoad( &giStart ) ) return true;
+
+	if( pszFileName )
+	{
+		gpsttFile = fopen( pszFileName, "a" );
+		if( gpsttFile == NULL ) return false;
+	}
+	else
+	{
+		gpsttFile = stdout;
+	}
+
+	giStop = 0;
+
+#ifdef WIN32
+	// α׸  thread  Ǹ ring  ϵ thread  ring  ϱ  callback  Ѵ.
+	if( giRingKey == FLS_OUT_OF_INDEXES ) giRingKey = FlsAlloc( CloseRing );
+
+	ghThread = CreateThread( NULL, 0, WriteThread, NULL, 0, NULL );
+	if( ghThread == NULL )
+#else
+	if( pthread_create( &gsttThread, NULL, WriteThread, NULL ) != 0 )
+#endif
+	{
+		if( gpsttFile != stdout ) fclose( gpsttFile );
+		gpsttFile = NULL;
+		return false;
+	}
+
+	AtomicStore( &giStart, 1 );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring   ڵ带  ϰ ׶ thread  Ѵ.
+ *	exec  μ üϱ  ȣϿ αװ ǵ ʵ Ѵ.
+ */
+void CLog::Stop()
+{
+	if( AtomicLoad( &giStart ) == 0 ) return;
+
+	AtomicStore( &giStart, 0 );
+	AtomicStore( &giStop, 1 );
+
+#ifdef WIN32
+	WaitForSingleObject( ghThread, INFINITE );
+	CloseHandle( ghThread );
+	ghThread = NULL;
+#else
+	pthread_join( gsttThread, NULL );
+#endif
+
+	if( gpsttFile != stdout ) fclose( gpsttFile );
+	gpsttFile = NULL;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  α  Ѵ.
+ * @param iLevel ELogLevel  bit 
+ */
+void CLog::SetLevel( int iLevel )
+{
+	m_iLevel = iLevel;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief α    ˻Ѵ.
+ * @param eLevel α 
+ * @returns  ̸ true  ϰ ׷  false  Ѵ.
+ */
+bool CLog::IsPrintLevel( ELogLevel eLevel )
+{
+	return ( m_iLevel & eLevel ) != 0;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief α ڵ带  thread  ring  Ѵ. ڿ ȯ   I/O  ׶ thread  Ѵ.
+ * @param eLevel	α 
+ * @param fmt			 ڿ 
+ */
+void CLog::Print( ELogLevel eLevel, const char * fmt, ... )
+{
+	if( ( m_iLevel & eLevel ) == 0 ) return;
+
+	va_list ap;
+	uint64_t iTime = GetTimeUs();
+
+	if( AtomicLoad( &giStart ) == 0 )
+	{
+		char szPrefix[128];
+
+		GetLinePrefix( iTime, 0, eLevel, szPrefix, sizeof(szPrefix) );
+		fputs( szPrefix, stdout );
+
+		va_start( ap, fmt );
+		vprintf( fmt, ap );
+		va_end( ap );
+
+		putchar( '\n' );
+		return;
+	}
+
+	char szRecord[LOG_MAX_RECORD_SIZE];
+	LOG_RECORD_HEADER * psttHeader = (LOG_RECORD_HEADER *)szRecord;
+	int iPos = sizeof(LOG_RECORD_HEADER);
+
+	va_start( ap, fmt );
+	PutArgList( szRecord, iPos, fmt, ap );
+	va_end( ap );
+
+	//   ǥø ϰ 8   Ѵ.
+	szRecord[iPos++] = 0;
+	iPos = ( iPos + 7 ) & ~7;
+	if( iPos > LOG_MAX_RECORD_SIZE ) iPos = LOG_MAX_RECORD_SIZE;
+
+	psttHeader->iSize = (uint16_t)iPos;
+	psttHeader->iLevel = (uint8_t)eLevel;
+	psttHeader->iTime = iTime;
+	psttHeader->pszFormat = fmt;
+
+	if( GetRing()->Write( szRecord, iPos ) == false )
+	{
+		AtomicIncrement( &giDropCount );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring     α ڵ  ´.
+ * @returns  α ڵ  Ѵ.
+ */
+uint64_t CLog::GetDropCount()
+{
+	return (uint64_t)giDropCount;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread  ring   ڵ带 ڿ ȯϿ Ͽ ϴ thread
+ * @param lpParameter  ʴ´.
+ * @returns 0  Ѵ.
+ */
+THREAD_API CLog::WriteThread( LPVOID lpParameter )
+{
+	LOG_RING_LIST clsList;
+	LOG_RING_LIST::iterator itList;
+	std::string strBuf;
+	int64_t iDropCount = 0;
+	bool bStop = false, bWrite = false;
+
+	(void)lpParameter;
+
+	strBuf.reserve( LOG_WRITE_BUF_SIZE * 2 );
+
+	while( 1 )
+	{
+		//  û Ȯ Ŀ ring  ѹ  о  ڵ带  Ѵ.
+		bStop = ( AtomicLoad( &giStop ) != 0 );
+
+		LockRingList();
+		clsList = gclsRingList;
+		UnlockRingList();
+
+		for( itList = clsList.begin(); itList != clsList.end(); ++itList )
+		{
+			//  thread  ring  ڵ带   Ŀ Ѵ.
+			bool bClosed = ( AtomicLoad( &(*itList)->m_iClosed ) != 0 );
+
+			(*itList)->Read( strBuf );
+
+			if( bClosed )
+			{
+				LockRingList();
+				gclsRingList.remove( *itList );
+				UnlockRingList();
+
+				delete *itList;
+			}
+
+			if( strBuf.length() >= LOG_WRITE_BUF_SIZE )
+			{
+				fwrite( strBuf.c_str(), 1, strBuf.length(), gpsttFile );
+				strBuf.clear();
+				bWrite = true;
+			}
+		}
+
+		if( iDropCount != giDropCount )
+		{
+			char szText[128];
+			int64_t iCount = giDropCount;
+
+			int n = GetLinePrefix( GetTimeUs(), 0, LOG_ERROR, szText, sizeof(szText) );
+			n += snprintf( szText + n, sizeof(szText) - n, LONG_LONG_FORMAT " log records are dropped\n", iCount - iDropCount );
+			strBuf.append( szText, n );
+			iDropCount = iCount;
+		}
+
+		if( strBuf.empty() == false )
+		{
+			fwrite( strBuf.c_str(), 1, strBuf.length(), gpsttFile );
+			strBuf.clear();
+			bWrite = true;
+		}
+
+		if( bWrite )
+		{
+			fflush( gpsttFile );
+			bWrite = false;
+		}
+
+		if( bStop ) break;
+
+#ifdef WIN32
+		Sleep( LOG_WRITE_PERIOD );
+#else
+		usleep( LOG_WRITE_PERIOD * 1000 );
+#endif
+	}
+
+	return 0;
+}
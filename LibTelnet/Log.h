@@ -0,0 +1,73 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include "Define.h"
+#include <stdarg.h>
+
+/**
+ * @ingroup LibTelnet
+ * @brief α 
+ */
+enum ELogLevel
+{
+	LOG_ERROR = 0x01,
+	LOG_INFO = 0x02,
+	LOG_DEBUG = 0x04,
+	LOG_NETWORK = 0x08
+};
+
+// thread  α ring ũ ( 2  ŵ )
+#define LOG_RING_SIZE				( 256 * 1024 )
+
+// ϳ α ڵ ִ ũ
+#define LOG_MAX_RECORD_SIZE	4096
+
+// α ڵ忡 ϴ ڿ  ִ 
+#define LOG_MAX_STRING_SIZE	512
+
+/**
+ * @ingroup LibTelnet
+ * @brief 񵿱 α  Ŭ
+ *	- Print  timestamp, ,  ڿ ּ(format id), ڸ binary ڵ ȣ thread  lock-free ring  Ѵ.
+ *	- ׶ thread  ֱ  ring  ڵ带 ڿ ȯϿ ѹ Ͽ Ѵ.
+ *	- ring     ʰ ڵ带 .
+ *	-  ڿ ڵ忡 ּҸ ǹǷ ڿ  Ͽ Ѵ.
+ */
+class CLog
+{
+public:
+	static bool Start( const char * pszFileName = NULL );
+	static void Stop();
+
+	static void SetLevel( int iLevel );
+	static bool IsPrintLevel( ELogLevel eLevel );
+
+	static void Print( ELogLevel eLevel, const char * fmt, ... );
+
+	static uint64_t GetDropCount();
+
+private:
+	static THREAD_API WriteThread( LPVOID lpParameter );
+
+	static int	m_iLevel;
+};
+
+#endif
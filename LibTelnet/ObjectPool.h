@@ -0,0 +1,98 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+
+#include <vector>
+
+// Ǯ ϴ ⺻ ִ ü 
+#define OBJECT_POOL_MAX_IDLE	1024
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ü ۸ ϴ ü Ǯ. ϳ thread  ؾ Ѵ.
+ *	- T  ⺻ ڿ ü ʱ ·  Clear() ޼ҵ尡 ־ Ѵ.
+ *	- ݳ ü ִ  ʰϸ ϹǷ 뷮   Ŀ ޸ 뷮 ѵȴ.
+ */
+template< class T >
+class CObjectPool
+{
+public:
+	CObjectPool( int iMaxIdleCount = OBJECT_POOL_MAX_IDLE ) : m_iMaxIdleCount(iMaxIdleCount)
+	{
+	}
+
+	~CObjectPool()
+	{
+		for( size_t i = 0; i < m_clsIdleList.size(); ++i )
+		{
+			delete m_clsIdleList[i];
+		}
+	}
+
+	/**
+	 * @ingroup LibTelnet
+	 * @brief Ǯ ü ´. Ǯ   ο ü Ѵ.
+	 * @returns ü Ѵ.
+	 */
+	T * Get()
+	{
+		if( m_clsIdleList.empty() ) return new T();
+
+		T * pclsObject = m_clsIdleList.back();
+		m_clsIdleList.pop_back();
+
+		return pclsObject;
+	}
+
+	/**
+	 * @ingroup LibTelnet
+	 * @brief ü ʱȭϿ Ǯ ݳѴ.
+	 * @param pclsObject ü
+	 */
+	void Put( T * pclsObject )
+	{
+		if( pclsObject == NULL ) return;
+
+		if( (int)m_clsIdleList.size() >= m_iMaxIdleCount )
+		{
+			delete pclsObject;
+			return;
+		}
+
+		pclsObject->Clear();
+		m_clsIdleList.push_back( pclsObject );
+	}
+
+	/**
+	 * @ingroup LibTelnet
+	 * @brief Ǯ  ü  ´.
+	 * @returns Ǯ  ü  Ѵ.
+	 */
+	int GetIdleCount()
+	{
+		return (int)m_clsIdleList.size();
+	}
+
+private:
+	std::vector< T * >	m_clsIdleList;
+	int	m_iMaxIdleCount;
+};
+
+#endif
@@ -0,0 +1,734 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "SendScheduler.h"
+#include "Log.h"
+#include <time.h>
+#include "MemoryDebug.h"
+
+#ifdef WIN32
+#define SCHED_SEND_FLAG		0
+#else
+#define SCHED_SEND_FLAG		( MSG_DONTWAIT | MSG_NOSIGNAL )
+#endif
+
+/**
+ * @ingroup LibTelnet
+ * @brief monotonic ð micro second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicUs()
+{
+#ifdef WIN32
+	return (uint64_t)GetTickCount64() * 1000;
+#else
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000000 + sttTime.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CTokenBucket::CTokenBucket() : m_iRate(0), m_iBurst(0), m_iTokens(0), m_iTimeUs(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ӵ  Ѵ.
+ * @param iRate		ʴ  ũ ( byte  ). 0 ̸  ʴ´.
+ * @param iBurst	ѹ   ִ ִ ũ. 0 ̸ 0.1     ִ ũ Ѵ.
+ */
+void CTokenBucket::Set( uint64_t iRate, uint64_t iBurst )
+{
+	if( iRate && iBurst == 0 )
+	{
+		iBurst = iRate / 10;
+		if( iBurst < SCHED_MAX_PACKET_SIZE ) iBurst = SCHED_MAX_PACKET_SIZE;
+	}
+
+	m_iRate = iRate;
+	m_iBurst = iBurst;
+	m_iTokens = (int64_t)iBurst;
+	m_iTimeUs = GetMonotonicUs();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ӵ  Ǿ ִ ˻Ѵ.
+ * @returns  ӵ  Ǿ  true  Ѵ.
+ */
+bool CTokenBucket::IsLimit()
+{
+	return ( m_iRate != 0 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ðŭ token  Ѵ.
+ * @param iTimeUs  monotonic ð ( micro second  )
+ */
+void CTokenBucket::Update( uint64_t iTimeUs )
+{
+	if( m_iRate == 0 || iTimeUs <= m_iTimeUs ) return;
+
+	//   ʾ  overflow  token   ä.
+	if( iTimeUs - m_iTimeUs > ( m_iBurst / m_iRate + 1 ) * 1000000 )
+	{
+		m_iTokens = (int64_t)m_iBurst;
+		m_iTimeUs = iTimeUs;
+		return;
+	}
+
+	m_iTokens += (int64_t)( ( iTimeUs - m_iTimeUs ) * m_iRate / 1000000 );
+	if( m_iTokens > (int64_t)m_iBurst ) m_iTokens = (int64_t)m_iBurst;
+
+	//   ð ǵ ʵ  token  شϴ ðŭ Ѵ.
+	if( m_iTokens == (int64_t)m_iBurst )
+	{
+		m_iTimeUs = iTimeUs;
+	}
+	else
+	{
+		m_iTimeUs += ( iTimeUs - m_iTimeUs ) * m_iRate / 1000000 * 1000000 / m_iRate;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ִ ˻Ѵ.
+ * @returns token   ְų   true  Ѵ.
+ */
+bool CTokenBucket::IsAvailable()
+{
+	return ( m_iRate == 0 || m_iTokens > 0 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ũ⸸ŭ token  Ѵ.
+ * @param iLen  ũ
+ */
+void CTokenBucket::Consume( int iLen )
+{
+	if( m_iRate ) m_iTokens -= iLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief token     ð ´.
+ * @returns  ð ( micro second  )  Ѵ.
+ */
+uint64_t CTokenBucket::GetWaitUs()
+{
+	if( IsAvailable() ) return 0;
+
+	return ( (uint64_t)( 1 - m_iTokens ) * 1000000 + m_iRate - 1 ) / m_iRate;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CSendChannel::CSendChannel() : m_iSessionId(-1), m_iChannel(0), m_iDeficit(0), m_bActive(false), m_bServing(false)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CSendSession::CSendSession() : m_hSocket(INVALID_SOCKET), m_iWeight(1), m_bBlocked(false), m_iQueueSize(0), m_pclsIpBucket(NULL)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CSendScheduler::CSendScheduler() : m_iTimeUs(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ӵ    д´.  ߰ϱ  ȣؾ Ѵ.
+ *	    Ʒ . ӵ ʴ byte ̰ burst  ϸ 0.1     ִ ũ⸦ Ѵ.
+ *	- link {ӵ} [burst]
+ *	- ip {IP ּ Ǵ *} {ӵ} [burst]
+ *	Ǻ α  Ƿ user   ʴ´.
+ * @param pszFileName   
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CSendScheduler::LoadConfig( const char * pszFileName )
+{
+	FILE * fd = fopen( pszFileName, "r" );
+	if( fd == NULL ) return false;
+
+	char szLine[1024], szType[21], szName[256];
+	unsigned long long iRate, iBurst;
+	int iLine = 0, n;
+	bool bRes = true;
+
+	while( fgets( szLine, sizeof(szLine), fd ) )
+	{
+		++iLine;
+
+		if( szLine[0] == '#' || szLine[0] == '\r' || szLine[0] == '\n' ) continue;
+
+		iBurst = 0;
+
+		if( sscanf( szLine, "%20s", szType ) != 1 ) continue;
+
+		if( !strcmp( szType, "link" ) )
+		{
+			n = sscanf( szLine, "%*s %llu %llu", &iRate, &iBurst );
+			if( n >= 1 )
+			{
+				SetLinkLimit( iRate, iBurst );
+				continue;
+			}
+		}
+		else if( !strcmp( szType, "ip" ) )
+		{
+			n = sscanf( szLine, "%*s %255s %llu %llu", szName, &iRate, &iBurst );
+			if( n >= 2 )
+			{
+				SetIpLimit( szName, iRate, iBurst );
+				continue;
+			}
+		}
+		else if( !strcmp( szType, "user" ) )
+		{
+			CLog::Print( LOG_ERROR, "%s(%s) line(%d) per-user limit is not supported - all shells run as the server account, use ip limits", __FUNCTION__, pszFileName, iLine );
+			bRes = false;
+			continue;
+		}
+
+		CLog::Print( LOG_ERROR, "%s(%s) line(%d) is not valid", __FUNCTION__, pszFileName, iLine );
+		bRes = false;
+	}
+
+	fclose( fd );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ü ۽ ӵ  Ѵ. ũ ӵ  ۰ ϸ Ŷ NIC ť ƴ ٷ ϹǷ ٸ ȴ.
+ * @param iRate		ʴ  ũ ( byte  ). 0 ̸  ʴ´.
+ * @param iBurst	ѹ   ִ ִ ũ
+ */
+void CSendScheduler::SetLinkLimit( uint64_t iRate, uint64_t iBurst )
+{
+	m_clsLinkBucket.Set( iRate, iBurst );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  IP  ۽ ӵ  Ѵ.  IP    ϳ token bucket  Ѵ.
+ * @param pszIp		IP ּ. "*" ̸    IP  Ѵ.
+ * @param iRate		ʴ  ũ ( byte  ). 0 ̸  ʴ´.
+ * @param iBurst	ѹ   ִ ִ ũ
+ */
+void CSendScheduler::SetIpLimit( const char * pszIp, uint64_t iRate, uint64_t iBurst )
+{
+	if( !strcmp( pszIp, "*" ) )
+	{
+		m_clsDefaultIpBucket.Set( iRate, iBurst );
+	}
+	else
+	{
+		m_clsIpBucketMap[pszIp].Set( iRate, iBurst );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ߰Ѵ.
+ * @param iSessionId	 ̵
+ * @param hSocket			 
+ * @param pszIp				  IP ּ
+ * @param iWeight			deficit round-robin ġ
+ * @returns ϸ true  ϰ ̹ ϴ ̸ false  Ѵ.
+ */
+bool CSendScheduler::AddSession( int iSessionId, Socket hSocket, const char * pszIp, int iWeight )
+{
+	if( m_clsSessionMap.find( iSessionId ) != m_clsSessionMap.end() ) return false;
+
+	CSendSession & clsSession = m_clsSessionMap[iSessionId];
+
+	clsSession.m_hSocket = hSocket;
+	clsSession.m_iWeight = iWeight > 0 ? iWeight : 1;
+	clsSession.m_pclsIpBucket = GetBucket( m_clsIpBucketMap, m_clsDefaultIpBucket, pszIp );
+
+#ifdef WIN32
+	unsigned long iNonBlock = 1;
+	ioctlsocket( hSocket, FIONBIO, &iNonBlock );
+#endif
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ǰ    Ŷ Ѵ.   ʴ´.
+ * @param iSessionId  ̵
+ */
+void CSendScheduler::DeleteSession( int iSessionId )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return;
+
+	for( std::list< CSendPriorityPacket >::iterator itList = m_clsPriorityList.begin(); itList != m_clsPriorityList.end(); )
+	{
+		if( itList->m_iSessionId == iSessionId )
+		{
+			itList = m_clsPriorityList.erase( itList );
+		}
+		else
+		{
+			++itList;
+		}
+	}
+
+	for( std::list< CSendChannel * >::iterator itList = m_clsActiveList.begin(); itList != m_clsActiveList.end(); )
+	{
+		if( (*itList)->m_iSessionId == iSessionId )
+		{
+			itList = m_clsActiveList.erase( itList );
+		}
+		else
+		{
+			++itList;
+		}
+	}
+
+	m_clsSessionMap.erase( itSession );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ä ͸  ť Ѵ.   Run  Ѵ.
+ *	ä ť  ְ SCHED_INTERACTIVE_SIZE  ʹ äκ SCHED_INTERACTIVE_RATE  interactive ť Ѵ.
+ *	äο   Ͱ  ä    ϱ Ͽ ä ť Ѵ.
+ * @param iSessionId	 ̵
+ * @param iChannel		ä ȣ
+ * @param pszData			 
+ * @param iLen				  
+ * @returns ϸ true  ϰ    false  Ѵ.
+ */
+bool CSendScheduler::Send( int iSessionId, int iChannel, const char * pszData, int iLen )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() || iLen <= 0 ) return false;
+
+	CSendChannel & clsChannel = itSession->second.m_clsChannelMap[iChannel];
+
+	itSession->second.m_iQueueSize += iLen;
+
+	if( clsChannel.m_iSessionId == -1 )
+	{
+		clsChannel.m_iSessionId = iSessionId;
+		clsChannel.m_iChannel = iChannel;
+		clsChannel.m_clsInteractiveBucket.Set( SCHED_INTERACTIVE_RATE, SCHED_INTERACTIVE_RATE / 4 );
+	}
+
+	if( iLen <= SCHED_INTERACTIVE_SIZE && clsChannel.m_clsQueue.empty() )
+	{
+		clsChannel.m_clsInteractiveBucket.Update( GetMonotonicUs() );
+	}
+
+	if( iLen <= SCHED_INTERACTIVE_SIZE && clsChannel.m_clsQueue.empty() && clsChannel.m_clsInteractiveBucket.IsAvailable() )
+	{
+		clsChannel.m_clsInteractiveBucket.Consume( iLen );
+		m_clsPriorityList.push_back( CSendPriorityPacket() );
+		m_clsPriorityList.back().m_iSessionId = iSessionId;
+		m_clsPriorityList.back().m_strData.assign( pszData, iLen );
+		return true;
+	}
+
+	for( int iPos = 0; iPos < iLen; iPos += SCHED_MAX_PACKET_SIZE )
+	{
+		int n = iLen - iPos;
+		if( n > SCHED_MAX_PACKET_SIZE ) n = SCHED_MAX_PACKET_SIZE;
+
+		clsChannel.m_clsQueue.push_back( std::string( pszData + iPos, n ) );
+	}
+
+	if( clsChannel.m_bActive == false )
+	{
+		clsChannel.m_bActive = true;
+		clsChannel.m_bServing = false;
+		clsChannel.m_iDeficit = 0;
+		m_clsActiveList.push_back( &clsChannel );
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief interactive ť  ϰ ä ť deficit round-robin  Ѵ.
+ *	reactor thread  poll  ϵ  ȣϰ ϵ ð poll timeout  Ѵ.
+ * @returns token  Ǳ⸦ ٸ Ŷ   ð ( milli second  )  ϰ ׷  -1  Ѵ.
+ */
+int CSendScheduler::Run()
+{
+	uint64_t iWaitUs = 0;
+	std::list< CSendPriorityPacket >::iterator itPriority;
+	SEND_SESSION_MAP::iterator itSession;
+
+	m_iTimeUs = GetMonotonicUs();
+
+	m_clsLinkBucket.Update( m_iTimeUs );
+
+	// interactive Ŷ token  Ͽ ϰ token  Ѵ.
+	for( itPriority = m_clsPriorityList.begin(); itPriority != m_clsPriorityList.end(); )
+	{
+		itSession = m_clsSessionMap.find( itPriority->m_iSessionId );
+		if( itSession == m_clsSessionMap.end() )
+		{
+			itPriority = m_clsPriorityList.erase( itPriority );
+			continue;
+		}
+
+		CSendSession & clsSession = itSession->second;
+
+		if( clsSession.m_bBlocked || Transmit( clsSession, itPriority->m_strData ) == false )
+		{
+			++itPriority;
+			continue;
+		}
+
+		Consume( clsSession, (int)itPriority->m_strData.length() );
+		itPriority = m_clsPriorityList.erase( itPriority );
+	}
+
+	//  ä token Ǵ      ϸ Ѵ.
+	int iIdleCount = 0;
+
+	while( m_clsActiveList.empty() == false && iIdleCount < (int)m_clsActiveList.size() )
+	{
+		if( m_clsLinkBucket.IsAvailable() == false )
+		{
+			iWaitUs = m_clsLinkBucket.GetWaitUs();
+			break;
+		}
+
+		CSendChannel * pclsChannel = m_clsActiveList.front();
+		CSendSession & clsSession = m_clsSessionMap[pclsChannel->m_iSessionId];
+		bool bSend = false, bDeficit = false;
+
+		if( pclsChannel->m_bServing == false )
+		{
+			pclsChannel->m_bServing = true;
+			pclsChannel->m_iDeficit += SCHED_QUANTUM * clsSession.m_iWeight;
+		}
+
+		while( pclsChannel->m_clsQueue.empty() == false )
+		{
+			std::string & strData = pclsChannel->m_clsQueue.front();
+			int iLen = (int)strData.length();
+
+			if( iLen > pclsChannel->m_iDeficit )
+			{
+				bDeficit = true;
+				break;
+			}
+
+			if( clsSession.m_bBlocked || m_clsLinkBucket.IsAvailable() == false ) break;
+
+			if( IsAvailable( clsSession ) == false )
+			{
+				UpdateWait( clsSession, iWaitUs );
+				break;
+			}
+
+			if( Transmit( clsSession, strData ) == false ) break;
+
+			pclsChannel->m_iDeficit -= iLen;
+			Consume( clsSession, iLen );
+			pclsChannel->m_clsQueue.pop_front();
+			bSend = true;
+		}
+
+		if( m_clsLinkBucket.IsAvailable() == false && pclsChannel->m_clsQueue.empty() == false )
+		{
+			// ũ token  Ͽ ߴܵǾ deficit   ä  Run   Ѵ.
+			iWaitUs = m_clsLinkBucket.GetWaitUs();
+			break;
+		}
+
+		m_clsActiveList.pop_front();
+		pclsChannel->m_bServing = false;
+
+		if( pclsChannel->m_clsQueue.empty() )
+		{
+			pclsChannel->m_bActive = false;
+			pclsChannel->m_iDeficit = 0;
+		}
+		else
+		{
+			//    ä deficit   Ͽ ߿ Ѳ  ʵ Ѵ.
+			if( bDeficit == false && pclsChannel->m_iDeficit > SCHED_MAX_PACKET_SIZE ) pclsChannel->m_iDeficit = SCHED_MAX_PACKET_SIZE;
+
+			m_clsActiveList.push_back( pclsChannel );
+		}
+
+		// deficit   ä     Ƿ  ·  ʴ´.
+		iIdleCount = ( bSend || bDeficit ) ? 0 : iIdleCount + 1;
+	}
+
+	if( iWaitUs == 0 ) return -1;
+
+	return (int)( ( iWaitUs + 999 ) / 1000 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ä ť   ũ⸦ ´. relay     ũ ̸̻ PTY б⸦ Ͽ ť   ʵ Ѵ.
+ * @param iSessionId	 ̵
+ * @param iChannel		ä ȣ
+ * @returns ä ť   ũ⸦ Ѵ.
+ */
+int CSendScheduler::GetQueueSize( int iSessionId, int iChannel )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return 0;
+
+	SEND_CHANNEL_MAP::iterator itChannel = itSession->second.m_clsChannelMap.find( iChannel );
+	if( itChannel == itSession->second.m_clsChannelMap.end() ) return 0;
+
+	std::list< std::string >::iterator itList;
+	int iSize = 0;
+
+	for( itList = itChannel->second.m_clsQueue.begin(); itList != itChannel->second.m_clsQueue.end(); ++itList )
+	{
+		iSize += (int)itList->length();
+	}
+
+	return iSize;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ť Ϻθ ۵ Ŷ   ũ⸦ ´. relay    0  Ǹ   Ϸ  ǴѴ.
+ * @param iSessionId  ̵
+ * @returns     ũ⸦ Ѵ.
+ */
+int CSendScheduler::GetSessionQueueSize( int iSessionId )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return 0;
+
+	return itSession->second.m_iQueueSize;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ǿ    ͸   ´.  ׷̵ ο μ ϴ  Ѵ.
+ *	- Ϻθ ۵ Ŷ, interactive Ŷ, ä ť  ۵ǹǷ ϳ äθ ϴ    ȴ.
+ * @param iSessionId	 ̵
+ * @param strData			  ͸  
+ */
+void CSendScheduler::GetUnsent( int iSessionId, std::string & strData )
+{
+	strData.clear();
+
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return;
+
+	CSendSession & clsSession = itSession->second;
+
+	strData.reserve( clsSession.m_iQueueSize );
+	strData.append( clsSession.m_strPending );
+
+	for( std::list< CSendPriorityPacket >::iterator itList = m_clsPriorityList.begin(); itList != m_clsPriorityList.end(); ++itList )
+	{
+		if( itList->m_iSessionId == iSessionId ) strData.append( itList->m_strData );
+	}
+
+	for( SEND_CHANNEL_MAP::iterator itChannel = clsSession.m_clsChannelMap.begin(); itChannel != clsSession.m_clsChannelMap.end(); ++itChannel )
+	{
+		for( std::list< std::string >::iterator itQueue = itChannel->second.m_clsQueue.begin(); itQueue != itChannel->second.m_clsQueue.end(); ++itQueue )
+		{
+			strData.append( *itQueue );
+		}
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief    ۰   POLLOUT ̺Ʈ ٷ ϴ ˻Ѵ.
+ * @param iSessionId  ̵
+ * @returns POLLOUT ̺Ʈ ٷ ϸ true  Ѵ.
+ */
+bool CSendScheduler::IsBlocked( int iSessionId )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return false;
+
+	return itSession->second.m_bBlocked;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Ͽ POLLOUT ̺Ʈ ߻ϸ ȣѴ.
+ * @param iSessionId  ̵
+ */
+void CSendScheduler::SetWritable( int iSessionId )
+{
+	SEND_SESSION_MAP::iterator itSession = m_clsSessionMap.find( iSessionId );
+	if( itSession == m_clsSessionMap.end() ) return;
+
+	itSession->second.m_bBlocked = false;
+	SendPending( itSession->second );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief IP ּ Ǵ  ̵ شϴ token bucket  ´.
+ * @param clsMap			token bucket ڷᱸ
+ * @param clsDefault	"*" 
+ * @param pszKey			IP ּ Ǵ  ̵
+ * @returns  ӵ   token bucket  ϰ ׷  NULL  Ѵ.
+ */
+CTokenBucket * CSendScheduler::GetBucket( TOKEN_BUCKET_MAP & clsMap, CTokenBucket & clsDefault, const char * pszKey )
+{
+	if( pszKey == NULL ) return NULL;
+
+	TOKEN_BUCKET_MAP::iterator itMap = clsMap.find( pszKey );
+	if( itMap != clsMap.end() )
+	{
+		return itMap->second.IsLimit() ? &itMap->second : NULL;
+	}
+
+	if( clsDefault.IsLimit() == false ) return NULL;
+
+	// "*"  IP ּ / ڸ  token bucket  Ѵ.
+	CTokenBucket & clsBucket = clsMap[pszKey];
+	clsBucket.Set( clsDefault.m_iRate, clsDefault.m_iBurst );
+
+	return &clsBucket;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  IP token bucket  token   ִ ˻Ѵ.
+ * @param clsSession 
+ * @returns    true  Ѵ.
+ */
+bool CSendScheduler::IsAvailable( CSendSession & clsSession )
+{
+	if( clsSession.m_pclsIpBucket )
+	{
+		clsSession.m_pclsIpBucket->Update( m_iTimeUs );
+		if( clsSession.m_pclsIpBucket->IsAvailable() == false ) return false;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ũ⸸ŭ ũ, IP token  Ѵ.
+ * @param clsSession	
+ * @param iLen				 ũ
+ */
+void CSendScheduler::Consume( CSendSession & clsSession, int iLen )
+{
+	m_clsLinkBucket.Consume( iLen );
+	if( clsSession.m_pclsIpBucket ) clsSession.m_pclsIpBucket->Consume( iLen );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  token     ð ߿ ּҰ Ѵ.
+ * @param clsSession	
+ * @param iWaitUs			 ð ( micro second  )
+ */
+void CSendScheduler::UpdateWait( CSendSession & clsSession, uint64_t & iWaitUs )
+{
+	uint64_t iSessionWaitUs = 0, iTemp;
+
+	if( clsSession.m_pclsIpBucket && ( iTemp = clsSession.m_pclsIpBucket->GetWaitUs() ) > iSessionWaitUs ) iSessionWaitUs = iTemp;
+
+	if( iSessionWaitUs && ( iWaitUs == 0 || iSessionWaitUs < iWaitUs ) ) iWaitUs = iSessionWaitUs;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ŷ non-blocking  Ѵ. Ϻθ ۵Ǹ  ͸ ǿ ϰ POLLOUT ̺Ʈ Ŀ Ѵ.
+ * @param clsSession	
+ * @param strData			Ŷ
+ * @returns Ŷ Ͽų ǿ Ͽ true  ϰ  Ŷ ۵ ʾƼ    false  Ѵ.
+ */
+bool CSendScheduler::Transmit( CSendSession & clsSession, const std::string & strData )
+{
+	int iLen = (int)strData.length(), iSentLen = 0, n;
+
+	if( SendPending( clsSession ) == false ) return false;
+
+	while( iSentLen < iLen )
+	{
+		n = send( clsSession.m_hSocket, strData.c_str() + iSentLen, iLen - iSentLen, SCHED_SEND_FLAG );
+		if( n <= 0 )
+		{
+			//    ο Ͽ DeleteSession  ȣѴ.
+			clsSession.m_strPending.assign( strData, iSentLen, std::string::npos );
+			clsSession.m_bBlocked = true;
+			break;
+		}
+
+		iSentLen += n;
+		clsSession.m_iQueueSize -= n;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ϻθ ۵ Ŷ  ͸ Ѵ.
+ * @param clsSession 
+ * @returns  ͸  Ͽ true  ϰ ׷  false  Ѵ.
+ */
+bool CSendScheduler::SendPending( CSendSession & clsSession )
+{
+	while( clsSession.m_strPending.empty() == false )
+	{
+		int n = send( clsSession.m_hSocket, clsSession.m_strPending.c_str(), (int)clsSession.m_strPending.length(), SCHED_SEND_FLAG );
+		if( n <= 0 )
+		{
+			clsSession.m_bBlocked = true;
+			return false;
+		}
+
+		clsSession.m_strPending.erase( 0, n );
+		clsSession.m_iQueueSize -= n;
+	}
+
+	return true;
+}
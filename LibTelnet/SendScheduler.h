@@ -0,0 +1,196 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _SEND_SCHEDULER_H_
+#define _SEND_SCHEDULER_H_
+
+#include "Define.h"
+#include "Tcp.h"
+#include <string>
+#include <list>
+#include <map>
+
+//  ũ  Ŷ interactive Ʈ Ͽ 켱 Ѵ.
+#define SCHED_INTERACTIVE_SIZE	256
+
+// äκ interactive 켱  ִ ӵ ( ʴ byte ).  Ŷ  ϴ ä ٸ ä  ʵ Ѵ.
+#define SCHED_INTERACTIVE_RATE	( 64 * 1024 )
+
+// deficit round-robin  weight 1  ä ѹ   ִ ũ
+#define SCHED_QUANTUM						1500
+
+// ť ϴ Ŷ ִ ũ. ū ʹ  Ͽ interactive Ŷ   ʵ Ѵ.
+#define SCHED_MAX_PACKET_SIZE		16384
+
+/**
+ * @ingroup LibTelnet
+ * @brief token bucket  ӵ 
+ *	- token    Ŷ ũ⸸ŭ token  Ͽ  ϰ token   .
+ */
+class CTokenBucket
+{
+public:
+	CTokenBucket();
+
+	void Set( uint64_t iRate, uint64_t iBurst );
+	bool IsLimit();
+
+	void Update( uint64_t iTimeUs );
+	bool IsAvailable();
+	void Consume( int iLen );
+	uint64_t GetWaitUs();
+
+	/** ʴ  ũ ( byte  ). 0 ̸  ʴ´. */
+	uint64_t	m_iRate;
+
+	/** ѹ   ִ ִ ũ */
+	uint64_t	m_iBurst;
+
+	int64_t		m_iTokens;
+	uint64_t	m_iTimeUs;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ä  ť. deficit round-robin  flow ̴.
+ */
+class CSendChannel
+{
+public:
+	CSendChannel();
+
+	int	m_iSessionId;
+	int	m_iChannel;
+
+	/** deficit round-robin  ̹    ִ ũ */
+	int	m_iDeficit;
+
+	/** active Ͽ ԵǾ  true ̴. */
+	bool	m_bActive;
+
+	/** active   տ  ̸ true ̴. */
+	bool	m_bServing;
+
+	/** interactive 켱  ӵ  */
+	CTokenBucket	m_clsInteractiveBucket;
+
+	std::list< std::string > m_clsQueue;
+};
+
+typedef std::map< int, CSendChannel > SEND_CHANNEL_MAP;
+
+/**
+ * @ingroup LibTelnet
+ * @brief ٷ ϵ 
+ */
+class CSendSession
+{
+public:
+	CSendSession();
+
+	Socket	m_hSocket;
+
+	/** deficit round-robin ġ */
+	int	m_iWeight;
+
+	/**   ۰      true ̴. */
+	bool	m_bBlocked;
+
+	/** Ϻθ ۵ Ŷ  . ٸ Ŷ  Ѵ. */
+	std::string	m_strPending;
+
+	/**    ü ũ. interactive ť, ä ť, m_strPending  Ѵ. */
+	int	m_iQueueSize;
+
+	/**   IP  token bucket */
+	CTokenBucket * m_pclsIpBucket;
+
+	SEND_CHANNEL_MAP	m_clsChannelMap;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief interactive 켱  ť  Ŷ
+ */
+class CSendPriorityPacket
+{
+public:
+	int	m_iSessionId;
+	std::string	m_strData;
+};
+
+typedef std::map< int, CSendSession > SEND_SESSION_MAP;
+typedef std::map< std::string, CTokenBucket > TOKEN_BUCKET_MAP;
+
+/**
+ * @ingroup LibTelnet
+ * @brief /ä  ۽ 뿪 ϰ йϴ ٷ. reactor thread ϳ Ѵ.
+ *	- ä ť    ϴ  Ŷ interactive Ŷ strict priority  Ѵ.
+ *	-  Ŷ äκ ť ϰ  ġ  deficit round-robin  Ѵ.
+ *	- ü ũ,  IP  token bucket   ӵ Ѵ.
+ *	-  shell     ǰ Ǻ α  Ƿ ں   ʴ´.
+ *	-  non-blocking  ϸ  ۰    POLLOUT ̺Ʈ   SetWritable  ȣؾ Ѵ.
+ */
+class CSendScheduler
+{
+public:
+	CSendScheduler();
+
+	bool LoadConfig( const char * pszFileName );
+	void SetLinkLimit( uint64_t iRate, uint64_t iBurst );
+	void SetIpLimit( const char * pszIp, uint64_t iRate, uint64_t iBurst );
+
+	bool AddSession( int iSessionId, Socket hSocket, const char * pszIp, int iWeight = 1 );
+	void DeleteSession( int iSessionId );
+
+	bool Send( int iSessionId, int iChannel, const char * pszData, int iLen );
+	int Run();
+
+	int GetQueueSize( int iSessionId, int iChannel );
+	int GetSessionQueueSize( int iSessionId );
+	void GetUnsent( int iSessionId, std::string & strData );
+
+	bool IsBlocked( int iSessionId );
+	void SetWritable( int iSessionId );
+
+private:
+	CTokenBucket * GetBucket( TOKEN_BUCKET_MAP & clsMap, CTokenBucket & clsDefault, const char * pszKey );
+	bool IsAvailable( CSendSession & clsSession );
+	void Consume( CSendSession & clsSession, int iLen );
+	void UpdateWait( CSendSession & clsSession, uint64_t & iWaitUs );
+	bool Transmit( CSendSession & clsSession, const std::string & strData );
+	bool SendPending( CSendSession & clsSession );
+
+	SEND_SESSION_MAP	m_clsSessionMap;
+
+	/** interactive Ŷ ť */
+	std::list< CSendPriorityPacket > m_clsPriorityList;
+
+	/**  Ŷ ִ ä  */
+	std::list< CSendChannel * > m_clsActiveList;
+
+	CTokenBucket	m_clsLinkBucket;
+
+	/**  IP  token bucket.  Ͽ  IP  "*"  Ѵ. */
+	TOKEN_BUCKET_MAP	m_clsIpBucketMap;
+	CTokenBucket	m_clsDefaultIpBucket;
+
+	uint64_t	m_iTimeUs;
+};
+
+#endif
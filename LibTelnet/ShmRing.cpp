@@ -0,0 +1,468 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "ShmRing.h"
+
+#ifndef WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include "Handover.h"
+#include "MemoryDebug.h"
+
+//    ġ.  ù° page  ȴ.
+#define SHM_RING_DATA_OFFSET	4096
+
+//   ޸ ũ⸦ Ͽ mmap     SIGBUS  ߻ ʵ ϴ seal
+#define SHM_RING_SEALS	( F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL )
+
+#define AtomicLoad(p)		__atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define AtomicStore(p,v)	__atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CShmRing::CShmRing() : m_psttHeader(NULL), m_pszData(NULL), m_iMapSize(0), m_iSize(0), m_iMemFd(-1), m_iDataFd(-1), m_iSpaceFd(-1)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CShmRing::~CShmRing()
+{
+	Close();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ޸ ring  Ѵ.
+ * @param iSize   ũ. 2  ŵ øȴ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmRing::Create( uint32_t iSize )
+{
+	uint32_t iRingSize = 4096;
+	int iMemFd, iDataFd = -1, iSpaceFd = -1;
+
+	while( iRingSize < iSize ) iRingSize <<= 1;
+
+	iMemFd = memfd_create( "telnet-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+	if( iMemFd == -1 ) return false;
+
+	if( ftruncate( iMemFd, SHM_RING_DATA_OFFSET + iRingSize ) == -1 ) goto FUNC_ERROR;
+	if( fcntl( iMemFd, F_ADD_SEALS, SHM_RING_SEALS ) == -1 ) goto FUNC_ERROR;
+
+	iDataFd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+	iSpaceFd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+	if( iDataFd == -1 || iSpaceFd == -1 ) goto FUNC_ERROR;
+
+	if( Attach( iMemFd, iDataFd, iSpaceFd ) == false ) return false;
+
+	m_psttHeader->iSize = iRingSize;
+
+	return true;
+
+FUNC_ERROR:
+	close( iMemFd );
+	if( iDataFd != -1 ) close( iDataFd );
+	if( iSpaceFd != -1 ) close( iSpaceFd );
+
+	return false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ޸𸮿 eventfd  Ѵ. /п  Էµ file descriptor   ü Ѵ.
+ * @param iMemFd		 ޸ memfd
+ * @param iDataFd		 ˸ eventfd
+ * @param iSpaceFd	  ˸ eventfd
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmRing::Attach( int iMemFd, int iDataFd, int iSpaceFd )
+{
+	struct stat sttStat;
+	void * pMap;
+
+	Close();
+
+	m_iMemFd = iMemFd;
+	m_iDataFd = iDataFd;
+	m_iSpaceFd = iSpaceFd;
+
+	// ũⰡ    ޸𸮴  ũ⸦   ִ.
+	if( fstat( iMemFd, &sttStat ) == -1 || sttStat.st_size <= SHM_RING_DATA_OFFSET || sttStat.st_size - SHM_RING_DATA_OFFSET > 0x80000000LL ||
+			( fcntl( iMemFd, F_GET_SEALS ) & SHM_RING_SEALS ) != SHM_RING_SEALS )
+	{
+		Close();
+		return false;
+	}
+
+	uint32_t iSize = (uint32_t)( sttStat.st_size - SHM_RING_DATA_OFFSET );
+
+	if( iSize & ( iSize - 1 ) )
+	{
+		Close();
+		return false;
+	}
+
+	pMap = mmap( NULL, sttStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, iMemFd, 0 );
+	if( pMap == MAP_FAILED )
+	{
+		Close();
+		return false;
+	}
+
+	m_iMapSize = sttStat.st_size;
+	m_psttHeader = (SHM_RING_HEADER *)pMap;
+	m_pszData = (char *)pMap + SHM_RING_DATA_OFFSET;
+
+	if( m_psttHeader->iSize && m_psttHeader->iSize != iSize )
+	{
+		Close();
+		return false;
+	}
+
+	m_iSize = iSize;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 濡 Ḧ ˸  ޸𸮿 eventfd  Ѵ.
+ */
+void CShmRing::Close()
+{
+	uint64_t iValue = 1;
+
+	if( m_psttHeader )
+	{
+		AtomicStore( &m_psttHeader->iClosed, 1 );
+
+		if( write( m_iDataFd, &iValue, sizeof(iValue) ) != sizeof(iValue) || write( m_iSpaceFd, &iValue, sizeof(iValue) ) != sizeof(iValue) )
+		{
+			//  ̹ ̺Ʈ ޾Ҵ.
+		}
+
+		munmap( m_psttHeader, m_iMapSize );
+		m_psttHeader = NULL;
+		m_pszData = NULL;
+		m_iMapSize = 0;
+		m_iSize = 0;
+	}
+
+	if( m_iMemFd != -1 )
+	{
+		close( m_iMemFd );
+		m_iMemFd = -1;
+	}
+
+	if( m_iDataFd != -1 )
+	{
+		close( m_iDataFd );
+		m_iDataFd = -1;
+	}
+
+	if( m_iSpaceFd != -1 )
+	{
+		close( m_iSpaceFd );
+		m_iSpaceFd = -1;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ޸𸮿 eventfd  Unix   濡 Ѵ.
+ * @param hUnix Unix   ڵ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmRing::Export( Socket hUnix )
+{
+	int arrFd[3] = { m_iMemFd, m_iDataFd, m_iSpaceFd };
+
+	if( m_psttHeader == NULL ) return false;
+
+	return SendFd( hUnix, arrFd, 3, "R", 1 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Export    ޸ ring  Ѵ.
+ * @param hUnix		Unix   ڵ
+ * @param iSecond	 timeout (   )
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmRing::Import( Socket hUnix, int iSecond )
+{
+	int arrFd[3], iFdCount;
+	char szType[1];
+
+	if( RecvFd( hUnix, arrFd, 3, &iFdCount, szType, sizeof(szType), iSecond ) != 1 ) return false;
+
+	if( iFdCount != 3 || szType[0] != 'R' )
+	{
+		for( int i = 0; i < iFdCount; ++i ) close( arrFd[i] );
+		return false;
+	}
+
+	return Attach( arrFd[0], arrFd[1], arrFd[2] );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring  ͸  Ѵ. ring    consumer    Ѵ.
+ * @param pszBuf	 
+ * @param iLen		  ũ
+ * @param iSecond	   timeout (   )
+ * @returns ϸ iLen  ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int CShmRing::Write( const char * pszBuf, int iLen, int iSecond )
+{
+	uint32_t iHead, iFree, iPos, iFirst, n;
+	int iSendLen = 0;
+
+	if( m_psttHeader == NULL ) return SOCKET_ERROR;
+
+	const uint32_t iSize = m_iSize;
+
+	while( iSendLen < iLen )
+	{
+		if( AtomicLoad( &m_psttHeader->iClosed ) ) return SOCKET_ERROR;
+
+		iHead = m_psttHeader->iHead;
+		iFree = iSize - ( iHead - AtomicLoad( &m_psttHeader->iTail ) );
+
+		//  tail  ߸ Ͽ.
+		if( iFree > iSize ) return SOCKET_ERROR;
+
+		if( iFree == 0 )
+		{
+			if( Wait( &m_psttHeader->iProducerWait, m_iSpaceFd, iSecond, true ) == false ) return SOCKET_ERROR;
+			continue;
+		}
+
+		n = iLen - iSendLen;
+		if( n > iFree ) n = iFree;
+
+		iPos = iHead & ( iSize - 1 );
+		iFirst = iSize - iPos;
+		if( iFirst > n ) iFirst = n;
+
+		memcpy( m_pszData + iPos, pszBuf + iSendLen, iFirst );
+		memcpy( m_pszData, pszBuf + iSendLen + iFirst, n - iFirst );
+
+		AtomicStore( &m_psttHeader->iHead, iHead + n );
+		Notify( &m_psttHeader->iConsumerWait, m_iDataFd );
+
+		iSendLen += n;
+	}
+
+	return iLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ring  ͸ д´. ring    producer    Ѵ.
+ * @param pszBuf		 
+ * @param iBufSize	  ũ
+ * @param iSecond		  timeout (   )
+ * @returns ϸ  ũ⸦ ϰ timeout ǰų  Ͽ SOCKET_ERROR  Ѵ.
+ */
+int CShmRing::Read( char * pszBuf, int iBufSize, int iSecond )
+{
+	uint32_t iTail, iUsed, iPos, iFirst, n;
+
+	if( m_psttHeader == NULL || iBufSize <= 0 ) return SOCKET_ERROR;
+
+	const uint32_t iSize = m_iSize;
+
+	while( 1 )
+	{
+		iTail = m_psttHeader->iTail;
+		iUsed = AtomicLoad( &m_psttHeader->iHead ) - iTail;
+
+		//  head  ߸ Ͽ.
+		if( iUsed > iSize ) return SOCKET_ERROR;
+		if( iUsed > 0 ) break;
+
+		if( AtomicLoad( &m_psttHeader->iClosed ) ) return SOCKET_ERROR;
+		if( Wait( &m_psttHeader->iConsumerWait, m_iDataFd, iSecond, false ) == false ) return SOCKET_ERROR;
+	}
+
+	n = (uint32_t)iBufSize;
+	if( n > iUsed ) n = iUsed;
+
+	iPos = iTail & ( iSize - 1 );
+	iFirst = iSize - iPos;
+	if( iFirst > n ) iFirst = n;
+
+	memcpy( pszBuf, m_pszData + iPos, iFirst );
+	memcpy( pszBuf + iFirst, m_pszData, n - iFirst );
+
+	AtomicStore( &m_psttHeader->iTail, iTail + n );
+	Notify( &m_psttHeader->iProducerWait, m_iSpaceFd );
+
+	return (int)n;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ¸  , eventfd ̺Ʈ ٸ.
+ *	-  ¸  Ŀ ring  ٽ ˻ϹǷ  ˸ ġ ʴ´.
+ * @param piWait		  
+ * @param iEventFd	 eventfd
+ * @param iSecond		 timeout (   )
+ * @param bProducer	producer ̸ true  ԷѴ.
+ * @returns timeout  ߻ϸ false  ϰ ׷  true  Ѵ.
+ */
+bool CShmRing::Wait( volatile uint32_t * piWait, int iEventFd, int iSecond, bool bProducer )
+{
+	uint32_t iUsed;
+	bool bRes = true;
+
+	AtomicStore( piWait, 1 );
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+
+	iUsed = AtomicLoad( &m_psttHeader->iHead ) - AtomicLoad( &m_psttHeader->iTail );
+
+	if( ( bProducer ? ( iUsed == m_iSize ) : ( iUsed == 0 ) ) && AtomicLoad( &m_psttHeader->iClosed ) == 0 )
+	{
+		pollfd sttPoll[1];
+		uint64_t iValue;
+
+		TcpSetPollIn( sttPoll[0], iEventFd );
+
+		if( poll( sttPoll, 1, 1000 * iSecond ) <= 0 )
+		{
+			bRes = false;
+		}
+		else if( read( iEventFd, &iValue, sizeof(iValue) ) != sizeof(iValue) )
+		{
+			// ٸ ̺Ʈ ̹ ʱȭǾ.
+		}
+	}
+
+	AtomicStore( piWait, 0 );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ϰ  eventfd  ̺Ʈ Ѵ.
+ * @param piWait		   
+ * @param iEventFd	̺Ʈ  eventfd
+ */
+void CShmRing::Notify( volatile uint32_t * piWait, int iEventFd )
+{
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+
+	if( AtomicLoad( piWait ) )
+	{
+		uint64_t iValue = 1;
+
+		if( write( iEventFd, &iValue, sizeof(iValue) ) != sizeof(iValue) )
+		{
+			// eventfd īͰ ̹ ϵǾ ִ.
+		}
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ۽/ ring  Ѵ.
+ * @param iSize  ring    ũ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmChannel::Create( uint32_t iSize )
+{
+	if( m_clsSend.Create( iSize ) == false ) return false;
+	if( m_clsRecv.Create( iSize ) == false )
+	{
+		m_clsSend.Close();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ring  濡 Ѵ.  Import ޼ҵ ؾ Ѵ.
+ * @param hUnix Unix   ڵ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmChannel::Export( Socket hUnix )
+{
+	return m_clsSend.Export( hUnix ) && m_clsRecv.Export( hUnix );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Export   ring  Ѵ.  ۽ ring   ring  ȴ.
+ * @param hUnix		Unix   ڵ
+ * @param iSecond	 timeout (   )
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CShmChannel::Import( Socket hUnix, int iSecond )
+{
+	return m_clsRecv.Import( hUnix, iSecond ) && m_clsSend.Import( hUnix, iSecond );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ä Ѵ.
+ */
+void CShmChannel::Close()
+{
+	m_clsSend.Close();
+	m_clsRecv.Close();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ͸ Ѵ. TcpSend  ϰ  ͸  Ŀ Ѵ.
+ * @param pszBuf	 
+ * @param iLen		  ũ
+ * @param iSecond	 timeout (   )
+ * @returns ϸ iLen  ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int CShmChannel::Send( const char * pszBuf, int iLen, int iSecond )
+{
+	return m_clsSend.Write( pszBuf, iLen, iSecond );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ͸ Ѵ. TcpRecv  ϰ ŵ ŭ Ѵ.
+ * @param pszBuf		 
+ * @param iBufSize	  ũ
+ * @param iSecond		 timeout (   )
+ * @returns ϸ  ũ⸦ ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int CShmChannel::Recv( char * pszBuf, int iBufSize, int iSecond )
+{
+	return m_clsRecv.Read( pszBuf, iBufSize, iSecond );
+}
+
+#endif
@@ -0,0 +1,118 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _SHM_RING_H_
+#define _SHM_RING_H_
+
+#include "Define.h"
+#include "Tcp.h"
+
+#ifndef WIN32
+
+//  ޸ ring ⺻ ũ
+#define SHM_RING_SIZE		( 1024 * 1024 )
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ޸ ring . producer  consumer  ϴ   ٸ cache line  ġѴ.
+ */
+typedef struct
+{
+	/** producer   ġ */
+	volatile uint32_t	iHead;
+	char			szPadding1[60];
+
+	/** consumer   ġ */
+	volatile uint32_t	iTail;
+	char			szPadding2[60];
+
+	/** consumer  ͸ ٸ  1 ̴. */
+	volatile uint32_t	iConsumerWait;
+
+	/** producer    ٸ  1 ̴. */
+	volatile uint32_t	iProducerWait;
+
+	/**   Ͽ 1 ̴. */
+	volatile uint32_t	iClosed;
+
+	/**   ũ ( 2  ŵ ) */
+	uint32_t	iSize;
+} SHM_RING_HEADER;
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ȣƮ  μ  ޸𸮷 ͸ ϴ single-producer/single-consumer ring
+ *	- memfd    ޸𸮿 /  ˸ eventfd 2  ȴ.
+ *	-  ϰ   eventfd  ϹǷ Ͱ  ޵Ǵ ȿ system call  ߻ ʴ´.
+ *	-  ޸     Ƿ ring ũ Attach  ˻  ϰ head / tail  ring    óѴ.
+ */
+class CShmRing
+{
+public:
+	CShmRing();
+	~CShmRing();
+
+	bool Create( uint32_t iSize );
+	bool Attach( int iMemFd, int iDataFd, int iSpaceFd );
+	void Close();
+
+	bool Export( Socket hUnix );
+	bool Import( Socket hUnix, int iSecond );
+
+	int Write( const char * pszBuf, int iLen, int iSecond );
+	int Read( char * pszBuf, int iBufSize, int iSecond );
+
+private:
+	bool Wait( volatile uint32_t * piWait, int iEventFd, int iSecond, bool bProducer );
+	void Notify( volatile uint32_t * piWait, int iEventFd );
+
+	SHM_RING_HEADER * m_psttHeader;
+	char	* m_pszData;
+	size_t	m_iMapSize;
+
+	/**   ũ.  ޸ iSize   ʴ´. */
+	uint32_t	m_iSize;
+
+	int	m_iMemFd;
+	int	m_iDataFd;
+	int	m_iSpaceFd;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief ۽/  ޸ ring   뷮   ä
+ */
+class CShmChannel
+{
+public:
+	bool Create( uint32_t iSize = SHM_RING_SIZE );
+	bool Export( Socket hUnix );
+	bool Import( Socket hUnix, int iSecond );
+	void Close();
+
+	int Send( const char * pszBuf, int iLen, int iSecond );
+	int Recv( char * pszBuf, int iBufSize, int iSecond );
+
+private:
+	CShmRing m_clsSend;
+	CShmRing m_clsRecv;
+};
+
+#endif
+
+#endif
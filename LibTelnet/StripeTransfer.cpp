@@ -0,0 +1,1347 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "StripeTransfer.h"
+
+#ifdef USE_TLS
+
+#include "Log.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <new>
+#include "MemoryDebug.h"
+
+// Ʈ  ũ : magic(4) + transfer id(4) + file size(8) + name length(2)
+#define STRIPE_HELLO_SIZE		18
+
+// chunk  ũ : offset(8) + length(4). length  0 ̸ Ʈ ̴.
+#define STRIPE_CHUNK_HEADER_SIZE	12
+
+// Ʈ ῡ   Ȯ 
+#define STRIPE_ACK					'A'
+
+// ִ  ̸ 
+#define STRIPE_MAX_NAME_SIZE	255
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread 
+ */
+class CStripeRecvArg
+{
+public:
+	CStripeReceiver * m_pclsReceiver;
+	Socket	m_hSocket;
+
+	/** Unix   ̸ true ̴. */
+	bool	m_bLocal;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ʈ . TCP  AEAD  ȣȭϰ  ȣƮ   ޸ äη ͸ Ѵ.
+ */
+class CStripeConn
+{
+public:
+	CStripeConn( Socket hSocket, CShmChannel * pclsChannel, CAeadCipher * pclsCipher );
+
+	int Send( const char * pszBuf, int iLen );
+	int RecvSize( char * pszBuf, int iLen, int iSecond );
+
+	Socket	m_hSocket;
+	CShmChannel * m_pclsChannel;
+	CAeadCipher * m_pclsCipher;
+
+private:
+	/** ȣȭ / ȣȭ .     m_iPlainPos  m_iPlainEnd    ʾҴ. */
+	char	m_szFrame[AEAD_MAX_FRAME_SIZE];
+	int		m_iPlainPos;
+	int		m_iPlainEnd;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief monotonic ð milli second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicMs()
+{
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000 + sttTime.tv_nsec / 1000000;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 32bit  network byte order  Ѵ.
+ */
+static void Put32( char * pszBuf, uint32_t iValue )
+{
+	iValue = htonl( iValue );
+	memcpy( pszBuf, &iValue, 4 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 64bit  network byte order  Ѵ.
+ */
+static void Put64( char * pszBuf, uint64_t iValue )
+{
+	Put32( pszBuf, (uint32_t)( iValue >> 32 ) );
+	Put32( pszBuf + 4, (uint32_t)iValue );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief network byte order   32bit  ´.
+ */
+static uint32_t Get32( const char * pszBuf )
+{
+	uint32_t iValue;
+
+	memcpy( &iValue, pszBuf, 4 );
+
+	return ntohl( iValue );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief network byte order   64bit  ´.
+ */
+static uint64_t Get64( const char * pszBuf )
+{
+	return ( (uint64_t)Get32( pszBuf ) << 32 ) | Get32( pszBuf + 4 );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief chunk ũ⸦ ´.  chunk  STRIPE_CHUNK_SIZE    ִ.
+ */
+static int GetChunkSize( uint64_t iSize, uint64_t iOffset )
+{
+	if( iSize - iOffset < STRIPE_CHUNK_SIZE ) return (int)( iSize - iOffset );
+
+	return STRIPE_CHUNK_SIZE;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ * @param hSocket			 
+ * @param pclsChannel	 ޸ ä. TCP ̸ NULL  ԷѴ.
+ * @param pclsCipher	Ű ȯ Ϸ ȣȭ ü.  ޸ ä ϸ NULL  ԷѴ.
+ */
+CStripeConn::CStripeConn( Socket hSocket, CShmChannel * pclsChannel, CAeadCipher * pclsCipher ) : m_hSocket(hSocket), m_pclsChannel(pclsChannel), m_pclsCipher(pclsCipher)
+	, m_iPlainPos(0), m_iPlainEnd(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ͸  Ѵ. TCP  AEAD_MAX_PLAIN_SIZE    ȣȭѴ.
+ * @param pszBuf	 
+ * @param iLen		  ũ
+ * @returns ϸ iLen  ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int CStripeConn::Send( const char * pszBuf, int iLen )
+{
+	if( m_pclsChannel ) return m_pclsChannel->Send( pszBuf, iLen, STRIPE_TIMEOUT );
+
+	// kTLS  ϸ Ŀο ȣȭϹǷ  ʰ Ѵ.
+	if( m_pclsCipher->IsKtls() ) return TcpSend( m_hSocket, pszBuf, iLen );
+
+	int iSendLen = 0, n;
+
+	while( iSendLen < iLen )
+	{
+		n = iLen - iSendLen;
+		if( n > AEAD_MAX_PLAIN_SIZE ) n = AEAD_MAX_PLAIN_SIZE;
+
+		memcpy( m_szFrame + AEAD_HEADER_SIZE, pszBuf + iSendLen, n );
+		if( TcpSendAead( m_hSocket, *m_pclsCipher, m_szFrame, n ) != n ) return SOCKET_ERROR;
+
+		iSendLen += n;
+	}
+
+	return iLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ũ⸸ŭ ͸ Ѵ.
+ * @param pszBuf	 
+ * @param iLen		 ũ
+ * @param iSecond	 timeout (   )
+ * @returns ϸ iLen  ϰ ϸ SOCKET_ERROR  Ѵ.
+ */
+int CStripeConn::RecvSize( char * pszBuf, int iLen, int iSecond )
+{
+	int iRecvLen = 0, n;
+
+	if( m_pclsChannel )
+	{
+		while( iRecvLen < iLen )
+		{
+			n = m_pclsChannel->Recv( pszBuf + iRecvLen, iLen - iRecvLen, iSecond );
+			if( n <= 0 ) return SOCKET_ERROR;
+
+			iRecvLen += n;
+		}
+
+		return iLen;
+	}
+
+	if( m_pclsCipher->IsKtls() ) return TcpRecvSize( m_hSocket, pszBuf, iLen, iSecond );
+
+	//   û ũⰡ ٸǷ     ϸ   ȣȭѴ.
+	while( iRecvLen < iLen )
+	{
+		if( m_iPlainPos == m_iPlainEnd )
+		{
+			n = TcpRecvAead( m_hSocket, *m_pclsCipher, m_szFrame, sizeof(m_szFrame), iSecond );
+			if( n == SOCKET_ERROR ) return SOCKET_ERROR;
+
+			m_iPlainPos = AEAD_HEADER_SIZE;
+			m_iPlainEnd = AEAD_HEADER_SIZE + n;
+			continue;
+		}
+
+		n = m_iPlainEnd - m_iPlainPos;
+		if( n > iLen - iRecvLen ) n = iLen - iRecvLen;
+
+		memcpy( pszBuf + iRecvLen, m_szFrame + m_iPlainPos, n );
+		m_iPlainPos += n;
+		iRecvLen += n;
+	}
+
+	return iLen;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CStripeStream::CStripeStream() : m_pclsSender(NULL), m_hSocket(INVALID_SOCKET), m_bRetired(false)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CStripeSender::CStripeSender() : m_iPort(0), m_iFd(-1), m_iSize(0), m_iTransferId(0), m_iNextOffset(0), m_iSendSize(0)
+	, m_iTargetCount(0), m_iActiveCount(0), m_iRunCount(0), m_iFailCount(0)
+{
+	pthread_mutex_init( &m_sttMutex, NULL );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CStripeSender::~CStripeSender()
+{
+	Close();
+	pthread_mutex_destroy( &m_sttMutex );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ű ȯ    Ű Ѵ. Send  ȣϱ  ȣؾ Ѵ.
+ * @param strPsk   Ű
+ */
+void CStripeSender::SetPsk( const std::string & strPsk )
+{
+	m_strPsk = strPsk;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   TCP   Ѵ.  Ϸ   ʴ´.
+ * @param pszIp				 IP ּ
+ * @param iPort				 Ʈ ȣ
+ * @param pszFileName	  
+ * @param iMaxStream	ִ TCP  
+ * @param iInitStream	   TCP  . iMaxStream ̸̻    ʴ´.
+ * @returns   chunk  ȮϿ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeSender::Send( const char * pszIp, int iPort, const char * pszFileName, int iMaxStream, int iInitStream )
+{
+	struct stat sttStat;
+
+	Close();
+
+	if( m_strPsk.empty() )
+	{
+		CLog::Print( LOG_ERROR, "%s pre-shared key is not set", __FUNCTION__ );
+		return false;
+	}
+
+	m_iFd = open( pszFileName, O_RDONLY | O_CLOEXEC );
+	if( m_iFd == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s open(%s) error(%d)", __FUNCTION__, pszFileName, errno );
+		return false;
+	}
+
+	if( fstat( m_iFd, &sttStat ) == -1 || S_ISREG( sttStat.st_mode ) == 0 )
+	{
+		CLog::Print( LOG_ERROR, "%s %s is not a regular file", __FUNCTION__, pszFileName );
+		Close();
+		return false;
+	}
+
+	const char * pszName = strrchr( pszFileName, '/' );
+
+	m_strName = pszName ? pszName + 1 : pszFileName;
+	if( m_strName.length() > STRIPE_MAX_NAME_SIZE ) m_strName.resize( STRIPE_MAX_NAME_SIZE );
+
+	m_strIp = pszIp;
+	m_iPort = iPort;
+	m_iSize = sttStat.st_size;
+	m_iTransferId = (uint32_t)( GetMonotonicMs() ^ ( getpid() << 16 ) ^ time(NULL) );
+	m_iNextOffset = 0;
+	m_iSendSize = 0;
+	m_iFailCount = 0;
+
+	//  ȣƮ  TCP     ʰ  ޸ äη Ѵ.
+	if( IsLocalHost( pszIp ) )
+	{
+		std::string strPath;
+		Socket hUnix;
+
+		if( GetLocalSocketPath( iPort, strPath, false ) && ( hUnix = UnixConnect( strPath.c_str() ) ) != INVALID_SOCKET )
+		{
+			m_iTargetCount = 1;
+
+			bool bRes = SendLocal( hUnix );
+
+			closesocket( hUnix );
+			Close();
+
+			return bRes;
+		}
+	}
+
+	if( iMaxStream < 1 ) iMaxStream = 1;
+	if( iInitStream < 1 ) iInitStream = 1;
+
+	m_iTargetCount = ( iMaxStream < iInitStream ) ? iMaxStream : iInitStream;
+
+	for( int i = 0; i < m_iTargetCount; ++i )
+	{
+		if( AddStream() == false )
+		{
+			if( i == 0 )
+			{
+				Close();
+				return false;
+			}
+
+			m_iTargetCount = i;
+			break;
+		}
+	}
+
+	uint64_t iTuneTime = GetMonotonicMs(), iTuneSize = 0, iBestRate = 0, iRetryTime = 0;
+	int iBestCount = m_iTargetCount;
+	bool bTune = ( m_iTargetCount < iMaxStream ), bSettle = true, bRes = false;
+
+	while( 1 )
+	{
+		usleep( 10000 );
+
+		pthread_mutex_lock( &m_sttMutex );
+		int iRunCount = m_iRunCount, iFailCount = m_iFailCount;
+		uint64_t iSendSize = m_iSendSize;
+		bool bRemain = ( m_iNextOffset < m_iSize || m_clsRetryList.empty() == false );
+		pthread_mutex_unlock( &m_sttMutex );
+
+		if( iRunCount == 0 )
+		{
+			if( bRemain == false )
+			{
+				bRes = true;
+				break;
+			}
+
+			//   Ͽ  chunk  Ҵ.  ׷̵   Ƿ  Ŀ ٽ Ѵ.
+			uint64_t iNow = GetMonotonicMs();
+			if( iNow < iRetryTime ) continue;
+
+			if( iFailCount >= STRIPE_MAX_RETRY )
+			{
+				CLog::Print( LOG_ERROR, "%s transfer(%s) failed", __FUNCTION__, m_strName.c_str() );
+				break;
+			}
+
+			//    Ǹ chunk   ϹǷ ó ٽ Ѵ.
+			pthread_mutex_lock( &m_sttMutex );
+			m_iNextOffset = 0;
+			m_clsRetryList.clear();
+			pthread_mutex_unlock( &m_sttMutex );
+
+			if( AddStream() == false )
+			{
+				pthread_mutex_lock( &m_sttMutex );
+				++m_iFailCount;
+				pthread_mutex_unlock( &m_sttMutex );
+			}
+
+			iRetryTime = iNow + STRIPE_RETRY_MS;
+			continue;
+		}
+
+		uint64_t iNow = GetMonotonicMs();
+		if( bTune == false || iNow - iTuneTime < STRIPE_TUNE_MS ) continue;
+
+		uint64_t iRate = ( iSendSize - iTuneSize ) * 1000 / ( iNow - iTuneTime );
+
+		iTuneTime = iNow;
+		iTuneSize = iSendSize;
+
+		//  ߰ Ŀ slow start ̹Ƿ  ֱ⸦ ǳʶڴ.
+		if( bSettle )
+		{
+			bSettle = false;
+			continue;
+		}
+
+		if( bRemain && iRate * 100 > iBestRate * ( 100 + STRIPE_TUNE_GAIN ) && m_iTargetCount < iMaxStream )
+		{
+			iBestRate = iRate;
+			iBestCount = m_iTargetCount;
+
+			int iCount = m_iTargetCount * 2;
+			if( iCount > iMaxStream ) iCount = iMaxStream;
+
+			CLog::Print( LOG_DEBUG, "%s rate(" UNSIGNED_LONG_LONG_FORMAT ") stream(%d => %d)", __FUNCTION__, iRate, m_iTargetCount, iCount );
+
+			pthread_mutex_lock( &m_sttMutex );
+			m_iTargetCount = iCount;
+			int iActiveCount = m_iActiveCount;
+			pthread_mutex_unlock( &m_sttMutex );
+
+			while( iActiveCount < iCount && IsRemain() && AddStream() )
+			{
+				++iActiveCount;
+			}
+
+			bSettle = true;
+		}
+		else
+		{
+			if( iRate > iBestRate )
+			{
+				iBestRate = iRate;
+				iBestCount = m_iTargetCount;
+			}
+
+			CLog::Print( LOG_DEBUG, "%s rate(" UNSIGNED_LONG_LONG_FORMAT ") stream(%d => %d) tuned", __FUNCTION__, iRate, m_iTargetCount, iBestCount );
+
+			//  ÷  ʾ    δ.
+			pthread_mutex_lock( &m_sttMutex );
+			m_iTargetCount = iBestCount;
+			pthread_mutex_unlock( &m_sttMutex );
+
+			bTune = false;
+		}
+	}
+
+	Close();
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ۿ   TCP   ´.
+ * @returns ۿ   TCP   Ѵ.
+ */
+int CStripeSender::GetStreamCount()
+{
+	return m_iTargetCount;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ũ⸦ ´.
+ * @returns   ũ⸦ Ѵ.
+ */
+uint64_t CStripeSender::GetFileSize()
+{
+	return m_iSize;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ʈ thread. chunk  ͼ ϰ  ̻  chunk   Ḧ ˸  Ȯ ٸ.
+ * @param lpParameter CStripeStream ü
+ * @returns 0  Ѵ.
+ */
+THREAD_API CStripeSender::StreamThread( LPVOID lpParameter )
+{
+	CStripeStream * pclsStream = (CStripeStream *)lpParameter;
+	CStripeSender * pclsSender = pclsStream->m_pclsSender;
+	CStripeConn clsConn( pclsStream->m_hSocket, NULL, &pclsStream->m_clsCipher );
+	char * pszBuf = (char *)malloc( STRIPE_CHUNK_HEADER_SIZE + STRIPE_CHUNK_SIZE );
+	uint64_t iOffset;
+	bool bError = ( pszBuf == NULL );
+
+	while( bError == false )
+	{
+		// Ȯ   带 chunk    ҴϿ ޸𸮰 Ͽ chunk  Ҿ ʵ Ѵ.
+		std::list< uint64_t > clsOffsetList;
+
+		try
+		{
+			clsOffsetList.push_back( 0 );
+		}
+		catch( std::bad_alloc & )
+		{
+			bError = true;
+			break;
+		}
+
+		if( pclsSender->GetChunk( pclsStream, iOffset ) == false ) break;
+
+		int iLen = GetChunkSize( pclsSender->m_iSize, iOffset );
+
+		clsOffsetList.front() = iOffset;
+
+		pthread_mutex_lock( &pclsSender->m_sttMutex );
+		pclsStream->m_clsSentList.splice( pclsStream->m_clsSentList.end(), clsOffsetList );
+		pthread_mutex_unlock( &pclsSender->m_sttMutex );
+
+		Put64( pszBuf, iOffset );
+		Put32( pszBuf + 8, iLen );
+
+		if( pread( pclsSender->m_iFd, pszBuf + STRIPE_CHUNK_HEADER_SIZE, iLen, iOffset ) != iLen ||
+				clsConn.Send( pszBuf, STRIPE_CHUNK_HEADER_SIZE + iLen ) != STRIPE_CHUNK_HEADER_SIZE + iLen )
+		{
+			bError = true;
+			break;
+		}
+
+		pthread_mutex_lock( &pclsSender->m_sttMutex );
+		pclsSender->m_iSendSize += iLen;
+		pthread_mutex_unlock( &pclsSender->m_sttMutex );
+	}
+
+	if( bError == false )
+	{
+		char cAck = 0;
+
+		memset( pszBuf, 0, STRIPE_CHUNK_HEADER_SIZE );
+
+		if( clsConn.Send( pszBuf, STRIPE_CHUNK_HEADER_SIZE ) != STRIPE_CHUNK_HEADER_SIZE ||
+				clsConn.RecvSize( &cAck, 1, STRIPE_TIMEOUT ) != 1 || cAck != STRIPE_ACK )
+		{
+			bError = true;
+		}
+	}
+
+	free( pszBuf );
+
+	pthread_mutex_lock( &pclsSender->m_sttMutex );
+
+	if( bError )
+	{
+		CLog::Print( LOG_ERROR, "%s stream error(%d) - resend %d chunks", __FUNCTION__, errno, (int)pclsStream->m_clsSentList.size() );
+
+		pclsSender->m_clsRetryList.splice( pclsSender->m_clsRetryList.end(), pclsStream->m_clsSentList );
+		++pclsSender->m_iFailCount;
+	}
+
+	pclsStream->m_clsSentList.clear();
+
+	if( pclsStream->m_bRetired == false ) --pclsSender->m_iActiveCount;
+	--pclsSender->m_iRunCount;
+
+	pthread_mutex_unlock( &pclsSender->m_sttMutex );
+
+	return 0;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  TCP  ߰ϰ Ű ȯ Ϸϸ Ʈ thread  Ѵ.
+ *	- ϴ  ٸ   chunk    Ʈ   ʰ  Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeSender::AddStream()
+{
+	Socket hSocket = TcpConnect( m_strIp.c_str(), m_iPort, 10 );
+	if( hSocket == INVALID_SOCKET )
+	{
+		CLog::Print( LOG_ERROR, "%s TcpConnect(%s:%d) error(%d)", __FUNCTION__, m_strIp.c_str(), m_iPort, GetError() );
+		return false;
+	}
+
+	CStripeStream * pclsStream = new CStripeStream();
+
+	pclsStream->m_pclsSender = this;
+	pclsStream->m_hSocket = hSocket;
+
+	if( pclsStream->m_clsCipher.Handshake( hSocket, false, STRIPE_HANDSHAKE_SECOND, m_strPsk.c_str() ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s Handshake(%s:%d) error", __FUNCTION__, m_strIp.c_str(), m_iPort );
+		closesocket( hSocket );
+		delete pclsStream;
+		return false;
+	}
+
+	//     ũⰡ 0  ϵ ؾ ϹǷ  Ѵ.
+	pthread_mutex_lock( &m_sttMutex );
+	bool bLate = ( m_iRunCount > 0 && m_iNextOffset >= m_iSize && m_clsRetryList.empty() );
+	if( bLate == false )
+	{
+		++m_iActiveCount;
+		++m_iRunCount;
+	}
+	pthread_mutex_unlock( &m_sttMutex );
+
+	if( bLate )
+	{
+		CLog::Print( LOG_DEBUG, "%s no chunk remains - stream is not added", __FUNCTION__ );
+		closesocket( hSocket );
+		delete pclsStream;
+		return false;
+	}
+
+	CStripeConn clsConn( hSocket, NULL, &pclsStream->m_clsCipher );
+	char szHello[STRIPE_HELLO_SIZE + STRIPE_MAX_NAME_SIZE];
+	int iLen = GetHello( szHello );
+
+	if( clsConn.Send( szHello, iLen ) != iLen )
+	{
+		CLog::Print( LOG_ERROR, "%s Send error(%d)", __FUNCTION__, GetError() );
+
+		pthread_mutex_lock( &m_sttMutex );
+		--m_iActiveCount;
+		--m_iRunCount;
+		pthread_mutex_unlock( &m_sttMutex );
+
+		closesocket( hSocket );
+		delete pclsStream;
+		return false;
+	}
+
+	if( pthread_create( &pclsStream->m_sttThread, NULL, StreamThread, pclsStream ) != 0 )
+	{
+		CLog::Print( LOG_ERROR, "%s pthread_create error", __FUNCTION__ );
+
+		pthread_mutex_lock( &m_sttMutex );
+		--m_iActiveCount;
+		--m_iRunCount;
+		pthread_mutex_unlock( &m_sttMutex );
+
+		closesocket( hSocket );
+		delete pclsStream;
+		return false;
+	}
+
+	m_clsStreamList.push_back( pclsStream );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ϰų  chunk  Ҵ ˻Ѵ.
+ * @returns  chunk   true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeSender::IsRemain()
+{
+	pthread_mutex_lock( &m_sttMutex );
+	bool bRemain = ( m_iNextOffset < m_iSize || m_clsRetryList.empty() == false );
+	pthread_mutex_unlock( &m_sttMutex );
+
+	return bRemain;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ȣƮ  Ű ȯ Ϸ ,  ޸ ä ϰ   Ѵ.
+ *	-  ޸𸮴  μ   Ƿ ȣȭ ʴ´.
+ * @param hUnix   Unix  
+ * @returns   chunk  ȮϿ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeSender::SendLocal( Socket hUnix )
+{
+	CAeadCipher clsCipher;
+	CShmChannel clsChannel;
+	CStripeConn clsConn( hUnix, &clsChannel, NULL );
+	char szHello[STRIPE_HELLO_SIZE + STRIPE_MAX_NAME_SIZE];
+	int iLen = GetHello( szHello );
+
+	if( clsCipher.Handshake( hUnix, false, STRIPE_HANDSHAKE_SECOND, m_strPsk.c_str() ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s Handshake error", __FUNCTION__ );
+		return false;
+	}
+
+	if( clsChannel.Create() == false || clsChannel.Export( hUnix ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s shared memory channel error(%d)", __FUNCTION__, errno );
+		return false;
+	}
+
+	if( clsConn.Send( szHello, iLen ) != iLen ) return false;
+
+	char * pszBuf = (char *)malloc( STRIPE_CHUNK_HEADER_SIZE + STRIPE_CHUNK_SIZE );
+	bool bRes = ( pszBuf != NULL );
+
+	for( uint64_t iOffset = 0; bRes && iOffset < m_iSize; iOffset += STRIPE_CHUNK_SIZE )
+	{
+		iLen = GetChunkSize( m_iSize, iOffset );
+
+		Put64( pszBuf, iOffset );
+		Put32( pszBuf + 8, iLen );
+
+		if( pread( m_iFd, pszBuf + STRIPE_CHUNK_HEADER_SIZE, iLen, iOffset ) != iLen ||
+				clsConn.Send( pszBuf, STRIPE_CHUNK_HEADER_SIZE + iLen ) != STRIPE_CHUNK_HEADER_SIZE + iLen )
+		{
+			CLog::Print( LOG_ERROR, "%s send error(%d)", __FUNCTION__, errno );
+			bRes = false;
+			break;
+		}
+
+		m_iSendSize += iLen;
+	}
+
+	if( bRes )
+	{
+		char cAck = 0;
+
+		memset( pszBuf, 0, STRIPE_CHUNK_HEADER_SIZE );
+
+		if( clsConn.Send( pszBuf, STRIPE_CHUNK_HEADER_SIZE ) != STRIPE_CHUNK_HEADER_SIZE ||
+				clsConn.RecvSize( &cAck, 1, STRIPE_TIMEOUT ) != 1 || cAck != STRIPE_ACK )
+		{
+			bRes = false;
+		}
+	}
+
+	free( pszBuf );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ʈ  Ѵ.
+ * @param pszHello Ʈ   . STRIPE_HELLO_SIZE + STRIPE_MAX_NAME_SIZE ̻̾ Ѵ.
+ * @returns Ʈ  ũ⸦ Ѵ.
+ */
+int CStripeSender::GetHello( char * pszHello )
+{
+	Put32( pszHello, STRIPE_MAGIC );
+	Put32( pszHello + 4, m_iTransferId );
+	Put64( pszHello + 8, m_iSize );
+	pszHello[16] = (char)( m_strName.length() >> 8 );
+	pszHello[17] = (char)m_strName.length();
+	memcpy( pszHello + STRIPE_HELLO_SIZE, m_strName.c_str(), m_strName.length() );
+
+	return STRIPE_HELLO_SIZE + (int)m_strName.length();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  chunk  ´.  chunk   ´.
+ * @param pclsStream	chunk   Ʈ
+ * @param iOffset			chunk offset   
+ * @returns  chunk   true  ϰ ų   ٿ ϸ false  Ѵ.
+ */
+bool CStripeSender::GetChunk( CStripeStream * pclsStream, uint64_t & iOffset )
+{
+	bool bRes = true;
+
+	pthread_mutex_lock( &m_sttMutex );
+
+	if( m_iActiveCount > m_iTargetCount )
+	{
+		--m_iActiveCount;
+		pclsStream->m_bRetired = true;
+		bRes = false;
+	}
+	else if( m_clsRetryList.empty() == false )
+	{
+		iOffset = m_clsRetryList.front();
+		m_clsRetryList.pop_front();
+	}
+	else if( m_iNextOffset < m_iSize )
+	{
+		iOffset = m_iNextOffset;
+		m_iNextOffset += STRIPE_CHUNK_SIZE;
+	}
+	else
+	{
+		bRes = false;
+	}
+
+	pthread_mutex_unlock( &m_sttMutex );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Ʈ thread    ٸ   ݴ´.
+ */
+void CStripeSender::Close()
+{
+	for( size_t i = 0; i < m_clsStreamList.size(); ++i )
+	{
+		CStripeStream * pclsStream = m_clsStreamList[i];
+
+		// thread   Ȯ ٸ  ٷ ǵ Ѵ.
+		shutdown( pclsStream->m_hSocket, SHUT_RDWR );
+		pthread_join( pclsStream->m_sttThread, NULL );
+		closesocket( pclsStream->m_hSocket );
+		delete pclsStream;
+	}
+
+	m_clsStreamList.clear();
+	m_clsRetryList.clear();
+	m_iActiveCount = 0;
+	m_iRunCount = 0;
+
+	if( m_iFd != -1 )
+	{
+		close( m_iFd );
+		m_iFd = -1;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CStripeFile::CStripeFile() : m_iFd(-1), m_iSize(0), m_iStreamCount(0), m_iChunkCount(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CStripeReceiver::CStripeReceiver() : m_iStreamCount(0)
+{
+	pthread_mutex_init( &m_sttMutex, NULL );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CStripeReceiver::~CStripeReceiver()
+{
+	pthread_mutex_destroy( &m_sttMutex );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ű ȯ    Ű Ѵ.  thread  ϱ  ȣؾ Ѵ.
+ * @param strPsk   Ű
+ */
+void CStripeReceiver::SetPsk( const std::string & strPsk )
+{
+	m_strPsk = strPsk;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief     Ѵ.   Ѵ.
+ * @param pszDir    
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeReceiver::Open( const char * pszDir )
+{
+	if( m_strPsk.empty() )
+	{
+		CLog::Print( LOG_ERROR, "%s pre-shared key is not set", __FUNCTION__ );
+		return false;
+	}
+
+	if( mkdir( pszDir, 0755 ) == -1 && errno != EEXIST )
+	{
+		CLog::Print( LOG_ERROR, "%s mkdir(%s) error(%d)", __FUNCTION__, pszDir, errno );
+		return false;
+	}
+
+	m_strDir = pszDir;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief    thread  óѴ.  ϸ  Ѵ.
+ * @param hSocket  
+ * @param bLocal	Unix   ̸ true  ԷѴ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeReceiver::Add( Socket hSocket, bool bLocal )
+{
+	if( m_strDir.empty() )
+	{
+		closesocket( hSocket );
+		return false;
+	}
+
+	pthread_mutex_lock( &m_sttMutex );
+	bool bFull = ( m_iStreamCount >= STRIPE_MAX_RECV_STREAM );
+	if( bFull == false ) ++m_iStreamCount;
+	pthread_mutex_unlock( &m_sttMutex );
+
+	if( bFull )
+	{
+		CLog::Print( LOG_ERROR, "%s too many streams", __FUNCTION__ );
+		closesocket( hSocket );
+		return false;
+	}
+
+	//  ׷̵ ο μ  ʵ Ѵ.
+	fcntl( hSocket, F_SETFD, FD_CLOEXEC );
+
+	CStripeRecvArg * pclsArg = new CStripeRecvArg();
+	pthread_t sttThread;
+
+	pclsArg->m_pclsReceiver = this;
+	pclsArg->m_hSocket = hSocket;
+	pclsArg->m_bLocal = bLocal;
+
+	if( pthread_create( &sttThread, NULL, StreamThread, pclsArg ) != 0 )
+	{
+		CLog::Print( LOG_ERROR, "%s pthread_create error", __FUNCTION__ );
+
+		pthread_mutex_lock( &m_sttMutex );
+		--m_iStreamCount;
+		pthread_mutex_unlock( &m_sttMutex );
+
+		closesocket( hSocket );
+		delete pclsArg;
+		return false;
+	}
+
+	pthread_detach( sttThread );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief     ´.
+ * @returns     Ѵ.
+ */
+int CStripeReceiver::GetFileCount()
+{
+	pthread_mutex_lock( &m_sttMutex );
+	int iCount = (int)m_clsFileMap.size();
+	pthread_mutex_unlock( &m_sttMutex );
+
+	return iCount;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  thread. Ű ȯ Ϸ Ḹ Ѵ.
+ *	- detach  thread  ܰ ĵǸ  μ ǹǷ  ܸ ⼭ óѴ.
+ * @param lpParameter CStripeRecvArg ü
+ * @returns 0  Ѵ.
+ */
+THREAD_API CStripeReceiver::StreamThread( LPVOID lpParameter )
+{
+	CStripeRecvArg * pclsArg = (CStripeRecvArg *)lpParameter;
+	CStripeReceiver * pclsReceiver = pclsArg->m_pclsReceiver;
+
+	try
+	{
+		CAeadCipher clsCipher;
+
+		if( clsCipher.Handshake( pclsArg->m_hSocket, true, STRIPE_HANDSHAKE_SECOND, pclsReceiver->m_strPsk.c_str() ) == false )
+		{
+			CLog::Print( LOG_ERROR, "%s Handshake error", __FUNCTION__ );
+		}
+		else if( pclsArg->m_bLocal )
+		{
+			CShmChannel clsChannel;
+
+			if( clsChannel.Import( pclsArg->m_hSocket, STRIPE_TIMEOUT ) )
+			{
+				CStripeConn clsConn( pclsArg->m_hSocket, &clsChannel, NULL );
+
+				pclsReceiver->Recv( clsConn );
+			}
+		}
+		else
+		{
+			CStripeConn clsConn( pclsArg->m_hSocket, NULL, &clsCipher );
+
+			pclsReceiver->Recv( clsConn );
+		}
+	}
+	catch( std::exception & clsException )
+	{
+		CLog::Print( LOG_ERROR, "%s exception(%s)", __FUNCTION__, clsException.what() );
+	}
+
+	closesocket( pclsArg->m_hSocket );
+
+	pthread_mutex_lock( &pclsReceiver->m_sttMutex );
+	--pclsReceiver->m_iStreamCount;
+	pthread_mutex_unlock( &pclsReceiver->m_sttMutex );
+
+	delete pclsArg;
+
+	return 0;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ϳ  ۵Ǵ chunk  Ͽ Ͽ Ѵ.
+ * @param clsConn  
+ */
+void CStripeReceiver::Recv( CStripeConn & clsConn )
+{
+	char szHeader[STRIPE_HELLO_SIZE], szName[STRIPE_MAX_NAME_SIZE+1];
+	int iFd;
+
+	if( clsConn.RecvSize( szHeader, STRIPE_HELLO_SIZE, STRIPE_TIMEOUT ) != STRIPE_HELLO_SIZE || Get32( szHeader ) != STRIPE_MAGIC ) return;
+
+	uint32_t iTransferId = Get32( szHeader + 4 );
+	uint64_t iSize = Get64( szHeader + 8 );
+	int iNameLen = ( (uint8_t)szHeader[16] << 8 ) | (uint8_t)szHeader[17];
+
+	if( iNameLen <= 0 || iNameLen > STRIPE_MAX_NAME_SIZE ) return;
+	if( clsConn.RecvSize( szName, iNameLen, STRIPE_TIMEOUT ) != iNameLen ) return;
+
+	szName[iNameLen] = '\0';
+
+	//  ̸  ԵǾ    ۿ    ִ.
+	if( strlen( szName ) != (size_t)iNameLen || strchr( szName, '/' ) || !strcmp( szName, "." ) || !strcmp( szName, ".." ) )
+	{
+		CLog::Print( LOG_ERROR, "%s invalid file name", __FUNCTION__ );
+		return;
+	}
+
+	if( iSize > STRIPE_MAX_FILE_SIZE )
+	{
+		CLog::Print( LOG_ERROR, "%s %s file size(" UNSIGNED_LONG_LONG_FORMAT ") is too large", __FUNCTION__, szName, iSize );
+		return;
+	}
+
+	bool bDone = false;
+
+	if( OpenFile( iTransferId, iSize, szName, iFd, bDone ) == false )
+	{
+		if( bDone ) RecvDone( clsConn, iTransferId );
+		return;
+	}
+
+	char * pszBuf = (char *)malloc( STRIPE_CHUNK_SIZE );
+
+	while( pszBuf )
+	{
+		if( clsConn.RecvSize( szHeader, STRIPE_CHUNK_HEADER_SIZE, STRIPE_TIMEOUT ) != STRIPE_CHUNK_HEADER_SIZE ) break;
+
+		uint64_t iOffset = Get64( szHeader );
+		uint32_t iLen = Get32( szHeader + 8 );
+
+		if( iLen == 0 )
+		{
+			//  chunk   Ͽ Ǿ.
+			char cAck = STRIPE_ACK;
+
+			clsConn.Send( &cAck, 1 );
+			break;
+		}
+
+		if( iOffset >= iSize || iOffset % STRIPE_CHUNK_SIZE != 0 || iLen != (uint32_t)GetChunkSize( iSize, iOffset ) )
+		{
+			CLog::Print( LOG_ERROR, "%s invalid chunk offset(" UNSIGNED_LONG_LONG_FORMAT ") length(%u)", __FUNCTION__, iOffset, iLen );
+			break;
+		}
+
+		if( clsConn.RecvSize( pszBuf, (int)iLen, STRIPE_TIMEOUT ) != (int)iLen ) break;
+
+		// chunk    ϰ  offset ġ Ѵ.
+		if( pwrite( iFd, pszBuf, iLen, iOffset ) != (ssize_t)iLen )
+		{
+			CLog::Print( LOG_ERROR, "%s pwrite error(%d)", __FUNCTION__, errno );
+			break;
+		}
+
+		//   CloseFile  ȣϱ     ʴ´.
+		pthread_mutex_lock( &m_sttMutex );
+
+		CStripeFile & clsFile = m_clsFileMap.find( iTransferId )->second;
+		size_t iChunk = (size_t)( iOffset / STRIPE_CHUNK_SIZE );
+
+		if( clsFile.m_clsChunkList[iChunk] == false )
+		{
+			clsFile.m_clsChunkList[iChunk] = true;
+			++clsFile.m_iChunkCount;
+		}
+
+		pthread_mutex_unlock( &m_sttMutex );
+	}
+
+	free( pszBuf );
+	CloseFile( iTransferId );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ϸ ۿ ʰ   óѴ.   ʰ chunk   Ŀ  Ȯ Ѵ.
+ *	-   chunk   ٷ Ḧ ˸. Ȯ  Ͽ ó ٽ ϴ 쿡  Ϸǵ Ѵ.
+ * @param clsConn			 
+ * @param iTransferId	 ̵
+ */
+void CStripeReceiver::RecvDone( CStripeConn & clsConn, uint32_t iTransferId )
+{
+	char szHeader[STRIPE_CHUNK_HEADER_SIZE];
+	char * pszBuf = NULL;
+	uint32_t iLen;
+
+	while( clsConn.RecvSize( szHeader, STRIPE_CHUNK_HEADER_SIZE, STRIPE_TIMEOUT ) == STRIPE_CHUNK_HEADER_SIZE )
+	{
+		iLen = Get32( szHeader + 8 );
+		if( iLen == 0 )
+		{
+			char cAck = STRIPE_ACK;
+
+			CLog::Print( LOG_DEBUG, "%s transfer(%08x) is already completed", __FUNCTION__, iTransferId );
+			clsConn.Send( &cAck, 1 );
+			break;
+		}
+
+		if( iLen > STRIPE_CHUNK_SIZE ) break;
+		if( pszBuf == NULL && ( pszBuf = (char *)malloc( STRIPE_CHUNK_SIZE ) ) == NULL ) break;
+		if( clsConn.RecvSize( pszBuf, (int)iLen, STRIPE_TIMEOUT ) != (int)iLen ) break;
+	}
+
+	free( pszBuf );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ӽ  .   ٸ  ̹    Ų.
+ *	- ӽ  O_EXCL | O_NOFOLLOW  ϹǷ  ̳ ɺ ũ Ͽ ٸ   ʴ´.
+ *	-    Ŀ ٽ   ó ٽ ۵ǹǷ    ӽ  ٽ Ѵ.
+ *	- ̹ Ϸ ̸ ӽ   ʴ´.
+ * @param iTransferId	 ̵
+ * @param iSize				 ũ
+ * @param strName			 ̸
+ * @param iFd					ӽ  descriptor   
+ * @param bDone				̹ Ϸ ̸ true  ȴ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CStripeReceiver::OpenFile( uint32_t iTransferId, uint64_t iSize, const std::string & strName, int & iFd, bool & bDone )
+{
+	std::string strPartName;
+	bool bRes = true;
+
+	GetPartFileName( iTransferId, strPartName );
+
+	pthread_mutex_lock( &m_sttMutex );
+
+	STRIPE_FILE_MAP::iterator itMap = m_clsFileMap.find( iTransferId );
+	if( m_clsDoneSet.find( iTransferId ) != m_clsDoneSet.end() )
+	{
+		bDone = true;
+		bRes = false;
+	}
+	else if( itMap != m_clsFileMap.end() )
+	{
+		if( itMap->second.m_iSize != iSize || itMap->second.m_strName != strName )
+		{
+			bRes = false;
+		}
+		else
+		{
+			++itMap->second.m_iStreamCount;
+			iFd = itMap->second.m_iFd;
+		}
+	}
+	else
+	{
+		struct stat sttStat;
+
+		iFd = open( strPartName.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600 );
+		if( iFd == -1 && errno == EEXIST )
+		{
+			iFd = open( strPartName.c_str(), O_WRONLY | O_NOFOLLOW | O_CLOEXEC );
+			if( iFd != -1 && ( fstat( iFd, &sttStat ) == -1 || S_ISREG( sttStat.st_mode ) == 0 || sttStat.st_nlink != 1 ) )
+			{
+				close( iFd );
+				iFd = -1;
+				errno = EINVAL;
+			}
+		}
+
+		if( iFd == -1 || ftruncate( iFd, iSize ) == -1 )
+		{
+			CLog::Print( LOG_ERROR, "%s open(%s) error(%d)", __FUNCTION__, strPartName.c_str(), errno );
+			if( iFd != -1 ) close( iFd );
+			bRes = false;
+		}
+		else
+		{
+			try
+			{
+				CStripeFile & clsFile = m_clsFileMap[iTransferId];
+
+				clsFile.m_iFd = iFd;
+				clsFile.m_iSize = iSize;
+				clsFile.m_strName = strName;
+				clsFile.m_iStreamCount = 1;
+				clsFile.m_clsChunkList.resize( (size_t)( ( iSize + STRIPE_CHUNK_SIZE - 1 ) / STRIPE_CHUNK_SIZE ), false );
+			}
+			catch( std::bad_alloc & )
+			{
+				CLog::Print( LOG_ERROR, "%s %s chunk list allocation error", __FUNCTION__, strName.c_str() );
+				m_clsFileMap.erase( iTransferId );
+				close( iFd );
+				bRes = false;
+			}
+		}
+	}
+
+	pthread_mutex_unlock( &m_sttMutex );
+
+	return bRes;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ҽŰ  ̸  ݴ´.
+ *	-  chunk  Ͽ ӽ    ̸ link Ѵ.  ̸   ӽ  .
+ *	- chunk  ϳ  Ͽ ӽ  Ѵ. ٽ   ó ۵ǹǷ Ҿ Ͱ .
+ * @param iTransferId  ̵
+ */
+void CStripeReceiver::CloseFile( uint32_t iTransferId )
+{
+	std::string strName;
+	uint64_t iSize = 0, iChunkCount = 0, iChunkTotal = 0;
+	int iFd = -1;
+	struct stat sttFdStat, sttPathStat;
+
+	pthread_mutex_lock( &m_sttMutex );
+
+	STRIPE_FILE_MAP::iterator itMap = m_clsFileMap.find( iTransferId );
+	if( itMap != m_clsFileMap.end() && --itMap->second.m_iStreamCount == 0 )
+	{
+		CStripeFile & clsFile = itMap->second;
+
+		iFd = clsFile.m_iFd;
+		iSize = clsFile.m_iSize;
+		iChunkCount = clsFile.m_iChunkCount;
+		iChunkTotal = clsFile.m_clsChunkList.size();
+		strName.swap( clsFile.m_strName );
+
+		m_clsFileMap.erase( itMap );
+
+		if( iChunkCount == iChunkTotal && m_clsDoneSet.find( iTransferId ) == m_clsDoneSet.end() )
+		{
+			try
+			{
+				m_clsDoneSet.insert( iTransferId );
+				m_clsDoneList.push_back( iTransferId );
+			}
+			catch( std::bad_alloc & )
+			{
+				m_clsDoneSet.erase( iTransferId );
+			}
+
+			if( m_clsDoneList.size() > STRIPE_MAX_DONE_ID )
+			{
+				m_clsDoneSet.erase( m_clsDoneList.front() );
+				m_clsDoneList.pop_front();
+			}
+		}
+	}
+
+	pthread_mutex_unlock( &m_sttMutex );
+
+	if( iFd == -1 ) return;
+
+	std::string strPartName, strFileName = m_strDir + "/" + strName;
+
+	GetPartFileName( iTransferId, strPartName );
+
+	if( iChunkCount == 0 && iChunkTotal > 0 )
+	{
+		//  ׷̵ ߿ ο μ  ӽ    Ƿ  descriptor    Ѵ.
+		if( fstat( iFd, &sttFdStat ) == 0 && lstat( strPartName.c_str(), &sttPathStat ) == 0 &&
+				sttFdStat.st_dev == sttPathStat.st_dev && sttFdStat.st_ino == sttPathStat.st_ino )
+		{
+			unlink( strPartName.c_str() );
+		}
+
+		close( iFd );
+		CLog::Print( LOG_DEBUG, "%s %s no chunk is received - %s is removed", __FUNCTION__, strName.c_str(), strPartName.c_str() );
+		return;
+	}
+
+	//  ߿ ڸ   ְ Ϸ  ٸ ڵ   ֵ Ѵ.
+	if( iChunkCount == iChunkTotal ) fchmod( iFd, 0644 );
+	close( iFd );
+
+	if( iChunkCount != iChunkTotal )
+	{
+		CLog::Print( LOG_ERROR, "%s %s is incomplete - " UNSIGNED_LONG_LONG_FORMAT "/" UNSIGNED_LONG_LONG_FORMAT " chunks", __FUNCTION__, strName.c_str(), iChunkCount, iChunkTotal );
+		return;
+	}
+
+	// rename   ̸  Ƿ link  Ѵ.
+	if( link( strPartName.c_str(), strFileName.c_str() ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s link(%s) error(%d) - received file is kept as %s", __FUNCTION__, strFileName.c_str(), errno, strPartName.c_str() );
+		return;
+	}
+
+	unlink( strPartName.c_str() );
+
+	CLog::Print( LOG_INFO, "%s %s (" UNSIGNED_LONG_LONG_FORMAT " bytes) is received", __FUNCTION__, strName.c_str(), iSize );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ӽ  θ ´.   ̸ ġ ʵ  Ϸ Ѵ.
+ * @param iTransferId		 ̵
+ * @param strFileName		ӽ  θ  
+ */
+void CStripeReceiver::GetPartFileName( uint32_t iTransferId, std::string & strFileName )
+{
+	char szName[32];
+
+	snprintf( szName, sizeof(szName), "/.stripe_%08x.part", iTransferId );
+
+	strFileName = m_strDir;
+	strFileName.append( szName );
+}
+
+#endif
@@ -0,0 +1,238 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _STRIPE_TRANSFER_H_
+#define _STRIPE_TRANSFER_H_
+
+#include "Define.h"
+#include "Tcp.h"
+#include "ShmRing.h"
+#include "UnixSocket.h"
+#include "AeadCipher.h"
+
+//     Ű ϰ ȣȭϹǷ AEAD     ʴ´.
+#ifdef USE_TLS
+
+#include <pthread.h>
+#include <string>
+#include <list>
+#include <vector>
+#include <map>
+#include <set>
+
+//    Ʈ
+#define STRIPE_PORT					8889
+
+// Ʈ    ( "STRP" )
+#define STRIPE_MAGIC				0x53545250
+
+//  .  chunk   offset ġ ϹǷ   ϰ ȴ.
+#define STRIPE_CHUNK_SIZE		( 256 * 1024 )
+
+//    TCP  
+#define STRIPE_INIT_STREAM	2
+
+// ִ TCP  
+#define STRIPE_MAX_STREAM		16
+
+//  ӵ Ͽ TCP   ϴ ֱ ( milli second  )
+#define STRIPE_TUNE_MS			500
+
+// TCP  ߰ Ŀ  ӵ   ( % ) ̻ Ͽ  ߰Ѵ.
+#define STRIPE_TUNE_GAIN		10
+
+//   Ͽ  ٽ ϱ  ϴ ð ( milli second  )
+#define STRIPE_RETRY_MS			1000
+
+//   Ƚ   ϸ  ߴѴ.
+#define STRIPE_MAX_RETRY		32
+
+//    ð (   )
+#define STRIPE_TIMEOUT			30
+
+//  ÿ óϴ ִ TCP  
+#define STRIPE_MAX_RECV_STREAM	256
+
+//   Ű Ű ȯ Ϸؾ ϴ ð (   )
+#define STRIPE_HANDSHAKE_SECOND	10
+
+//  ϴ Ϸ  ̵ . Ϸ Ŀ   ӽ  ٽ  ʵ Ѵ.
+#define STRIPE_MAX_DONE_ID		1024
+
+// ϴ ִ  ũ.   ˷ ũ ϰ chunk  ̸ Ѵ.
+#define STRIPE_MAX_FILE_SIZE	( (uint64_t)64 * 1024 * 1024 * 1024 )
+
+class CStripeSender;
+class CStripeConn;
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ۿ ϴ ϳ TCP 
+ */
+class CStripeStream
+{
+public:
+	CStripeStream();
+
+	CStripeSender * m_pclsSender;
+	Socket		m_hSocket;
+	pthread_t	m_sttThread;
+
+	/** Ű ȯ Ϸ ȣȭ ü. Ʈ  chunk  AEAD  Ѵ. */
+	CAeadCipher	m_clsCipher;
+
+	/**  Ȯ   chunk offset .  ϸ ٸ  Ѵ. */
+	std::list< uint64_t > m_clsSentList;
+
+	/**   ̱ Ͽ chunk    ʰ Ͽ true ̴. */
+	bool	m_bRetired;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief ϳ   TCP   Ѵ.
+ *	-  STRIPE_CHUNK_SIZE      Ϸϸ  chunk  Ƿ     Ѵ.
+ *	- STRIPE_TUNE_MS   ӵ Ͽ ӵ ϴ    2 辿 ø,      δ.
+ *	-  ϸ  Ȯ   chunk  ٸ  Ѵ.   ϸ ٽ Ͽ ó Ѵ.
+ *	-   SetPsk     Ű Ű ȯ Ϸ Ŀ AEAD  ȣȭϿ Ѵ.
+ *	-  ȣƮ  GetLocalSocketPath  Unix   Ͽ Ű ȯ , ϳ  ޸ äη Ѵ.
+ */
+class CStripeSender
+{
+public:
+	CStripeSender();
+	~CStripeSender();
+
+	void SetPsk( const std::string & strPsk );
+	bool Send( const char * pszIp, int iPort, const char * pszFileName, int iMaxStream = STRIPE_MAX_STREAM, int iInitStream = STRIPE_INIT_STREAM );
+
+	int GetStreamCount();
+	uint64_t GetFileSize();
+
+private:
+	static THREAD_API StreamThread( LPVOID lpParameter );
+
+	bool AddStream();
+	bool IsRemain();
+	bool SendLocal( Socket hUnix );
+	int GetHello( char * pszHello );
+	bool GetChunk( CStripeStream * pclsStream, uint64_t & iOffset );
+	void Close();
+
+	std::string	m_strIp;
+	int	m_iPort;
+	std::string	m_strPsk;
+
+	int	m_iFd;
+	uint64_t	m_iSize;
+	uint32_t	m_iTransferId;
+	std::string	m_strName;
+
+	pthread_mutex_t	m_sttMutex;
+
+	/**   chunk offset */
+	uint64_t	m_iNextOffset;
+
+	/**  chunk offset  */
+	std::list< uint64_t > m_clsRetryList;
+
+	/**  ũ */
+	uint64_t	m_iSendSize;
+
+	/** ǥ  . chunk  ϴ    chunk    Ѵ. */
+	int	m_iTargetCount;
+
+	/** chunk  ϴ   */
+	int	m_iActiveCount;
+
+	/**   Ʈ thread . Ḧ ˸  Ȯ ٸ thread  Ѵ. */
+	int	m_iRunCount;
+	int	m_iFailCount;
+
+	std::vector< CStripeStream * > m_clsStreamList;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief   
+ */
+class CStripeFile
+{
+public:
+	CStripeFile();
+
+	int	m_iFd;
+	uint64_t	m_iSize;
+	std::string	m_strName;
+
+	/**  ϰ ִ   */
+	int	m_iStreamCount;
+
+	/** chunk   . ۵ chunk  ߺϿ  ʴ´. */
+	std::vector< bool > m_clsChunkList;
+	uint64_t	m_iChunkCount;
+};
+
+typedef std::map< uint32_t, CStripeFile > STRIPE_FILE_MAP;
+typedef std::set< uint32_t > STRIPE_ID_SET;
+typedef std::list< uint32_t > STRIPE_ID_LIST;
+
+/**
+ * @ingroup LibTelnet
+ * @brief CStripeSender   TCP  ϴ  Ѵ.
+ *	- Ḷ thread  ϰ SetPsk     Ű Ű ȯ Ϸ   Ѵ.
+ *	-  chunk  pwrite  ӽ  offset ġ Ѵ.
+ *	-  chunk  ϸ ӽ  Open      ̸ Ѵ.  ̸    ʴ´.
+ *	- Ϸ ۿ ʰ     ʰ  Ȯθ Ѵ.
+ *	- Unix       ޸ äη   ͸ Ѵ.
+ */
+class CStripeReceiver
+{
+public:
+	CStripeReceiver();
+	~CStripeReceiver();
+
+	void SetPsk( const std::string & strPsk );
+	bool Open( const char * pszDir );
+	bool Add( Socket hSocket, bool bLocal = false );
+	int GetFileCount();
+
+private:
+	static THREAD_API StreamThread( LPVOID lpParameter );
+
+	void Recv( CStripeConn & clsConn );
+	bool OpenFile( uint32_t iTransferId, uint64_t iSize, const std::string & strName, int & iFd, bool & bDone );
+	void RecvDone( CStripeConn & clsConn, uint32_t iTransferId );
+	void CloseFile( uint32_t iTransferId );
+	void GetPartFileName( uint32_t iTransferId, std::string & strFileName );
+
+	std::string	m_strDir;
+	std::string	m_strPsk;
+
+	pthread_mutex_t	m_sttMutex;
+	STRIPE_FILE_MAP	m_clsFileMap;
+	int	m_iStreamCount;
+
+	/**  chunk    ̵.   ̸ STRIPE_MAX_DONE_ID    ͺ Ѵ. */
+	STRIPE_ID_SET		m_clsDoneSet;
+	STRIPE_ID_LIST	m_clsDoneList;
+};
+
+#endif
+
+#endif
@@ -18,6 +18,7 @@
 
 #include "Define.h"
 #include "Tcp.h"
+#include "Log.h"
 #include "MemoryDebug.h"
 
 #ifdef WIN32
@@ -60,10 +61,10 @@ void TcpSetPollIn( struct pollfd & sttPollFd, Socket hSocket )
 	sttPollFd.revents = 0;
 }
 
-#ifdef WIN32
+#ifdef WINXP
 /** 
  * @ingroup SipPlatform
- * @brief  poll ޼ҵ
+ * @brief  XP  poll ޼ҵ.  XP   WSAPoll  Ѵ.
  *	-  read event  ó  ִ.
  */
 int poll( struct pollfd *fds, unsigned int nfds, int timeout )
@@ -183,124 +184,286 @@ done:
 #endif
 
 /**
- * @ingroup SipPlatform
- * @brief ȣƮ ̸ IP ּҸ ˻Ѵ.
- * @param szHostName	ȣƮ ̸
- * @param szIp				IP ּҸ  
- * @param iLen				IP ּҸ   ũ
- * @returns ϸ true  ϰ ׷  false  Ѵ.
+ * @ingroup LibTelnet
+ * @brief IPv4 ּ ü å Ŭ
  */
-bool GetIpByName( const char * szHostName, char * szIp, int iLen )
+class CIpv4Family
 {
-	struct	hostent	* hptr;
+public:
+	static int GetFamily() { return AF_INET; }
+	static socklen_t GetAddrLen() { return sizeof(struct sockaddr_in); }
 
-	if( (hptr = gethostbyname(szHostName)) == NULL ) return false;
-	
-#ifdef WINXP
-	snprintf( szIp, iLen, "%s", inet_ntoa( *(struct in_addr *)hptr->h_addr_list[0] ));
-#else
-	inet_ntop( AF_INET, (struct in_addr *)hptr->h_addr_list[0], szIp, iLen );
+	static void * GetIp( struct sockaddr_storage & sttAddr ) { return &((struct sockaddr_in *)&sttAddr)->sin_addr; }
+	static void SetAny( struct sockaddr_storage & sttAddr ) { ((struct sockaddr_in *)&sttAddr)->sin_addr.s_addr = INADDR_ANY; }
+
+	static int GetPort( const struct sockaddr_storage & sttAddr ) { return ntohs( ((const struct sockaddr_in *)&sttAddr)->sin_port ); }
+	static void SetPort( struct sockaddr_storage & sttAddr, int iPort )
+	{
+		((struct sockaddr_in *)&sttAddr)->sin_family = AF_INET;
+		((struct sockaddr_in *)&sttAddr)->sin_port = htons(iPort);
+	}
+};
+
+#ifndef WINXP
+/**
+ * @ingroup LibTelnet
+ * @brief IPv6 ּ ü å Ŭ
+ */
+class CIpv6Family
+{
+public:
+	static int GetFamily() { return AF_INET6; }
+	static socklen_t GetAddrLen() { return sizeof(struct sockaddr_in6); }
+
+	static void * GetIp( struct sockaddr_storage & sttAddr ) { return &((struct sockaddr_in6 *)&sttAddr)->sin6_addr; }
+	static void SetAny( struct sockaddr_storage & sttAddr ) { ((struct sockaddr_in6 *)&sttAddr)->sin6_addr = in6addr_any; }
+
+	static int GetPort( const struct sockaddr_storage & sttAddr ) { return ntohs( ((const struct sockaddr_in6 *)&sttAddr)->sin6_port ); }
+	static void SetPort( struct sockaddr_storage & sttAddr, int iPort )
+	{
+		((struct sockaddr_in6 *)&sttAddr)->sin6_family = AF_INET6;
+		((struct sockaddr_in6 *)&sttAddr)->sin6_port = htons(iPort);
+	}
+};
 #endif
 
-	return true;
-}
+#if defined WINXP
+/**
+ * @ingroup LibTelnet
+ * @brief  XP  å Ŭ
+ *	- inet_pton/inet_ntop  Ƿ IPv4  Ѵ.
+ */
+class CSocketOs
+{
+public:
+	static bool PtoN( int iFamily, const char * pszIp, void * pAddr )
+	{
+		((struct in_addr *)pAddr)->s_addr = inet_addr( pszIp );
+		return true;
+	}
+
+	static void NtoP( int iFamily, const void * pAddr, char * pszIp, int iIpSize )
+	{
+		snprintf( pszIp, iIpSize, "%s", inet_ntoa( *(const struct in_addr *)pAddr ) );
+	}
 
+	static int Connect( Socket fd, const struct sockaddr * psttAddr, socklen_t iAddrLen, int iTimeout )
+	{
+		return connect( fd, psttAddr, iAddrLen );
+	}
+};
+#elif defined WIN32
 /**
- * @ingroup SipPlatform
- * @brief TCP  Ѵ.
- * @param pszIp			TCP  IP ּ
- * @param iPort			TCP  Ʈ ȣ
- * @param iTimeout	 timeout ð ( ʴ ) - 0 ̻ ؾ  timeout  Ѵ.
- * @returns ϸ  TCP  ϰ ׷  INVALID_SOCKET  Ѵ.
+ * @ingroup LibTelnet
+ * @brief   å Ŭ
  */
-Socket TcpConnect( const char * pszIp, int iPort, int iTimeout )
+class CSocketOs
 {
-	char		szIp[INET6_ADDRSTRLEN];
-	Socket	fd;
+public:
+	static bool PtoN( int iFamily, const char * pszIp, void * pAddr )
+	{
+		return inet_pton( iFamily, pszIp, pAddr ) == 1;
+	}
 
-	memset( szIp, 0, sizeof(szIp) );
-	if( isdigit(pszIp[0]) == 0 )
+	static void NtoP( int iFamily, const void * pAddr, char * pszIp, int iIpSize )
 	{
-		// if first character is not digit, suppose it is domain main.
-		GetIpByName( pszIp, szIp, sizeof(szIp) );
+		inet_ntop( iFamily, (void *)pAddr, pszIp, iIpSize );
 	}
-	else
+
+	static int Connect( Socket fd, const struct sockaddr * psttAddr, socklen_t iAddrLen, int iTimeout )
 	{
-		snprintf( szIp, sizeof(szIp), "%s", pszIp );
+		return connect( fd, psttAddr, iAddrLen );
+	}
+};
+#else
+/**
+ * @ingroup LibTelnet
+ * @brief   å Ŭ
+ */
+class CSocketOs
+{
+public:
+	static bool PtoN( int iFamily, const char * pszIp, void * pAddr )
+	{
+		return inet_pton( iFamily, pszIp, pAddr ) == 1;
 	}
 
-#ifndef WINXP
-	if( strstr( szIp, ":" ) )
+	static void NtoP( int iFamily, const void * pAddr, char * pszIp, int iIpSize )
 	{
-		struct	sockaddr_in6	addr;		
+		inet_ntop( iFamily, pAddr, pszIp, iIpSize );
+	}
 
-		// connect server.
-		if( ( fd = socket( AF_INET, SOCK_STREAM, 0 )) == INVALID_SOCKET )
+	static int Connect( Socket fd, const struct sockaddr * psttAddr, socklen_t iAddrLen, int iTimeout )
+	{
+		if( iTimeout > 0 ) return ConnectTimeout( fd, psttAddr, iAddrLen, iTimeout );
+
+		return connect( fd, psttAddr, iAddrLen );
+	}
+};
+#endif
+
+/**
+ * @ingroup LibTelnet
+ * @brief ּ ü OS å Ŭ  ð ƯȭǴ TCP  Ŭ
+ *	-  ּҴ sockaddr_storage  óϹǷ IPv4/IPv6 ڵ尡 ߺ ʴ´.
+ */
+template< class TFamily, class TOs >
+class CSocketBackend
+{
+public:
+	static Socket Connect( const char * pszIp, int iPort, int iTimeout )
+	{
+		struct sockaddr_storage sttAddr;
+		Socket	fd;
+
+		memset( &sttAddr, 0, sizeof(sttAddr) );
+		TFamily::SetPort( sttAddr, iPort );
+
+		if( TOs::PtoN( TFamily::GetFamily(), pszIp, TFamily::GetIp( sttAddr ) ) == false )
+		{
+			return INVALID_SOCKET;
+		}
+
+		if( ( fd = socket( TFamily::GetFamily(), SOCK_STREAM, 0 )) == INVALID_SOCKET )
+		{
+			return INVALID_SOCKET;
+		}
+
+		if( TOs::Connect( fd, (struct sockaddr *)&sttAddr, TFamily::GetAddrLen(), iTimeout ) != 0 )
 		{
+			closesocket( fd );
 			return INVALID_SOCKET;
 		}
 
-		addr.sin6_family = AF_INET6;
-		addr.sin6_port   = htons(iPort);
+		return fd;
+	}
+
+	static Socket Listen( int iPort, int iListenQ, const char * pszIp )
+	{
+		struct sockaddr_storage sttAddr;
+		Socket	fd;
+		const 	int		on = 1;
 
-		inet_pton( AF_INET6, szIp, &addr.sin6_addr );
+		memset( &sttAddr, 0, sizeof(sttAddr) );
+		TFamily::SetPort( sttAddr, iPort );
 
-#ifndef WIN32
-		if( iTimeout > 0 )
+		if( pszIp )
 		{
-			if( ConnectTimeout( fd, (struct sockaddr *)&addr, sizeof(addr), iTimeout ) != 0 )
+			if( TOs::PtoN( TFamily::GetFamily(), pszIp, TFamily::GetIp( sttAddr ) ) == false )
 			{
-				closesocket( fd );
 				return INVALID_SOCKET;
 			}
 		}
 		else
-#endif
-		if( connect( fd, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR )
 		{
+			TFamily::SetAny( sttAddr );
+		}
+
+		// create socket.
+		if( ( fd = socket( TFamily::GetFamily(), SOCK_STREAM, 0 )) == INVALID_SOCKET )
+		{
+			return INVALID_SOCKET;
+		}
+
+		if( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, (char *)&on, sizeof(on)) == -1 )
+		{
+			//  Ŀ TIME_WAIT    bind    ִ.
+			CLog::Print( LOG_ERROR, "TcpListen setsockopt(SO_REUSEADDR) port(%d) error(%d)", iPort, GetError() );
+		}
+
+		if( bind( fd, (struct sockaddr *)&sttAddr, TFamily::GetAddrLen() ) == SOCKET_ERROR )
+		{
+			CLog::Print( LOG_ERROR, "TcpListen bind port(%d) error(%d)", iPort, GetError() );
 			closesocket( fd );
 			return INVALID_SOCKET;
 		}
-	}
-	else
-#endif
-	{
-		struct	sockaddr_in	addr;		
 
-		// connect server.
-		if( ( fd = socket( AF_INET, SOCK_STREAM, 0 )) == INVALID_SOCKET )
+		if( listen( fd, iListenQ ) == SOCKET_ERROR )
 		{
+			CLog::Print( LOG_ERROR, "TcpListen listen port(%d) error(%d)", iPort, GetError() );
+			closesocket( fd );
 			return INVALID_SOCKET;
 		}
-	
-		addr.sin_family = AF_INET;
-		addr.sin_port   = htons(iPort);
-	
-#ifdef WINXP
-		addr.sin_addr.s_addr = inet_addr( szIp );
-#else
-		inet_pton( AF_INET, szIp, &addr.sin_addr.s_addr );
-#endif
 
-#ifndef WIN32
-		if( iTimeout > 0 )
+		return fd;
+	}
+
+	static Socket Accept( Socket hListenFd, char * pszIp, int iIpSize, int * piPort )
+	{
+		struct sockaddr_storage sttAddr;
+		socklen_t	iAddrLen = sizeof(sttAddr);
+		Socket		hConnFd;
+
+		hConnFd = accept( hListenFd, (struct sockaddr *)&sttAddr, &iAddrLen );
+		if( hConnFd != INVALID_SOCKET )
 		{
-			if( ConnectTimeout( fd, (struct sockaddr *)&addr, sizeof(addr), iTimeout ) != 0 )
+			if( piPort ) *piPort = TFamily::GetPort( sttAddr );
+
+			if( pszIp && iIpSize > 0 )
 			{
-				closesocket( fd );
-				return INVALID_SOCKET;
+				TOs::NtoP( TFamily::GetFamily(), TFamily::GetIp( sttAddr ), pszIp, iIpSize );
 			}
 		}
-		else
+
+		return hConnFd;
+	}
+};
+
+typedef CSocketBackend< CIpv4Family, CSocketOs > CIpv4Socket;
+#ifndef WINXP
+typedef CSocketBackend< CIpv6Family, CSocketOs > CIpv6Socket;
 #endif
-		if( connect( fd, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR )
-		{
-			closesocket( fd );
-			return INVALID_SOCKET;
-		}
+
+/**
+ * @ingroup SipPlatform
+ * @brief ȣƮ ̸ IP ּҸ ˻Ѵ.
+ * @param szHostName	ȣƮ ̸
+ * @param szIp				IP ּҸ  
+ * @param iLen				IP ּҸ   ũ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool GetIpByName( const char * szHostName, char * szIp, int iLen )
+{
+	struct	hostent	* hptr;
+
+	if( (hptr = gethostbyname(szHostName)) == NULL ) return false;
+
+	CSocketOs::NtoP( AF_INET, hptr->h_addr_list[0], szIp, iLen );
+
+	return true;
+}
+
+/**
+ * @ingroup SipPlatform
+ * @brief TCP  Ѵ.
+ * @param pszIp			TCP  IP ּ
+ * @param iPort			TCP  Ʈ ȣ
+ * @param iTimeout	 timeout ð ( ʴ ) - 0 ̻ ؾ  timeout  Ѵ.
+ * @returns ϸ  TCP  ϰ ׷  INVALID_SOCKET  Ѵ.
+ */
+Socket TcpConnect( const char * pszIp, int iPort, int iTimeout )
+{
+	char		szIp[INET6_ADDRSTRLEN];
+
+	memset( szIp, 0, sizeof(szIp) );
+	if( isdigit(pszIp[0]) == 0 && strchr( pszIp, ':' ) == NULL )
+	{
+		// if first character is not digit, suppose it is domain main.
+		GetIpByName( pszIp, szIp, sizeof(szIp) );
+	}
+	else
+	{
+		snprintf( szIp, sizeof(szIp), "%s", pszIp );
+	}
+
+#ifndef WINXP
+	if( strstr( szIp, ":" ) )
+	{
+		return CIpv6Socket::Connect( szIp, iPort, iTimeout );
 	}
+#endif
 
-	return fd;
+	return CIpv4Socket::Connect( szIp, iPort, iTimeout );
 }
 
 /** 
@@ -397,93 +560,14 @@ int TcpRecvSize( Socket fd, char * szBuf, int iBufLen, int iSecond )
  */
 Socket TcpListen( int iPort, int iListenQ, const char * pszIp, bool bIpv6 )
 {
-	Socket	fd;
-	const 	int		on = 1;
-
 #ifndef WINXP
 	if( bIpv6 )
 	{
-		struct	sockaddr_in6	addr;
-
-		// create socket.
-		if( ( fd = socket( AF_INET6, SOCK_STREAM, 0 )) == INVALID_SOCKET )
-		{
-			return INVALID_SOCKET;
-		}
-		
-		memset( &addr, 0, sizeof(addr));
-		
-		addr.sin6_family = AF_INET6;
-		addr.sin6_port   = htons(iPort);
-
-		if( pszIp )
-		{
-			inet_pton( AF_INET6, pszIp, &addr.sin6_addr );
-		}
-		else
-		{
-			addr.sin6_addr = in6addr_any;	
-		}
-
-		if( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, (char *)&on, sizeof(on)) == -1 )
-		{
-			
-		}
-
-		if( bind( fd, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR )
-		{
-			closesocket( fd );
-			return INVALID_SOCKET;
-		}
+		return CIpv6Socket::Listen( iPort, iListenQ, pszIp );
 	}
-	else
-#endif
-	{
-		struct	sockaddr_in	addr;
-	
-		// create socket.
-		if( ( fd = socket( AF_INET, SOCK_STREAM, 0 )) == INVALID_SOCKET )
-		{
-			return INVALID_SOCKET;
-		}
-		
-		memset( &addr, 0, sizeof(addr));
-		
-		addr.sin_family = AF_INET;
-		addr.sin_port   = htons(iPort);
-	
-		if( pszIp )
-		{
-#ifdef WINXP
-			addr.sin_addr.s_addr = inet_addr(pszIp);
-#else
-			inet_pton( AF_INET, pszIp, &addr.sin_addr.s_addr );
 #endif
-		}
-		else
-		{
-			addr.sin_addr.s_addr = INADDR_ANY;	
-		}
-	
-		if( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, (char *)&on, sizeof(on)) == -1 )
-		{
-			
-		}
-	
-		if( bind( fd, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR )
-		{
-			closesocket( fd );
-			return INVALID_SOCKET;
-		}
-	}
-
-	if( listen( fd, iListenQ ) == SOCKET_ERROR )
-	{
-		closesocket( fd );
-		return INVALID_SOCKET;
-	}
 
-	return fd;
+	return CIpv4Socket::Listen( iPort, iListenQ, pszIp );
 }
 
 /**
@@ -499,45 +583,12 @@ Socket TcpListen( int iPort, int iListenQ, const char * pszIp, bool bIpv6 )
  */
 Socket TcpAccept( Socket hListenFd, char * pszIp, int iIpSize, int * piPort, bool bIpv6 )
 {
-	socklen_t		iAddrLen;
-	Socket			hConnFd;
-
 #ifndef WINXP
 	if( bIpv6 )
 	{
-		struct sockaddr_in6 sttAddr;
-		iAddrLen = sizeof(sttAddr);
-		hConnFd = accept( hListenFd, (struct sockaddr *)&sttAddr, &iAddrLen );
-		if( hConnFd != INVALID_SOCKET )
-		{
-			if( piPort ) *piPort = ntohs( sttAddr.sin6_port );
-
-			if( pszIp && iIpSize > 0 )
-			{
-				inet_ntop( AF_INET6, &sttAddr.sin6_addr, pszIp, iIpSize );
-			}
-		}
+		return CIpv6Socket::Accept( hListenFd, pszIp, iIpSize, piPort );
 	}
-	else
 #endif
-	{
-		struct sockaddr_in sttAddr;
-		iAddrLen = sizeof(sttAddr);
-		hConnFd = accept( hListenFd, (struct sockaddr *)&sttAddr, &iAddrLen );
-		if( hConnFd != INVALID_SOCKET )
-		{
-			if( piPort ) *piPort = ntohs( sttAddr.sin_port );
-	
-			if( pszIp && iIpSize > 0 )
-			{
-#ifdef WINXP
-				snprintf( pszIp, iIpSize, "%s", inet_ntoa( sttAddr.sin_addr ) );
-#else
-				inet_ntop( AF_INET, &sttAddr.sin_addr, pszIp, iIpSize );
-#endif
-			}
-		}
-	}
 
-	return hConnFd;
+	return CIpv4Socket::Accept( hListenFd, pszIp, iIpSize, piPort );
 }
@@ -20,6 +20,7 @@
 #define _TCP_H_
 
 #include <string>
+#include "Define.h"
 
 #ifdef WIN32
 
@@ -32,7 +33,12 @@ typedef int socklen_t;
 typedef SOCKET Socket;
 
 inline int GetError() { return WSAGetLastError(); }
+
+#ifdef WINXP
 int poll( struct pollfd *fds, unsigned int nfds, int timeout );
+#else
+inline int poll( struct pollfd *fds, unsigned int nfds, int timeout ) { return WSAPoll( fds, nfds, timeout ); }
+#endif
 
 #else
 
@@ -0,0 +1,774 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "Teardown.h"
+
+#ifndef WIN32
+
+#include "Log.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include "MemoryDebug.h"
+
+// Run  ѹ óϴ epoll ̺Ʈ 
+#define TEARDOWN_EVENT_COUNT	256
+
+// ϳ ̺Ʈ FIN    ͸  ִ Ƚ
+#define TEARDOWN_DRAIN_COUNT	16
+
+/**
+ * @ingroup LibTelnet
+ * @brief monotonic ð milli second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicMs()
+{
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000 + sttTime.tv_nsec / 1000000;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ڽ μ μ ׷ μ ñ׳ Ѵ.
+ * @param iPid		ڽ μ ̵
+ * @param iSignal	ñ׳
+ */
+static void KillChild( int iPid, int iSignal )
+{
+	// shell  setsid  μ ׷  ǹǷ shell   μ Բ Ѵ.
+	if( kill( -iPid, iSignal ) == -1 )
+	{
+		kill( iPid, iSignal );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CTeardownSocket::CTeardownSocket()
+{
+	Clear();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   ʱȭѴ.
+ */
+void CTeardownSocket::Clear()
+{
+	m_hSocket = INVALID_SOCKET;
+	m_iDeadline = 0;
+	m_pclsPrev = NULL;
+	m_pclsNext = NULL;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief 
+ */
+CTeardown::CTeardown() : m_hEpoll(-1), m_hSignal(-1), m_iLingerSecond(TEARDOWN_LINGER_SECOND), m_iRequestPos(0)
+	, m_pclsHead(NULL), m_pclsTail(NULL), m_iDrainCount(0), m_iScanCount(0)
+{
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ҹ
+ */
+CTeardown::~CTeardown()
+{
+	Close();
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief SIGCHLD  signalfd  ϵ ϰ epoll  Ѵ.
+ *	- SIGCHLD   thread  block Ǿ ϹǷ thread  ϱ  ȣؾ Ѵ.
+ *	- ڽ μ signal mask  ϹǷ fork  exec  RestoreChildSignal  ȣؾ Ѵ.
+ * @param iLingerSecond	   FIN  ٸ ð (   )
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CTeardown::Open( int iLingerSecond )
+{
+	if( m_hEpoll != -1 ) return true;
+
+	sigset_t sttMask;
+
+	sigemptyset( &sttMask );
+	sigaddset( &sttMask, SIGCHLD );
+
+	if( sigprocmask( SIG_BLOCK, &sttMask, NULL ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s sigprocmask error(%d)", __FUNCTION__, errno );
+		return false;
+	}
+
+	m_hSignal = signalfd( -1, &sttMask, SFD_NONBLOCK | SFD_CLOEXEC );
+	if( m_hSignal == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s signalfd error(%d)", __FUNCTION__, errno );
+		Close();
+		return false;
+	}
+
+	m_hEpoll = epoll_create1( EPOLL_CLOEXEC );
+	if( m_hEpoll == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s epoll_create1 error(%d)", __FUNCTION__, errno );
+		Close();
+		return false;
+	}
+
+	struct epoll_event sttEvent;
+
+	memset( &sttEvent, 0, sizeof(sttEvent) );
+	sttEvent.events = EPOLLIN;
+	sttEvent.data.fd = m_hSignal;
+
+	if( epoll_ctl( m_hEpoll, EPOLL_CTL_ADD, m_hSignal, &sttEvent ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s epoll_ctl error(%d)", __FUNCTION__, errno );
+		Close();
+		return false;
+	}
+
+	m_iLingerSecond = iLingerSecond;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ó   û FIN  ٸ    ϰ signalfd  epoll  Ѵ.
+ */
+void CTeardown::Close()
+{
+	if( m_hEpoll == -1 && m_hSignal == -1 ) return;
+
+	Flush();
+
+	std::map< int, int >::iterator itMap;
+
+	for( itMap = m_clsPidFdMap.begin(); itMap != m_clsPidFdMap.end(); ++itMap )
+	{
+		close( itMap->first );
+	}
+
+	m_clsPidFdMap.clear();
+	m_clsChildMap.clear();
+	m_iScanCount = 0;
+
+	if( m_hEpoll != -1 )
+	{
+		close( m_hEpoll );
+		m_hEpoll = -1;
+	}
+
+	if( m_hSignal != -1 )
+	{
+		close( m_hSignal );
+		m_hSignal = -1;
+	}
+
+	sigset_t sttMask;
+
+	sigemptyset( &sttMask );
+	sigaddset( &sttMask, SIGCHLD );
+	sigprocmask( SIG_UNBLOCK, &sttMask, NULL );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ó   û FIN  ٸ    Ѵ.
+ */
+void CTeardown::Flush()
+{
+	for( ; m_iRequestPos < m_clsRequestList.size(); ++m_iRequestPos )
+	{
+		Process( m_clsRequestList[m_iRequestPos] );
+	}
+
+	m_clsRequestList.clear();
+	m_iRequestPos = 0;
+
+	while( m_pclsHead )
+	{
+		CloseSocket( m_pclsHead, true );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief fork  ڽ μ Open  block  SIGCHLD  Ѵ. exec  ȣؾ Ѵ.
+ */
+void CTeardown::RestoreChildSignal()
+{
+	sigset_t sttMask;
+
+	sigemptyset( &sttMask );
+	sigaddset( &sttMask, SIGCHLD );
+	sigprocmask( SIG_UNBLOCK, &sttMask, NULL );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Ḧ ûѴ.   Run  ϹǷ 뷮 ȣص ٷ Ѵ.
+ *	- ̹ ȸ ڽ μ ̵ Ǿ  Ƿ iPid  ϸ  ȴ.
+ * @param hSocket	 .  INVALID_SOCKET
+ * @param iPtyFd	PTY master ڵ.  -1
+ * @param iPid		shell μ ̵.  -1
+ * @param eMode		  
+ */
+void CTeardown::Add( Socket hSocket, int iPtyFd, int iPid, ETeardownMode eMode )
+{
+	CTeardownRequest clsRequest;
+
+	clsRequest.m_hSocket = hSocket;
+	clsRequest.m_iPtyFd = iPtyFd;
+	clsRequest.m_iPid = iPid;
+	clsRequest.m_eMode = eMode;
+
+	// Open  ʾ Run  ȣ Ƿ ٷ Ѵ.
+	if( m_hEpoll == -1 )
+	{
+		Process( clsRequest );
+		return;
+	}
+
+	m_clsRequestList.push_back( clsRequest );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ǹ ȸ ڽ μ Ѵ. ȸ ڽ μ PopExit  ´.
+ *	- fork  Ŀ ȣؾ Ѵ. ̹  ڽ μ Ͽ ȸȴ.
+ * @param iPid ڽ μ ̵
+ */
+void CTeardown::AddChild( int iPid )
+{
+	if( iPid <= 0 || m_clsChildMap.find( iPid ) != m_clsChildMap.end() ) return;
+
+	int iPidFd = -1;
+
+#ifdef SYS_pidfd_open
+	if( m_hEpoll != -1 )
+	{
+		// pidfd  ׻ close-on-exec  ȴ.
+		iPidFd = (int)syscall( SYS_pidfd_open, iPid, 0 );
+		if( iPidFd != -1 )
+		{
+			struct epoll_event sttEvent;
+
+			memset( &sttEvent, 0, sizeof(sttEvent) );
+			sttEvent.events = EPOLLIN;
+			sttEvent.data.fd = iPidFd;
+
+			if( epoll_ctl( m_hEpoll, EPOLL_CTL_ADD, iPidFd, &sttEvent ) == -1 )
+			{
+				close( iPidFd );
+				iPidFd = -1;
+			}
+		}
+	}
+#endif
+
+	m_clsChildMap.insert( std::map< int, int >::value_type( iPid, iPidFd ) );
+
+	if( iPidFd == -1 )
+	{
+		++m_iScanCount;
+
+		// ϱ   ڽ μ SIGCHLD  ̹ óǾ  ִ.
+		ReapChild( iPid );
+	}
+	else
+	{
+		m_clsPidFdMap.insert( std::map< int, int >::value_type( iPidFd, iPid ) );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ڽ μ ȸ, FIN ,  û, ð ʰ ó Ѵ. GetFd  ̺Ʈ ְų GetTimeout   ȣѴ.
+ */
+void CTeardown::Run()
+{
+	if( m_hEpoll == -1 ) return;
+
+	struct epoll_event arrEvent[TEARDOWN_EVENT_COUNT];
+	int n = epoll_wait( m_hEpoll, arrEvent, TEARDOWN_EVENT_COUNT, 0 );
+
+	for( int i = 0; i < n; ++i )
+	{
+		std::map< int, int >::iterator itPidFd;
+
+		if( arrEvent[i].data.fd == m_hSignal )
+		{
+			Reap();
+		}
+		else if( ( itPidFd = m_clsPidFdMap.find( arrEvent[i].data.fd ) ) != m_clsPidFdMap.end() )
+		{
+			ReapChild( itPidFd->second );
+		}
+		else
+		{
+			Drain( arrEvent[i].data.fd );
+		}
+	}
+
+	//  û TEARDOWN_BATCH_SIZE  óϰ   Run  óѴ.
+	size_t iEnd = m_iRequestPos + TEARDOWN_BATCH_SIZE;
+	if( iEnd > m_clsRequestList.size() ) iEnd = m_clsRequestList.size();
+
+	for( ; m_iRequestPos < iEnd; ++m_iRequestPos )
+	{
+		Process( m_clsRequestList[m_iRequestPos] );
+	}
+
+	if( m_iRequestPos == m_clsRequestList.size() )
+	{
+		m_clsRequestList.clear();
+		m_iRequestPos = 0;
+	}
+
+	uint64_t iNow = GetMonotonicMs();
+
+	// FIN     RST  Ѵ.   ð ̴.
+	while( m_pclsHead && m_pclsHead->m_iDeadline <= iNow )
+	{
+		CloseSocket( m_pclsHead, true );
+	}
+
+	// SIGHUP    shell  SIGKILL  Ѵ.
+	while( m_clsKillList.empty() == false && m_clsKillList.front().second <= iNow )
+	{
+		int iPid = m_clsKillList.front().first;
+
+		if( m_clsChildMap.find( iPid ) != m_clsChildMap.end() )
+		{
+			CLog::Print( LOG_INFO, "%s pid(%d) SIGKILL", __FUNCTION__, iPid );
+			KillChild( iPid, SIGKILL );
+		}
+
+		m_clsKillList.pop_front();
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ׷̵ ο μ    ϰ ȸ  ڽ μ ´.
+ *	- ó   û  óϹǷ exec  FIN  ٸ  RST   ʾƵ ȴ.
+ *	-  μ ´  Ƿ exec  ϸ  Ḧ óѴ.
+ * @param clsList   ϰ ڽ μ  Ʈ
+ */
+void CTeardown::Export( HANDOVER_TEARDOWN_LIST & clsList )
+{
+	for( ; m_iRequestPos < m_clsRequestList.size(); ++m_iRequestPos )
+	{
+		Process( m_clsRequestList[m_iRequestPos] );
+	}
+
+	m_clsRequestList.clear();
+	m_iRequestPos = 0;
+
+	uint64_t iNow = GetMonotonicMs();
+
+	for( CTeardownSocket * pclsSocket = m_pclsHead; pclsSocket; pclsSocket = pclsSocket->m_pclsNext )
+	{
+		clsList.push_back( CHandoverTeardown( pclsSocket->m_hSocket, -1, ( pclsSocket->m_iDeadline > iNow ) ? (uint32_t)( pclsSocket->m_iDeadline - iNow ) : 0 ) );
+	}
+
+	std::map< int, uint64_t > clsKillMap;
+	std::map< int, uint64_t >::iterator itKill;
+	std::map< int, int >::iterator itChild;
+
+	for( size_t i = 0; i < m_clsKillList.size(); ++i )
+	{
+		clsKillMap.insert( std::map< int, uint64_t >::value_type( m_clsKillList[i].first, m_clsKillList[i].second ) );
+	}
+
+	//  shell  Ѵ. ο μ  Import  ߺϿ Ͽ ѹ ȸѴ.
+	for( itChild = m_clsChildMap.begin(); itChild != m_clsChildMap.end(); ++itChild )
+	{
+		uint32_t iRemainMs = HANDOVER_NO_DEADLINE;
+
+		if( ( itKill = clsKillMap.find( itChild->first ) ) != clsKillMap.end() )
+		{
+			iRemainMs = ( itKill->second > iNow ) ? (uint32_t)( itKill->second - iNow ) : 0;
+		}
+
+		clsList.push_back( CHandoverTeardown( INVALID_SOCKET, itChild->first, iRemainMs ) );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief   μ    ϰ ڽ μ Ѵ.
+ *	-   ð   FIN  ٸ SIGHUP   ڽ μ  ð  SIGKILL  Ѵ.
+ * @param clsList   μ  Ʈ
+ */
+void CTeardown::Import( HANDOVER_TEARDOWN_LIST & clsList )
+{
+	HANDOVER_TEARDOWN_LIST::iterator itList;
+	std::vector< std::pair< uint64_t, int > > clsKillList;
+	uint64_t iNow = GetMonotonicMs();
+
+	for( itList = clsList.begin(); itList != clsList.end(); ++itList )
+	{
+		if( itList->m_hSocket != INVALID_SOCKET )
+		{
+			if( m_hEpoll == -1 || AddDrain( itList->m_hSocket, iNow + itList->m_iRemainMs ) == false )
+			{
+				Add( itList->m_hSocket, -1, -1, E_TM_ABORT );
+			}
+		}
+
+		if( itList->m_iPid > 0 )
+		{
+			AddChild( itList->m_iPid );
+
+			if( itList->m_iRemainMs != HANDOVER_NO_DEADLINE )
+			{
+				clsKillList.push_back( std::pair< uint64_t, int >( iNow + itList->m_iRemainMs, itList->m_iPid ) );
+			}
+		}
+	}
+
+	// Run  SIGKILL  ð  Ѵ.
+	std::sort( clsKillList.begin(), clsKillList.end() );
+
+	for( size_t i = 0; i < clsKillList.size(); ++i )
+	{
+		m_clsKillList.push_back( std::pair< int, uint64_t >( clsKillList[i].second, clsKillList[i].first ) );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ̺Ʈ  poll  ڵ ´.
+ * @returns epoll ڵ Ѵ.
+ */
+Socket CTeardown::GetFd()
+{
+	return m_hEpoll;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  Run  ȣؾ ϴ ð ´.
+ * @returns poll timeout ( milli second )  Ѵ.  ۾  -1  Ѵ.
+ */
+int CTeardown::GetTimeout()
+{
+	if( m_iRequestPos < m_clsRequestList.size() ) return 0;
+
+	uint64_t iDeadline = 0;
+
+	if( m_pclsHead ) iDeadline = m_pclsHead->m_iDeadline;
+
+	if( m_clsKillList.empty() == false )
+	{
+		if( iDeadline == 0 || m_clsKillList.front().second < iDeadline ) iDeadline = m_clsKillList.front().second;
+	}
+
+	if( iDeadline == 0 ) return -1;
+
+	uint64_t iNow = GetMonotonicMs();
+	if( iDeadline <= iNow ) return 0;
+
+	return (int)( iDeadline - iNow );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief ȸ ڽ μ ´.
+ * @param iPid		ڽ μ ̵  
+ * @param iStatus	waitpid  ¸  
+ * @returns ȸ ڽ μ  true  ϰ ׷  false  Ѵ.
+ */
+bool CTeardown::PopExit( int & iPid, int & iStatus )
+{
+	if( m_clsExitList.empty() ) return false;
+
+	iPid = m_clsExitList.front().first;
+	iStatus = m_clsExitList.front().second;
+	m_clsExitList.pop_front();
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  FIN  ٸ   ´.
+ * @returns  FIN  ٸ   Ѵ.
+ */
+int CTeardown::GetDrainCount()
+{
+	return m_iDrainCount;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  û óѴ.
+ * @param clsRequest  û
+ */
+void CTeardown::Process( CTeardownRequest & clsRequest )
+{
+	// PTY master   shell  SIGHUP  ۵ȴ.
+	if( clsRequest.m_iPtyFd >= 0 )
+	{
+		close( clsRequest.m_iPtyFd );
+	}
+
+	if( clsRequest.m_iPid > 0 )
+	{
+		KillChild( clsRequest.m_iPid, SIGHUP );
+
+		// AddChild  ϵ  shell  ȸѴ.
+		AddChild( clsRequest.m_iPid );
+		m_clsKillList.push_back( std::pair< int, uint64_t >( clsRequest.m_iPid, GetMonotonicMs() + TEARDOWN_KILL_SECOND * 1000 ) );
+	}
+
+	Socket hSocket = clsRequest.m_hSocket;
+	if( hSocket == INVALID_SOCKET ) return;
+
+	if( clsRequest.m_eMode == E_TM_GRACEFUL && m_hEpoll == -1 )
+	{
+		closesocket( hSocket );
+		return;
+	}
+
+	if( clsRequest.m_eMode == E_TM_GRACEFUL && m_iLingerSecond > 0 )
+	{
+		//  Ϳ FIN  ϰ close   FIN   Ŀ Ѵ.
+		if( shutdown( hSocket, SHUT_WR ) == 0 )
+		{
+			if( AddDrain( hSocket, GetMonotonicMs() + m_iLingerSecond * 1000 ) ) return;
+		}
+		else if( errno == ENOTCONN )
+		{
+			//  ̹  Ͽ.
+			closesocket( hSocket );
+			return;
+		}
+	}
+
+	struct linger sttLinger;
+
+	sttLinger.l_onoff = 1;
+	sttLinger.l_linger = 0;
+
+	setsockopt( hSocket, SOL_SOCKET, SO_LINGER, &sttLinger, sizeof(sttLinger) );
+	closesocket( hSocket );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief shutdown   epoll  ϰ FIN  ٸ    ڿ ߰Ѵ.
+ * @param hSocket		shutdown  
+ * @param iDeadline	 ð FIN   ϸ RST  Ѵ. ( monotonic milli second )
+ * @returns ϸ true  ϰ ׷  false  Ѵ. ϸ ȣڰ  ؾ Ѵ.
+ */
+bool CTeardown::AddDrain( Socket hSocket, uint64_t iDeadline )
+{
+	fcntl( hSocket, F_SETFL, fcntl( hSocket, F_GETFL ) | O_NONBLOCK );
+	fcntl( hSocket, F_SETFD, FD_CLOEXEC );
+
+	struct epoll_event sttEvent;
+
+	memset( &sttEvent, 0, sizeof(sttEvent) );
+	sttEvent.events = EPOLLIN | EPOLLRDHUP;
+	sttEvent.data.fd = hSocket;
+
+	if( epoll_ctl( m_hEpoll, EPOLL_CTL_ADD, hSocket, &sttEvent ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s epoll_ctl(%d) error(%d)", __FUNCTION__, hSocket, errno );
+		return false;
+	}
+
+	CTeardownSocket * pclsSocket = m_clsSocketPool.Get();
+
+	pclsSocket->m_hSocket = hSocket;
+	pclsSocket->m_iDeadline = iDeadline;
+	pclsSocket->m_pclsPrev = m_pclsTail;
+
+	if( m_pclsTail )
+	{
+		m_pclsTail->m_pclsNext = pclsSocket;
+	}
+	else
+	{
+		m_pclsHead = pclsSocket;
+	}
+
+	m_pclsTail = pclsSocket;
+	++m_iDrainCount;
+
+	if( hSocket >= (Socket)m_clsSocketList.size() ) m_clsSocketList.resize( hSocket + 1, NULL );
+	m_clsSocketList[hSocket] = pclsSocket;
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief FIN  ٸ  ŵ ͸  FIN  Ͽ  Ѵ.
+ * @param hSocket  ڵ
+ */
+void CTeardown::Drain( Socket hSocket )
+{
+	if( hSocket < 0 || hSocket >= (Socket)m_clsSocketList.size() || m_clsSocketList[hSocket] == NULL ) return;
+
+	char szBuf[4096];
+
+	for( int i = 0; i < TEARDOWN_DRAIN_COUNT; ++i )
+	{
+		int n = recv( hSocket, szBuf, sizeof(szBuf), MSG_DONTWAIT );
+		if( n > 0 ) continue;
+
+		if( n == -1 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ) return;
+
+		// FIN  Ͽų RST  Ͽ.
+		CloseSocket( m_clsSocketList[hSocket], false );
+		return;
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief FIN  ٸ  ϰ Ǯ ݳѴ.
+ * @param pclsSocket	FIN  ٸ 
+ * @param bAbort			RST  ϸ true  ԷѴ.
+ */
+void CTeardown::CloseSocket( CTeardownSocket * pclsSocket, bool bAbort )
+{
+	Socket hSocket = pclsSocket->m_hSocket;
+
+	// ڽ μ    close δ epoll  ŵ ʴ´.
+	epoll_ctl( m_hEpoll, EPOLL_CTL_DEL, hSocket, NULL );
+
+	if( bAbort )
+	{
+		struct linger sttLinger;
+
+		sttLinger.l_onoff = 1;
+		sttLinger.l_linger = 0;
+
+		setsockopt( hSocket, SOL_SOCKET, SO_LINGER, &sttLinger, sizeof(sttLinger) );
+	}
+
+	closesocket( hSocket );
+
+	if( pclsSocket->m_pclsPrev )
+	{
+		pclsSocket->m_pclsPrev->m_pclsNext = pclsSocket->m_pclsNext;
+	}
+	else
+	{
+		m_pclsHead = pclsSocket->m_pclsNext;
+	}
+
+	if( pclsSocket->m_pclsNext )
+	{
+		pclsSocket->m_pclsNext->m_pclsPrev = pclsSocket->m_pclsPrev;
+	}
+	else
+	{
+		m_pclsTail = pclsSocket->m_pclsPrev;
+	}
+
+	--m_iDrainCount;
+	m_clsSocketList[hSocket] = NULL;
+	m_clsSocketPool.Put( pclsSocket );
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief signalfd   SIGCHLD   а pidfd   ڽ μ ߿  μ ȸѴ.
+ *	-   ڽ μ ( ׷̵ ޽ ϴ μ  )    ȸϹǷ waitpid( -1 )  ȣ ʴ´.
+ *	- SIGCHLD    ϳ   Ƿ pidfd    ڽ μ ˻Ѵ.
+ */
+void CTeardown::Reap()
+{
+	struct signalfd_siginfo arrInfo[16];
+
+	while( read( m_hSignal, arrInfo, sizeof(arrInfo) ) > 0 );
+
+	if( m_iScanCount == 0 ) return;
+
+	std::vector< int > clsPidList;
+	std::map< int, int >::iterator itMap;
+
+	for( itMap = m_clsChildMap.begin(); itMap != m_clsChildMap.end(); ++itMap )
+	{
+		if( itMap->second == -1 ) clsPidList.push_back( itMap->first );
+	}
+
+	for( size_t i = 0; i < clsPidList.size(); ++i )
+	{
+		ReapChild( clsPidList[i] );
+	}
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ڽ μ Ǿ ȸϰ ȸ Ͽ ߰Ѵ.
+ * @param iPid ڽ μ ̵
+ */
+void CTeardown::ReapChild( int iPid )
+{
+	int iStatus;
+
+	int n = waitpid( iPid, &iStatus, WNOHANG );
+	if( n == 0 || ( n == -1 && errno == EINTR ) ) return;
+
+	std::map< int, int >::iterator itMap = m_clsChildMap.find( iPid );
+	if( itMap == m_clsChildMap.end() ) return;
+
+	if( itMap->second == -1 )
+	{
+		--m_iScanCount;
+	}
+	else
+	{
+		// close ϸ epoll  ڵ ŵȴ.
+		m_clsPidFdMap.erase( itMap->second );
+		close( itMap->second );
+	}
+
+	m_clsChildMap.erase( itMap );
+
+	// ٸ  ȸϿ ( ECHILD )  ¸   .
+	if( n == -1 ) iStatus = -1;
+
+	m_clsExitList.push_back( std::pair< int, int >( iPid, iStatus ) );
+}
+
+#endif
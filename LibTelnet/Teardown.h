@@ -0,0 +1,166 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _TEARDOWN_H_
+#define _TEARDOWN_H_
+
+#include "Define.h"
+#include "Tcp.h"
+#include "Handover.h"
+
+#ifndef WIN32
+
+#include <vector>
+#include <deque>
+#include <map>
+#include "ObjectPool.h"
+
+//    FIN  ٸ ⺻ ð (   ). ʰϸ RST  Ѵ.
+#define TEARDOWN_LINGER_SECOND	5
+
+// SIGHUP    shell    SIGKILL  ϱ ϴ ð (   )
+#define TEARDOWN_KILL_SECOND		3
+
+// Run  ѹ óϴ  û . 뷮   ̺Ʈ    ʵ Ѵ.
+#define TEARDOWN_BATCH_SIZE			256
+
+/**
+ * @ingroup LibTelnet
+ * @brief   
+ */
+enum ETeardownMode
+{
+	/** shutdown(SHUT_WR)   Ϳ FIN  ϰ  FIN  ٸ Ŀ Ѵ. */
+	E_TM_GRACEFUL = 0,
+
+	/** SO_LINGER 0  RST  Ͽ  Ѵ.   ʹ  TIME_WAIT   ʴ´. */
+	E_TM_ABORT
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  FIN  ٸ .  ð    Ʈ Ѵ.
+ */
+class CTeardownSocket
+{
+public:
+	CTeardownSocket();
+	void Clear();
+
+	Socket	m_hSocket;
+
+	/**  ð FIN   ϸ RST  Ѵ. ( monotonic milli second ) */
+	uint64_t	m_iDeadline;
+
+	CTeardownSocket * m_pclsPrev;
+	CTeardownSocket * m_pclsNext;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief   û
+ */
+class CTeardownRequest
+{
+public:
+	Socket	m_hSocket;
+	int			m_iPtyFd;
+	int			m_iPid;
+	ETeardownMode	m_eMode;
+};
+
+/**
+ * @ingroup LibTelnet
+ * @brief  , PTY, shell μ ̺Ʈ   ʰ Ѵ.
+ *	-  û ť ϰ Run  TEARDOWN_BATCH_SIZE  óѴ.
+ *	-  blocking close  shutdown  epoll   FIN  ٸ ð ʰǸ RST  Ѵ.
+ *	- AddChild   ڽ μ pidfd  Ḧ Ͽ ȸѴ. pidfd     SIGCHLD  signalfd    ˻Ѵ.
+ *	-   ڽ μ   waitpid  ȸؾ Ѵ.
+ *	- SIGHUP   ʴ shell  SIGKILL  Ѵ.
+ *	-  ׷̵ Export    ϰ ڽ μ ο μ Import ϸ  ð   Ḧ ٸ.
+ *	- ̺Ʈ  GetFd()  poll ϰ GetTimeout()  poll timeout  Ͽ Run()  ȣѴ.
+ */
+class CTeardown
+{
+public:
+	CTeardown();
+	~CTeardown();
+
+	bool Open( int iLingerSecond = TEARDOWN_LINGER_SECOND );
+	void Close();
+	void Flush();
+
+	static void RestoreChildSignal();
+
+	void Add( Socket hSocket, int iPtyFd, int iPid, ETeardownMode eMode = E_TM_GRACEFUL );
+	void AddChild( int iPid );
+	void Run();
+
+	void Export( HANDOVER_TEARDOWN_LIST & clsList );
+	void Import( HANDOVER_TEARDOWN_LIST & clsList );
+
+	Socket GetFd();
+	int GetTimeout();
+
+	bool PopExit( int & iPid, int & iStatus );
+	int GetDrainCount();
+
+private:
+	void Process( CTeardownRequest & clsRequest );
+	bool AddDrain( Socket hSocket, uint64_t iDeadline );
+	void Drain( Socket hSocket );
+	void CloseSocket( CTeardownSocket * pclsSocket, bool bAbort );
+	void Reap();
+	void ReapChild( int iPid );
+
+	int	m_hEpoll;
+	int	m_hSignal;
+	int	m_iLingerSecond;
+
+	/** ó   û. m_iRequestPos  óѴ. */
+	std::vector< CTeardownRequest >	m_clsRequestList;
+	size_t	m_iRequestPos;
+
+	/** FIN  ٸ   (  ð  ) */
+	CTeardownSocket * m_pclsHead;
+	CTeardownSocket * m_pclsTail;
+	int	m_iDrainCount;
+
+	/**  ڵ FIN  ٸ  ˻Ѵ. */
+	std::vector< CTeardownSocket * > m_clsSocketList;
+	CObjectPool< CTeardownSocket > m_clsSocketPool;
+
+	/** ȸ  ڽ μ ̵ pidfd. pidfd   Ͽ -1 ̴. */
+	std::map< int, int >	m_clsChildMap;
+
+	/** pidfd  ڽ μ ̵ ˻Ѵ. */
+	std::map< int, int >	m_clsPidFdMap;
+
+	/** pidfd   SIGCHLD    ˻ϴ ڽ μ  */
+	int	m_iScanCount;
+
+	/** SIGHUP   shell μ SIGKILL   ð */
+	std::deque< std::pair< int, uint64_t > > m_clsKillList;
+
+	/** ȸ ڽ μ ̵   */
+	std::deque< std::pair< int, int > > m_clsExitList;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "UnixSocket.h"
+
+#ifndef WIN32
+
+#include <stdlib.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "MemoryDebug.h"
+
+/**
+ * @ingroup LibTelnet
+ * @brief  ּҰ  ȣƮ ˻Ѵ.
+ * @param pszIp  IP ּ Ǵ ȣƮ ̸
+ * @returns  ȣƮ̸ true  ϰ ׷  false  Ѵ.
+ */
+bool IsLocalHost( const char * pszIp )
+{
+	if( !strncmp( pszIp, "127.", 4 ) || !strcmp( pszIp, "::1" ) || !strcasecmp( pszIp, "localhost" ) ) return true;
+
+	return false;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Ʈ ȣ شϴ Unix   θ ´.
+ *	-    ڸ   ־ Ѵ. ٸ ڰ   ɺ ũ̸  ʴ´.
+ * @param iPort		TCP Ʈ ȣ
+ * @param strPath	  θ  
+ * @param bCreate	   Ϸ true  ԷѴ.
+ * @returns   ִ    true  ϰ ׷  false  Ѵ.
+ */
+bool GetLocalSocketPath( int iPort, std::string & strPath, bool bCreate )
+{
+	struct stat sttStat;
+	const char * pszRuntime;
+	char szDir[256], szPort[11];
+	uid_t iUid = geteuid();
+
+	pszRuntime = getenv( "XDG_RUNTIME_DIR" );
+
+	if( iUid == 0 )
+	{
+		snprintf( szDir, sizeof(szDir), "%s", LOCAL_SOCKET_ROOT_DIR );
+	}
+	else if( pszRuntime && pszRuntime[0] == '/' )
+	{
+		snprintf( szDir, sizeof(szDir), "%s/telnet", pszRuntime );
+	}
+	else
+	{
+		snprintf( szDir, sizeof(szDir), "/tmp/telnet-%u", (unsigned int)iUid );
+	}
+
+	if( bCreate && mkdir( szDir, 0700 ) == -1 && errno != EEXIST ) return false;
+
+	// /tmp  ٸ ڰ ̸   ϸ  ç  ִ.
+	if( lstat( szDir, &sttStat ) == -1 || S_ISDIR( sttStat.st_mode ) == 0 || sttStat.st_uid != iUid || ( sttStat.st_mode & 077 ) ) return false;
+
+	snprintf( szPort, sizeof(szPort), "%d", iPort );
+
+	strPath = szDir;
+	strPath.append( "/telnet." );
+	strPath.append( szPort );
+	strPath.append( ".sock" );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Unix   ּҸ Ѵ.
+ * @param sttAddr	Unix   ּ
+ * @param pszPath	  
+ * @returns ϸ true  ϰ ΰ ʹ  false  Ѵ.
+ */
+static bool SetUnixAddr( struct sockaddr_un & sttAddr, const char * pszPath )
+{
+	memset( &sttAddr, 0, sizeof(sttAddr) );
+	sttAddr.sun_family = AF_UNIX;
+
+	if( strlen( pszPath ) >= sizeof(sttAddr.sun_path) ) return false;
+
+	snprintf( sttAddr.sun_path, sizeof(sttAddr.sun_path), "%s", pszPath );
+
+	return true;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Unix    Ѵ.    ϸ ϹǷ GetLocalSocketPath   θ ؾ Ѵ.
+ * @param pszPath		  
+ * @param iListenQ	queue number to listen
+ * @param iType			SOCK_STREAM Ǵ SOCK_SEQPACKET
+ * @returns ϸ  ڵ ϰ ϸ INVALID_SOCKET  Ѵ.
+ */
+Socket UnixListen( const char * pszPath, int iListenQ, int iType )
+{
+	struct sockaddr_un sttAddr;
+	Socket fd;
+
+	if( SetUnixAddr( sttAddr, pszPath ) == false ) return INVALID_SOCKET;
+
+	if( ( fd = socket( AF_UNIX, iType, 0 ) ) == INVALID_SOCKET )
+	{
+		return INVALID_SOCKET;
+	}
+
+	unlink( pszPath );
+
+	if( bind( fd, (struct sockaddr *)&sttAddr, sizeof(sttAddr) ) == SOCKET_ERROR )
+	{
+		closesocket( fd );
+		return INVALID_SOCKET;
+	}
+
+	if( listen( fd, iListenQ ) == SOCKET_ERROR )
+	{
+		closesocket( fd );
+		return INVALID_SOCKET;
+	}
+
+	return fd;
+}
+
+/**
+ * @ingroup LibTelnet
+ * @brief Unix   Ͽ Ѵ.
+ * @param pszPath	  
+ * @param iType		SOCK_STREAM Ǵ SOCK_SEQPACKET
+ * @returns ϸ   ڵ ϰ ׷  INVALID_SOCKET  Ѵ.
+ */
+Socket UnixConnect( const char * pszPath, int iType )
+{
+	struct sockaddr_un sttAddr;
+	Socket fd;
+
+	if( SetUnixAddr( sttAddr, pszPath ) == false ) return INVALID_SOCKET;
+
+	if( ( fd = socket( AF_UNIX, iType, 0 ) ) == INVALID_SOCKET )
+	{
+		return INVALID_SOCKET;
+	}
+
+	if( connect( fd, (struct sockaddr *)&sttAddr, sizeof(sttAddr) ) == SOCKET_ERROR )
+	{
+		closesocket( fd );
+		return INVALID_SOCKET;
+	}
+
+	return fd;
+}
+
+#endif
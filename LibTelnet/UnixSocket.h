@@ -0,0 +1,40 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _UNIX_SOCKET_H_
+#define _UNIX_SOCKET_H_
+
+#include "Define.h"
+#include "Tcp.h"
+
+#ifndef WIN32
+
+#include <string>
+
+// root    Unix   . ٸ ڴ XDG_RUNTIME_DIR/telnet Ǵ /tmp/telnet-{uid}  Ѵ.
+#define LOCAL_SOCKET_ROOT_DIR	"/run/telnet"
+
+bool IsLocalHost( const char * pszIp );
+bool GetLocalSocketPath( int iPort, std::string & strPath, bool bCreate );
+
+Socket UnixListen( const char * pszPath, int iListenQ, int iType = SOCK_STREAM );
+Socket UnixConnect( const char * pszPath, int iType = SOCK_STREAM );
+
+#endif
+
+#endif
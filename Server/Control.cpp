@@ -0,0 +1,327 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+
+#include "Control.h"
+#include "UnixSocket.h"
+#include "Log.h"
+
+#ifndef WIN32
+
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "MemoryDebug.h"
+
+/**
+ * @ingroup Server
+ * @brief   thread 
+ */
+class CControlArg
+{
+public:
+	CControl * m_pclsControl;
+	Socket	m_hSocket;
+};
+
+/**
+ * @ingroup Server
+ * @brief 
+ */
+CControl::CControl() : m_hListen(INVALID_SOCKET), m_pclsQueue(NULL)
+{
+}
+
+/**
+ * @ingroup Server
+ * @brief Ҹ.  thread  μ   ǹǷ listen   ʴ´.
+ */
+CControl::~CControl()
+{
+}
+
+/**
+ * @ingroup Server
+ * @brief    Ѵ.
+ *	-  ׷̵ listen  exec   ο μ ٽ Ѵ.
+ * @param pszPath		   Unix   
+ * @param pclsQueue	  reactor thread   ť
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CControl::Open( const char * pszPath, CCommandQueue * pclsQueue )
+{
+	pthread_t sttThread;
+
+	if( m_hListen != INVALID_SOCKET ) return false;
+
+	m_hListen = UnixListen( pszPath, 16 );
+	if( m_hListen == INVALID_SOCKET )
+	{
+		CLog::Print( LOG_ERROR, "%s UnixListen(%s) error(%d)", __FUNCTION__, pszPath, GetError() );
+		return false;
+	}
+
+	// ٸ   ClientThread  ź  ϵ ڸ   ֵ Ѵ.
+	chmod( pszPath, 0600 );
+	fcntl( m_hListen, F_SETFD, FD_CLOEXEC );
+
+	m_pclsQueue = pclsQueue;
+
+	if( pthread_create( &sttThread, NULL, ListenThread, this ) != 0 )
+	{
+		CLog::Print( LOG_ERROR, "%s pthread_create error", __FUNCTION__ );
+		closesocket( m_hListen );
+		m_hListen = INVALID_SOCKET;
+		return false;
+	}
+
+	pthread_detach( sttThread );
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief   accept Ͽ Ḷ thread  Ѵ.
+ * @param lpParameter CControl ü
+ * @returns 0  Ѵ.
+ */
+THREAD_API CControl::ListenThread( LPVOID lpParameter )
+{
+	CControl * pclsControl = (CControl *)lpParameter;
+	pthread_t sttThread;
+
+	while( 1 )
+	{
+		Socket hSocket = accept( pclsControl->m_hListen, NULL, NULL );
+		if( hSocket == INVALID_SOCKET )
+		{
+			if( errno == EINTR || errno == ECONNABORTED ) continue;
+
+			CLog::Print( LOG_ERROR, "%s accept error(%d)", __FUNCTION__, errno );
+			break;
+		}
+
+		CControlArg * pclsArg = new CControlArg();
+
+		pclsArg->m_pclsControl = pclsControl;
+		pclsArg->m_hSocket = hSocket;
+
+		if( pthread_create( &sttThread, NULL, ClientThread, pclsArg ) != 0 )
+		{
+			CLog::Print( LOG_ERROR, "%s pthread_create error", __FUNCTION__ );
+			closesocket( hSocket );
+			delete pclsArg;
+			continue;
+		}
+
+		pthread_detach( sttThread );
+	}
+
+	return 0;
+}
+
+/**
+ * @ingroup Server
+ * @brief   thread
+ * @param lpParameter CControlArg ü
+ * @returns 0  Ѵ.
+ */
+THREAD_API CControl::ClientThread( LPVOID lpParameter )
+{
+	CControlArg * pclsArg = (CControlArg *)lpParameter;
+
+	pclsArg->m_pclsControl->Client( pclsArg->m_hSocket );
+	closesocket( pclsArg->m_hSocket );
+	delete pclsArg;
+
+	return 0;
+}
+
+/**
+ * @ingroup Server
+ * @brief  ῡ   ྿ Ͽ  ť ߰Ѵ.
+ * @param hSocket  
+ */
+void CControl::Client( Socket hSocket )
+{
+	struct ucred sttCred;
+	socklen_t iCredLen = sizeof(sttCred);
+	struct timeval sttTimeout;
+	std::string strBuf, strReply, strError;
+	char szBuf[CONTROL_MAX_LINE];
+	size_t iPos;
+	int n;
+
+	if( getsockopt( hSocket, SOL_SOCKET, SO_PEERCRED, &sttCred, &iCredLen ) != 0 || sttCred.uid != getuid() )
+	{
+		CLog::Print( LOG_ERROR, "%s uid(%d) is not allowed", __FUNCTION__, ( iCredLen == sizeof(sttCred) ) ? (int)sttCred.uid : -1 );
+		return;
+	}
+
+	//   ʴ   thread    ʵ Ѵ.
+	sttTimeout.tv_sec = 10;
+	sttTimeout.tv_usec = 0;
+	setsockopt( hSocket, SOL_SOCKET, SO_RCVTIMEO, &sttTimeout, sizeof(sttTimeout) );
+
+	while( ( n = recv( hSocket, szBuf, sizeof(szBuf), 0 ) ) > 0 )
+	{
+		strBuf.append( szBuf, n );
+
+		while( ( iPos = strBuf.find( '\n' ) ) != std::string::npos )
+		{
+			std::string strLine = strBuf.substr( 0, iPos );
+			strBuf.erase( 0, iPos + 1 );
+
+			if( strLine.empty() == false && strLine[strLine.length()-1] == '\r' ) strLine.erase( strLine.length() - 1 );
+
+			CSessionCommand * pclsCommand = Parse( strLine.c_str(), strError );
+			if( pclsCommand )
+			{
+				CLog::Print( LOG_INFO, "%s command(%d) session(%d)", __FUNCTION__, pclsCommand->m_eCommand, pclsCommand->m_iSessionId );
+				m_pclsQueue->Push( pclsCommand );
+				strReply = "OK\n";
+			}
+			else
+			{
+				strReply = "ERROR ";
+				strReply.append( strError );
+				strReply.append( "\n" );
+			}
+
+			if( TcpSend( hSocket, strReply.c_str(), (int)strReply.length() ) != (int)strReply.length() ) return;
+		}
+
+		if( strBuf.length() >= CONTROL_MAX_LINE )
+		{
+			TcpSend( hSocket, "ERROR line is too long\n", 23 );
+			return;
+		}
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief        ȯѴ.
+ * @param pszLine		 
+ * @param strError	   
+ * @returns ϸ    ϰ ׷  NULL  Ѵ.
+ */
+CSessionCommand * CControl::Parse( const char * pszLine, std::string & strError )
+{
+	char szCommand[21], szTarget[21];
+	int iSessionId = -1, iRow, iCol, iPos = 0;
+
+	if( sscanf( pszLine, "%20s %20s %n", szCommand, szTarget, &iPos ) < 2 || iPos == 0 )
+	{
+		strError = "usage: kill|winsize|notice {session id|all} ...";
+		return NULL;
+	}
+
+	if( strcmp( szTarget, "all" ) )
+	{
+		char * pszEnd;
+
+		iSessionId = (int)strtol( szTarget, &pszEnd, 10 );
+		if( *pszEnd != '\0' || iSessionId <= 0 )
+		{
+			strError = "invalid session id";
+			return NULL;
+		}
+	}
+
+	if( !strcmp( szCommand, "kill" ) )
+	{
+		return new CSessionCommand( E_SC_KILL, iSessionId );
+	}
+
+	if( !strcmp( szCommand, "winsize" ) )
+	{
+		if( sscanf( pszLine + iPos, "%d %d", &iRow, &iCol ) != 2 || iRow <= 0 || iRow > 65535 || iCol <= 0 || iCol > 65535 )
+		{
+			strError = "usage: winsize {session id|all} {row} {col}";
+			return NULL;
+		}
+
+		CSessionCommand * pclsCommand = new CSessionCommand( E_SC_WINDOW_SIZE, iSessionId );
+		pclsCommand->m_iRow = (uint16_t)iRow;
+		pclsCommand->m_iCol = (uint16_t)iCol;
+
+		return pclsCommand;
+	}
+
+	if( !strcmp( szCommand, "notice" ) )
+	{
+		CSessionCommand * pclsCommand = new CSessionCommand( E_SC_BROADCAST, iSessionId );
+
+		//  ͹̳ο ϹǷ escape sequence   ʵ   ASCII ڸ Ѵ.
+		pclsCommand->m_strData = "\r\n[notice] ";
+		for( const char * pszData = pszLine + iPos; *pszData; ++pszData )
+		{
+			if( *pszData >= 0x20 && *pszData < 0x7f ) pclsCommand->m_strData.push_back( *pszData );
+		}
+		pclsCommand->m_strData.append( "\r\n" );
+
+		return pclsCommand;
+	}
+
+	strError = "unknown command";
+	return NULL;
+}
+
+/**
+ * @ingroup Server
+ * @brief      ϰ  ǥ ¿ Ѵ.
+ * @param pszPath			  ϴ Unix   
+ * @param pszCommand	 
+ * @returns   ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool ControlSend( const char * pszPath, const char * pszCommand )
+{
+	std::string strLine = pszCommand, strReply;
+	char szBuf[256];
+	int n;
+
+	strLine.append( "\n" );
+
+	Socket hSocket = UnixConnect( pszPath );
+	if( hSocket == INVALID_SOCKET )
+	{
+		printf( "UnixConnect(%s) error(%d)\n", pszPath, GetError() );
+		return false;
+	}
+
+	if( TcpSend( hSocket, strLine.c_str(), (int)strLine.length() ) == (int)strLine.length() )
+	{
+		shutdown( hSocket, SHUT_WR );
+
+		while( ( n = recv( hSocket, szBuf, sizeof(szBuf), 0 ) ) > 0 )
+		{
+			strReply.append( szBuf, n );
+		}
+	}
+
+	closesocket( hSocket );
+
+	printf( "%s", strReply.c_str() );
+
+	return ( strReply.compare( 0, 2, "OK" ) == 0 );
+}
+
+#endif
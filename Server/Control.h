@@ -0,0 +1,66 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+
+#ifndef _CONTROL_H_
+#define _CONTROL_H_
+
+#include "Tcp.h"
+#include "CommandQueue.h"
+
+#ifndef WIN32
+
+#include <string>
+
+//     ִ 
+#define CONTROL_MAX_LINE	1024
+
+/**
+ * @ingroup Server
+ * @brief   Unix   Ͽ   reactor thread   ť Ѵ.
+ *	-  Ḷ thread  ϹǷ    ÿ  ť  ߰Ѵ.
+ *	-     uid    Ḹ Ѵ.
+ *	-   ྿ ϰ ϸ "OK" , ϸ "ERROR {}"  Ѵ.
+ *		- kill { ̵|all}
+ *		- winsize { ̵|all} {} {}
+ *		- notice { ̵|all} {޽}
+ */
+class CControl
+{
+public:
+	CControl();
+	~CControl();
+
+	bool Open( const char * pszPath, CCommandQueue * pclsQueue );
+
+private:
+	static THREAD_API ListenThread( LPVOID lpParameter );
+	static THREAD_API ClientThread( LPVOID lpParameter );
+
+	void Client( Socket hSocket );
+	CSessionCommand * Parse( const char * pszLine, std::string & strError );
+
+	Socket	m_hListen;
+	CCommandQueue * m_pclsQueue;
+};
+
+bool ControlSend( const char * pszPath, const char * pszCommand );
+
+#endif
+
+#endif
@@ -18,43 +18,596 @@
 
 #include "Server.h"
 
-void Client( Socket hSocket )
-{
+//  ۽ ʹ reactor thread  gclsScheduler.Send()  ϰ poll  ϵ  gclsScheduler.Run()  ȣѴ.
+CSendScheduler gclsScheduler;
+
+#ifndef WIN32
+//  , PTY, shell μ gclsTeardown.Add()  ϰ  shell  gclsTeardown.PopExit()  ´.
+CTeardown gclsTeardown;
+#endif
 
+//    Ѵ. Ű ȯ shell  reactor  non-blocking  Ѵ.
+void Client( Socket hSocket, const char * pszIp )
+{
+#ifdef USE_TLS
+	if( gclsSessionMap.Add( hSocket, pszIp ) == false )
+	{
+		gclsTeardown.Add( hSocket, -1, -1, E_TM_ABORT );
+	}
+#else
 	closesocket( hSocket );
+#endif
+}
+
+#ifndef WIN32
+static volatile sig_atomic_t gbUpgrade = 0;
+static volatile sig_atomic_t gbStat = 0;
+
+#ifdef USE_TLS
+// Ŭ̾Ʈ STRIPE_PORT  Ͽ ϴ  Ѵ.
+CStripeReceiver gclsStripeReceiver;
+#endif
+
+// ٸ thread  ǿ   ʰ  ť  ߰ϸ reactor thread   Ѵ.
+CCommandQueue gclsCommandQueue;
+
+#ifdef USE_TLS
+//   thread  CONTROL_SOCKET_PATH   kill, winsize, notice  gclsCommandQueue  ߰Ѵ.
+CControl gclsControl;
+#endif
+
+//  shell  exec  gclsCgroup.AddSession()   cgroup  Եǰ ȸ Ŀ gclsCgroup.RemoveSession()  ȴ.
+CCgroup gclsCgroup;
+
+void SigUpgrade( int iSignal )
+{
+	(void)iSignal;
+	gbUpgrade = 1;
+}
+
+void SigStat( int iSignal )
+{
+	(void)iSignal;
+	gbStat = 1;
+}
+
+void PrintStat( const char * pszName, CCgroupStat & clsStat )
+{
+	CLog::Print( LOG_INFO, "%s cpu(" UNSIGNED_LONG_LONG_FORMAT "us) throttled(" UNSIGNED_LONG_LONG_FORMAT "/" UNSIGNED_LONG_LONG_FORMAT "us) memory(" UNSIGNED_LONG_LONG_FORMAT "/" UNSIGNED_LONG_LONG_FORMAT ") oom(" UNSIGNED_LONG_LONG_FORMAT ")"
+		, pszName, clsStat.m_iCpuUsec, clsStat.m_iThrottledCount, clsStat.m_iThrottledUsec, clsStat.m_iMemory, clsStat.m_iMemoryPeak, clsStat.m_iOomKill );
+}
+
+// SIGUSR1  ϸ relay cgroup   cgroup  ڿ 뷮 Ѵ.
+void PrintStat()
+{
+	CGROUP_STAT_MAP clsMap;
+	CGROUP_STAT_MAP::iterator itMap;
+	CCgroupStat clsStat;
+	char szName[21];
+
+	if( gclsCgroup.IsOpen() == false )
+	{
+		CLog::Print( LOG_INFO, "cgroup is not opened" );
+		return;
+	}
+
+	if( gclsCgroup.GetRelayStat( clsStat ) )
+	{
+		PrintStat( "relay", clsStat );
+	}
+
+	gclsCgroup.GetSessionStatMap( clsMap );
+
+	for( itMap = clsMap.begin(); itMap != clsMap.end(); ++itMap )
+	{
+		snprintf( szName, sizeof(szName), "session(%d)", itMap->first );
+		PrintStat( szName, itMap->second );
+	}
 }
 
+// ׷̵ ޽ Ե  ȣȭ Ű Ѵ.
+void ClearMessage( HANDOVER_MESSAGE_LIST & clsMessageList )
+{
+#ifdef USE_TLS
+	for( size_t i = 0; i < clsMessageList.size(); ++i )
+	{
+		OPENSSL_cleanse( &clsMessageList[i].m_strData[0], clsMessageList[i].m_strData.length() );
+	}
+#endif
+
+	clsMessageList.clear();
+}
+
+// ڽ μ listen ϰ  Unix   ϰ,  μ  PID  ο   Ѵ.
+// ׷Ƿ  shell μ ׷̵ Ŀ  ڽ μ ǰ listen   Ƿ ׷̵ ߿  ޴´.
+//  μ  thread  ϹǷ fork  ڽ μ ޸𸮸 Ҵ ʵ  ޽ fork   Ѵ.
+// Ű ȯ  ǰ   thread   ʴ´. Ű ȯ   RST  ϰ,    close-on-exec ̹Ƿ exec   ȴ.
+//     ϸ ٽ Ͽ ó ϰ ο μ  ִ ӽ Ͽ ̾ Ѵ.
+void Upgrade( char * argv[], Socket hListen, Socket hLocalListen, Socket hStripeListen, Socket hStripeLocalListen )
+{
+	HANDOVER_LISTEN_LIST clsListenList;
+	HANDOVER_SESSION_LIST clsSessionList;
+	HANDOVER_SESSION_LIST::iterator itSession;
+	HANDOVER_TEARDOWN_LIST clsTeardownList;
+	HANDOVER_MESSAGE_LIST clsMessageList;
+	char szFd[11], szPid[11];
+	int arrFd[2];
+	pid_t iPid;
+
+	clsListenList.push_back( CHandoverListen( E_LK_TELNET, hListen ) );
+	if( hLocalListen != INVALID_SOCKET ) clsListenList.push_back( CHandoverListen( E_LK_LOCAL, hLocalListen ) );
+	if( hStripeListen != INVALID_SOCKET ) clsListenList.push_back( CHandoverListen( E_LK_STRIPE, hStripeListen ) );
+	if( hStripeLocalListen != INVALID_SOCKET ) clsListenList.push_back( CHandoverListen( E_LK_STRIPE_LOCAL, hStripeLocalListen ) );
+
+#ifdef USE_TLS
+	gclsSessionMap.Export( clsSessionList );
+
+	int iFileCount = gclsStripeReceiver.GetFileCount();
+	if( iFileCount > 0 ) CLog::Print( LOG_INFO, "upgrade closes %d file transfers - senders reconnect and resend", iFileCount );
+#endif
+
+	// FIN  ٸ ϰ SIGHUP   shell  ο μ  ð   Ḧ óѴ.
+	gclsTeardown.Export( clsTeardownList );
+
+	bool bRes = HandoverBuild( clsListenList, clsSessionList, clsTeardownList, clsMessageList );
+
+#ifdef USE_TLS
+	for( itSession = clsSessionList.begin(); itSession != clsSessionList.end(); ++itSession )
+	{
+		OPENSSL_cleanse( &itSession->m_strBuf[0], itSession->m_strBuf.length() );
+	}
+#endif
+
+	if( bRes == false )
+	{
+		CLog::Print( LOG_ERROR, "HandoverBuild() error" );
+		return;
+	}
+
+	if( socketpair( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, arrFd ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "socketpair() error(%d)", GetError() );
+		ClearMessage( clsMessageList );
+		return;
+	}
+
+	iPid = fork();
+	if( iPid == -1 )
+	{
+		CLog::Print( LOG_ERROR, "fork() error(%d)", GetError() );
+		close( arrFd[0] );
+		close( arrFd[1] );
+		ClearMessage( clsMessageList );
+		return;
+	}
+
+	if( iPid == 0 )
+	{
+		// async-signal-safe Լ ȣѴ.
+		close( arrFd[0] );
+		_exit( HandoverSend( arrFd[1], clsMessageList ) ? 0 : 1 );
+	}
+
+	close( arrFd[1] );
+	ClearMessage( clsMessageList );
+
+	// ο μ  file descriptor ̿ܿ ڽ μ Ѵ.
+	fcntl( arrFd[0], F_SETFD, 0 );
+	fcntl( hListen, F_SETFD, FD_CLOEXEC );
+	if( hLocalListen != INVALID_SOCKET ) fcntl( hLocalListen, F_SETFD, FD_CLOEXEC );
+	if( hStripeListen != INVALID_SOCKET ) fcntl( hStripeListen, F_SETFD, FD_CLOEXEC );
+	if( hStripeLocalListen != INVALID_SOCKET ) fcntl( hStripeLocalListen, F_SETFD, FD_CLOEXEC );
+
+	snprintf( szFd, sizeof(szFd), "%d", arrFd[0] );
+	snprintf( szPid, sizeof(szPid), "%d", iPid );
+
+	// exec  μ üǱ  ring   α׸  Ѵ.
+	CLog::Stop();
+
+	execlp( argv[0], argv[0], "-u", szFd, szPid, (char *)NULL );
+
+	int iError = GetError();
+
+	//   μ  Ѵ.
+	CLog::Start();
+	CLog::Print( LOG_ERROR, "execlp(%s) error(%d)", argv[0], iError );
+	close( arrFd[0] );
+	waitpid( iPid, NULL, 0 );
+}
+
+//   μ  listen ϰ  Ͽ  񽺸 Ѵ.
+bool Resume( int iFd, pid_t iPid, Socket & hListen, Socket & hLocalListen, Socket & hStripeListen, Socket & hStripeLocalListen )
+{
+	HANDOVER_LISTEN_LIST clsListenList;
+	HANDOVER_LISTEN_LIST::iterator itListen;
+	HANDOVER_SESSION_LIST clsSessionList;
+	HANDOVER_TEARDOWN_LIST clsTeardownList;
+	struct timeval sttStart, sttEnd;
+
+	gettimeofday( &sttStart, NULL );
+
+	bool bRes = HandoverRecv( iFd, clsListenList, clsSessionList, clsTeardownList, 10 );
+
+	gettimeofday( &sttEnd, NULL );
+
+	close( iFd );
+
+	// ׷̵ ޽  μ gclsTeardown  ϵ Ƿ ⿡ ȸѴ.
+	waitpid( iPid, NULL, 0 );
+
+	for( itListen = clsListenList.begin(); itListen != clsListenList.end(); ++itListen )
+	{
+		Socket * phSocket = NULL;
+
+		switch( itListen->m_iKind )
+		{
+		case E_LK_TELNET: phSocket = &hListen; break;
+		case E_LK_LOCAL:	phSocket = &hLocalListen; break;
+		case E_LK_STRIPE:	phSocket = &hStripeListen; break;
+		case E_LK_STRIPE_LOCAL:	phSocket = &hStripeLocalListen; break;
+		}
+
+		if( phSocket && *phSocket == INVALID_SOCKET )
+		{
+			*phSocket = itListen->m_hSocket;
+		}
+		else
+		{
+			closesocket( itListen->m_hSocket );
+		}
+	}
+
+	if( bRes == false )
+	{
+		CLog::Print( LOG_ERROR, "HandoverRecv() error" );
+	}
+	else
+	{
+		CLog::Print( LOG_INFO, "handover %d listen sockets, %d sessions and %d teardowns in %ld us", (int)clsListenList.size(), (int)clsSessionList.size()
+			, (int)clsTeardownList.size(), ( sttEnd.tv_sec - sttStart.tv_sec ) * 1000000L + ( sttEnd.tv_usec - sttStart.tv_usec ) );
+	}
+
+	gclsTeardown.Import( clsTeardownList );
+
+	// shell μ ׷̵   μ ڽ μ̴. Ϻ Ǹ Ͽ    Ѵ.
+#ifdef USE_TLS
+	gclsSessionMap.Import( clsSessionList );
+#else
+	HANDOVER_SESSION_LIST::iterator itList;
+
+	for( itList = clsSessionList.begin(); itList != clsSessionList.end(); ++itList )
+	{
+		gclsTeardown.Add( itList->m_hSocket, itList->m_iPtyFd, itList->m_iPid );
+	}
+#endif
+
+	return bRes;
+}
+#endif
+
 int main( int argc, char * argv[] )
 {
+	Socket hListen = INVALID_SOCKET;
+
 	InitNetwork();
 
-	Socket hListen = TcpListen( 8888, 255 );
+#ifndef WIN32
+	//      Ѵ. ) Server -c "kill 3"
+	if( argc >= 3 && !strcmp( argv[1], "-c" ) )
+	{
+		return ControlSend( CONTROL_SOCKET_PATH, argv[2] ) ? 0 : 1;
+	}
+
+	// SIGCHLD   thread  block ؾ ϹǷ α thread  ϱ  ȣѴ.
+	if( gclsTeardown.Open( SESSION_LINGER_SECOND ) == false )
+	{
+		CLog::Print( LOG_ERROR, "teardown is not available - session is closed synchronously" );
+	}
+#endif
+
+	CLog::Start();
+
+#ifndef WIN32
+	Socket hLocalListen = INVALID_SOCKET, hStripeListen = INVALID_SOCKET, hStripeLocalListen = INVALID_SOCKET;
+
+	// ׷̵    shell   cgroup  ٽ ϵ Resume  ȣѴ.
+	if( gclsCgroup.Open( SESSION_CPU_MAX, SESSION_MEMORY_MAX ) == false )
+	{
+		CLog::Print( LOG_ERROR, "cgroup v2 is not available - session CPU/memory is not limited" );
+	}
+
+	if( argc >= 4 && !strcmp( argv[1], "-u" ) )
+	{
+		Resume( atoi( argv[2] ), atoi( argv[3] ), hListen, hLocalListen, hStripeListen, hStripeLocalListen );
+	}
+
+	struct sigaction sttAction;
+
+	memset( &sttAction, 0, sizeof(sttAction) );
+	sttAction.sa_handler = SigUpgrade;
+	sigaction( SIGUSR2, &sttAction, NULL );
+
+	sttAction.sa_handler = SigStat;
+	sigaction( SIGUSR1, &sttAction, NULL );
+
+	sttAction.sa_handler = SIG_IGN;
+	sigaction( SIGPIPE, &sttAction, NULL );
+
+#endif
+
+#ifdef USE_TLS
+	//   Ű  Ű ȯ ߰ϴ ڸ   Ƿ 񽺸  ʴ´.
+	std::string strPsk;
+
+	if( LoadPsk( SERVER_PSK_FILE, strPsk ) == false )
+	{
+		CLog::Print( LOG_ERROR, "LoadPsk(%s) error - pre-shared key must be at least %d bytes and readable only by owner", SERVER_PSK_FILE, AEAD_MIN_PSK_SIZE );
+		CLog::Stop();
+		return 0;
+	}
+
+	gclsSessionMap.SetPsk( strPsk );
+	gclsStripeReceiver.SetPsk( strPsk );
+	OPENSSL_cleanse( &strPsk[0], strPsk.length() );
+#endif
+
+	if( access( SEND_LIMIT_FILE, 0 ) == 0 )
+	{
+		if( gclsScheduler.LoadConfig( SEND_LIMIT_FILE ) == false )
+		{
+			CLog::Print( LOG_ERROR, "LoadConfig(%s) error", SEND_LIMIT_FILE );
+		}
+		else
+		{
+			CLog::Print( LOG_INFO, "send rate limit is loaded from %s", SEND_LIMIT_FILE );
+		}
+	}
+
 	if( hListen == INVALID_SOCKET )
 	{
-		printf( "TcpListen() error(%d)\n", GetError() );
+		hListen = TcpListen( SERVER_PORT, 255 );
+	}
+
+	if( hListen == INVALID_SOCKET )
+	{
+		CLog::Print( LOG_ERROR, "TcpListen() error(%d)", GetError() );
+		CLog::Stop();
 		return 0;
 	}
 
-	pollfd sttPoll[1];
+#ifdef WIN32
+	Socket hLocalListen = INVALID_SOCKET, hStripeListen = INVALID_SOCKET, hStripeLocalListen = INVALID_SOCKET;
+#endif
+	std::vector< pollfd > clsPollList;
+	pollfd sttPoll;
 	char szIp[51];
-	int n, iPort;
+	int n, iPort, iLocalIndex = -1, iTeardownIndex = -1, iStripeIndex = -1, iStripeLocalIndex = -1, iCommandIndex = -1, iTimeout, iFixedCount;
+
+	TcpSetPollIn( sttPoll, hListen );
+	clsPollList.push_back( sttPoll );
+
+#ifndef WIN32
+	std::string strLocalPath;
+
+	// ׷̵  μ  listen  ٽ  ʴ´.
+	if( hLocalListen == INVALID_SOCKET )
+	{
+		if( GetLocalSocketPath( SERVER_PORT, strLocalPath, true ) == false )
+		{
+			CLog::Print( LOG_ERROR, "local socket directory is not private - Unix domain socket is disabled" );
+		}
+		else if( ( hLocalListen = UnixListen( strLocalPath.c_str(), 255 ) ) == INVALID_SOCKET )
+		{
+			CLog::Print( LOG_ERROR, "UnixListen(%s) error(%d)", strLocalPath.c_str(), GetError() );
+		}
+	}
+
+	if( hLocalListen != INVALID_SOCKET )
+	{
+		TcpSetPollIn( sttPoll, hLocalListen );
+		iLocalIndex = (int)clsPollList.size();
+		clsPollList.push_back( sttPoll );
+	}
+
+	if( gclsCommandQueue.Open() == false )
+	{
+		CLog::Print( LOG_ERROR, "command queue eventfd error(%d)", GetError() );
+	}
+	else
+	{
+		TcpSetPollIn( sttPoll, gclsCommandQueue.GetEventFd() );
+		iCommandIndex = (int)clsPollList.size();
+		clsPollList.push_back( sttPoll );
+
+#ifdef USE_TLS
+		gclsControl.Open( CONTROL_SOCKET_PATH, &gclsCommandQueue );
+#endif
+	}
+
+#ifdef USE_TLS
+	if( gclsStripeReceiver.Open( STRIPE_RECV_DIR ) == false )
+	{
+		if( hStripeListen != INVALID_SOCKET )
+		{
+			closesocket( hStripeListen );
+			hStripeListen = INVALID_SOCKET;
+		}
+
+		if( hStripeLocalListen != INVALID_SOCKET )
+		{
+			closesocket( hStripeLocalListen );
+			hStripeLocalListen = INVALID_SOCKET;
+		}
+	}
+	else
+	{
+		if( hStripeListen == INVALID_SOCKET ) hStripeListen = TcpListen( STRIPE_PORT, 255 );
+		if( hStripeListen == INVALID_SOCKET )
+		{
+			CLog::Print( LOG_ERROR, "TcpListen(%d) error(%d)", STRIPE_PORT, GetError() );
+		}
+		else
+		{
+			TcpSetPollIn( sttPoll, hStripeListen );
+			iStripeIndex = (int)clsPollList.size();
+			clsPollList.push_back( sttPoll );
+		}
+
+		//  ȣƮ  Unix   Ͽ  ޸ äη  Ѵ.
+		if( hStripeLocalListen == INVALID_SOCKET && hStripeListen != INVALID_SOCKET && GetLocalSocketPath( STRIPE_PORT, strLocalPath, true ) )
+		{
+			hStripeLocalListen = UnixListen( strLocalPath.c_str(), 255 );
+			if( hStripeLocalListen == INVALID_SOCKET )
+			{
+				CLog::Print( LOG_ERROR, "UnixListen(%s) error(%d)", strLocalPath.c_str(), GetError() );
+			}
+		}
+
+		if( hStripeLocalListen != INVALID_SOCKET )
+		{
+			TcpSetPollIn( sttPoll, hStripeLocalListen );
+			iStripeLocalIndex = (int)clsPollList.size();
+			clsPollList.push_back( sttPoll );
+		}
+	}
+#endif
+
+	if( gclsTeardown.GetFd() != INVALID_SOCKET )
+	{
+		TcpSetPollIn( sttPoll, gclsTeardown.GetFd() );
+		iTeardownIndex = (int)clsPollList.size();
+		clsPollList.push_back( sttPoll );
+	}
+#endif
 
-	TcpSetPollIn( sttPoll[0], hListen );
+	// listen    poll ׸ ڿ  ϰ PTY  ߰Ѵ.
+	iFixedCount = (int)clsPollList.size();
 	
 	while( 1 )
 	{
-		n = poll( sttPoll, 1, 1000 );
+		iTimeout = 1000;
+
+		clsPollList.resize( iFixedCount );
+
+		for( n = 0; n < iFixedCount; ++n )
+		{
+			clsPollList[n].revents = 0;
+		}
+
+#ifndef WIN32
+		n = gclsTeardown.GetTimeout();
+		if( n >= 0 && n < iTimeout ) iTimeout = n;
+#endif
+
+#ifndef WIN32
+		gclsCgroup.SetPoll( clsPollList );
+
+		n = gclsCgroup.GetTimeout();
+		if( n >= 0 && n < iTimeout ) iTimeout = n;
+#endif
+
+#ifdef USE_TLS
+		gclsSessionMap.SetPoll( clsPollList );
+
+		n = gclsSessionMap.GetTimeout();
+		if( n >= 0 && n < iTimeout ) iTimeout = n;
+#endif
+
+		n = poll( &clsPollList[0], clsPollList.size(), iTimeout );
+
+#ifndef WIN32
+		if( gbUpgrade )
+		{
+			gbUpgrade = 0;
+			Upgrade( argv, hListen, hLocalListen, hStripeListen, hStripeLocalListen );
+			continue;
+		}
+
+		if( gbStat )
+		{
+			gbStat = 0;
+			PrintStat();
+		}
+
+		if( ( n > 0 && iTeardownIndex >= 0 && ( clsPollList[iTeardownIndex].revents & POLLIN ) ) || gclsTeardown.GetTimeout() == 0 )
+		{
+			int iPid, iStatus;
+
+			gclsTeardown.Run();
+
+			while( gclsTeardown.PopExit( iPid, iStatus ) )
+			{
+				CLog::Print( LOG_DEBUG, "child(%d) exit status(%d)", iPid, iStatus );
+#ifdef USE_TLS
+				gclsSessionMap.SetExit( iPid );
+#endif
+
+				// shell  background   μ ϰ μ  Ǹ  cgroup  Ѵ.
+				int iSessionId = gclsCgroup.GetSessionId( iPid );
+				if( iSessionId >= 0 ) gclsCgroup.RemoveSession( iSessionId );
+			}
+		}
+
+		gclsCgroup.Process( clsPollList );
+#endif
+
+#ifdef USE_TLS
+		if( n > 0 && iCommandIndex >= 0 && ( clsPollList[iCommandIndex].revents & POLLIN ) )
+		{
+			CSessionCommand * pclsCommand;
+
+			gclsCommandQueue.ClearEvent();
+
+			while( ( pclsCommand = gclsCommandQueue.Pop() ) != NULL )
+			{
+				gclsSessionMap.Execute( pclsCommand );
+				delete pclsCommand;
+			}
+		}
+
+		// poll  Ͽ ð ʰ  ϵ ȣѴ.
+		gclsSessionMap.Process( clsPollList );
+#endif
 
 		if( n > 0 )
 		{
-			if( sttPoll[0].revents & POLLIN )
+			if( clsPollList[0].revents & POLLIN )
 			{
 				Socket hConn = TcpAccept( hListen, szIp, sizeof(szIp), &iPort );
 				if( hConn != INVALID_SOCKET )
 				{
-					Client( hConn );
+					Client( hConn, szIp );
+				}
+			}
+
+			if( iLocalIndex >= 0 && ( clsPollList[iLocalIndex].revents & POLLIN ) )
+			{
+				Socket hConn = accept( hLocalListen, NULL, NULL );
+				if( hConn != INVALID_SOCKET )
+				{
+					Client( hConn, "local" );
+				}
+			}
+
+#ifdef USE_TLS
+			if( iStripeIndex >= 0 && ( clsPollList[iStripeIndex].revents & POLLIN ) )
+			{
+				Socket hConn = TcpAccept( hStripeListen, szIp, sizeof(szIp), &iPort );
+				if( hConn != INVALID_SOCKET )
+				{
+					gclsStripeReceiver.Add( hConn );
+				}
+			}
+
+			if( iStripeLocalIndex >= 0 && ( clsPollList[iStripeLocalIndex].revents & POLLIN ) )
+			{
+				Socket hConn = accept( hStripeLocalListen, NULL, NULL );
+				if( hConn != INVALID_SOCKET )
+				{
+					gclsStripeReceiver.Add( hConn, true );
 				}
 			}
+#endif
 		}
 	}
 
@@ -19,6 +19,59 @@
 #ifndef _SERVER_H_
 #define _SERVER_H_
 
+#include <vector>
 #include "Tcp.h"
+#include "Log.h"
+#include "AeadCipher.h"
+#include "Handover.h"
+#include "UnixSocket.h"
+#include "Cgroup.h"
+#include "SendScheduler.h"
+#include "Teardown.h"
+#include "StripeTransfer.h"
+#include "CommandQueue.h"
+#include "Control.h"
+#include "Session.h"
+
+#ifndef WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#endif
+
+// Ŭ̾Ʈ  ϴ TCP Ʈ.  ȣƮ Ŭ̾Ʈ GetLocalSocketPath( SERVER_PORT )  Unix   Ѵ.
+#define SERVER_PORT					8888
+
+//  cgroup  cpu.max  ( {ִ  ð} {ֱ} - micro second  )
+#define SESSION_CPU_MAX			"100000 100000"
+
+//  cgroup  memory.max 
+#define SESSION_MEMORY_MAX	( 512 * 1024 * 1024 )
+
+// ũ /  IP  ۽ ӵ   
+#define SEND_LIMIT_FILE			"TelnetServer.limit"
+
+//    FIN  ٸ ð (   ). ʰϸ RST  Ѵ. 0 ̸ ׻ RST  Ѵ.
+#define SESSION_LINGER_SECOND	5
+
+/**
+ * @ingroup Server
+ * @brief  ׷̵ ο μ ϴ listen  
+ */
+enum EListenKind
+{
+	E_LK_TELNET = 1,
+	E_LK_LOCAL,
+	E_LK_STRIPE,
+	E_LK_STRIPE_LOCAL
+};
+
+//   ( kill, winsize, notice )  ϴ Unix  .      ִ.
+#define CONTROL_SOCKET_PATH	"TelnetServer.ctl"
+
+// Ű ȯ ϴ   Ű . ù°    Ű ϸ ڸ   ־ Ѵ. ( chmod 600 )
+#define SERVER_PSK_FILE			"TelnetServer.psk"
+
+// Ŭ̾Ʈ  TCP    ϴ 
+#define STRIPE_RECV_DIR			"TelnetServer.recv"
 
 #endif
@@ -0,0 +1,889 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "Session.h"
+
+#ifdef USE_TLS
+
+#include "Log.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pwd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include "MemoryDebug.h"
+
+// shell μ PATH ȯ 
+#define SESSION_PATH		"PATH=/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin"
+
+extern CTeardown gclsTeardown;
+extern CCgroup gclsCgroup;
+extern CSendScheduler gclsScheduler;
+
+CSessionMap gclsSessionMap;
+
+/**
+ * @ingroup Server
+ * @brief monotonic ð milli second  ´.
+ * @returns monotonic ð Ѵ.
+ */
+static uint64_t GetMonotonicMs()
+{
+	struct timespec sttTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sttTime );
+
+	return (uint64_t)sttTime.tv_sec * 1000 + sttTime.tv_nsec / 1000000;
+}
+
+/**
+ * @ingroup Server
+ * @brief  ڵ non-blocking  Ѵ.
+ * @param iFd  ڵ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool SetNonBlocking( int iFd )
+{
+	int iFlags = fcntl( iFd, F_GETFL );
+	if( iFlags == -1 ) return false;
+
+	return ( fcntl( iFd, F_SETFL, iFlags | O_NONBLOCK ) != -1 );
+}
+
+/**
+ * @ingroup Server
+ * @brief ̿ ͸ ߰Ѵ.  ȣƮ μ ϹǷ host byte order  Ѵ.
+ * @param strBuf	͸ ߰ 
+ * @param pszData	
+ * @param iLen		 
+ */
+static void PutField( std::string & strBuf, const char * pszData, uint32_t iLen )
+{
+	strBuf.append( (char *)&iLen, sizeof(iLen) );
+	strBuf.append( pszData, iLen );
+}
+
+/**
+ * @ingroup Server
+ * @brief PutField  ߰ ͸ ´.
+ * @param strBuf	PutField   
+ * @param iPos		 ġ.  ġ ̵Ѵ.
+ * @param strData	 ͸  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool GetField( const std::string & strBuf, size_t & iPos, std::string & strData )
+{
+	uint32_t iLen;
+
+	if( strBuf.length() - iPos < sizeof(iLen) ) return false;
+
+	memcpy( &iLen, strBuf.data() + iPos, sizeof(iLen) );
+	iPos += sizeof(iLen);
+
+	if( strBuf.length() - iPos < iLen ) return false;
+
+	strData.assign( strBuf.data() + iPos, iLen );
+	iPos += iLen;
+
+	return true;
+}
+
+CSession::CSession()
+{
+	Clear();
+}
+
+/**
+ * @ingroup Server
+ * @brief  ʱ · . ϰ PTY  gclsTeardown  ϹǷ  ʴ´.
+ */
+void CSession::Clear()
+{
+	m_iSessionId = 0;
+	m_hSocket = INVALID_SOCKET;
+	m_iPtyFd = -1;
+	m_iPid = -1;
+	m_eState = E_SS_HANDSHAKE;
+	m_iDeadline = 0;
+	m_strIp.clear();
+	m_clsCipher.Close();
+	m_strRecvBuf.clear();
+	m_strPtyBuf.clear();
+	m_iSocketIndex = -1;
+	m_iPtyIndex = -1;
+}
+
+CSessionMap::CSessionMap() : m_iNextId(1), m_iSendTimeout(-1)
+{
+}
+
+CSessionMap::~CSessionMap()
+{
+	SESSION_MAP::iterator itMap;
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); ++itMap )
+	{
+		delete itMap->second;
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief Ű ȯ    Ű Ѵ.
+ * @param strPsk   Ű
+ */
+void CSessionMap::SetPsk( const std::string & strPsk )
+{
+	m_strPsk = strPsk;
+}
+
+/**
+ * @ingroup Server
+ * @brief   ϰ Ű ȯ Ѵ.
+ * @param hSocket	 
+ * @param pszIp		Ŭ̾Ʈ IP ּ
+ * @returns ϸ true  ϰ ׷  false  Ѵ. ϸ ȣڰ  ؾ Ѵ.
+ */
+bool CSessionMap::Add( Socket hSocket, const char * pszIp )
+{
+	if( SetNonBlocking( hSocket ) == false ) return false;
+
+	//  ׷̵    ο μ  ʵ Ѵ.
+	fcntl( hSocket, F_SETFD, FD_CLOEXEC );
+
+	CSession * pclsSession = m_clsPool.Get();
+
+	if( pclsSession->m_clsCipher.HandshakeStart( hSocket, true, m_strPsk.c_str() ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s HandshakeStart(%s) error", __FUNCTION__, pszIp );
+		m_clsPool.Put( pclsSession );
+		return false;
+	}
+
+	pclsSession->m_iSessionId = m_iNextId++;
+	if( m_iNextId <= 0 ) m_iNextId = 1;
+
+	pclsSession->m_hSocket = hSocket;
+	pclsSession->m_strIp = pszIp;
+	pclsSession->m_eState = E_SS_HANDSHAKE;
+	pclsSession->m_iDeadline = GetMonotonicMs() + SESSION_HANDSHAKE_SECOND * 1000;
+
+	m_clsMap.insert( SESSION_MAP::value_type( pclsSession->m_iSessionId, pclsSession ) );
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief  ϰ PTY  poll Ͽ ߰Ѵ.
+ *	-   Ͱ SESSION_MAX_BUF_SIZE ̸̻ ݴ  ʾ 濡 backpressure  Ѵ.
+ *	- ٷ   ۰  áٰ Ǵ Ǹ POLLOUT  ٸ.
+ * @param clsPollList poll 
+ */
+void CSessionMap::SetPoll( std::vector< pollfd > & clsPollList )
+{
+	SESSION_MAP::iterator itMap;
+	pollfd sttPoll;
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); ++itMap )
+	{
+		CSession * pclsSession = itMap->second;
+
+		memset( &sttPoll, 0, sizeof(sttPoll) );
+		sttPoll.fd = pclsSession->m_hSocket;
+
+		if( pclsSession->m_eState == E_SS_HANDSHAKE || ( pclsSession->m_eState == E_SS_RELAY && pclsSession->m_strPtyBuf.length() < SESSION_MAX_BUF_SIZE ) )
+		{
+			sttPoll.events |= POLLIN;
+		}
+
+		if( gclsScheduler.IsBlocked( pclsSession->m_iSessionId ) ) sttPoll.events |= POLLOUT;
+
+		pclsSession->m_iSocketIndex = (int)clsPollList.size();
+		clsPollList.push_back( sttPoll );
+
+		pclsSession->m_iPtyIndex = -1;
+
+		if( pclsSession->m_eState == E_SS_RELAY )
+		{
+			memset( &sttPoll, 0, sizeof(sttPoll) );
+			sttPoll.fd = pclsSession->m_iPtyFd;
+
+			if( gclsScheduler.GetSessionQueueSize( pclsSession->m_iSessionId ) < SESSION_MAX_BUF_SIZE ) sttPoll.events |= POLLIN;
+			if( pclsSession->m_strPtyBuf.empty() == false ) sttPoll.events |= POLLOUT;
+
+			pclsSession->m_iPtyIndex = (int)clsPollList.size();
+			clsPollList.push_back( sttPoll );
+		}
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief poll   Ű ȯ   ϰ ð ʰ  Ѵ.
+ *	-    ٷ ť  Ŀ gclsScheduler.Run()  Ѵ.
+ * @param clsPollList SetPoll   ߰ poll 
+ */
+void CSessionMap::Process( std::vector< pollfd > & clsPollList )
+{
+	SESSION_MAP::iterator itMap, itNext;
+	uint64_t iNow = GetMonotonicMs();
+	short sSocketEvent, sPtyEvent;
+	int n;
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); itMap = itNext )
+	{
+		CSession * pclsSession = itMap->second;
+
+		itNext = itMap;
+		++itNext;
+
+		// SetPoll Ŀ ߰   poll  óѴ.
+		if( pclsSession->m_iSocketIndex < 0 || pclsSession->m_iSocketIndex >= (int)clsPollList.size() ) continue;
+
+		sSocketEvent = clsPollList[pclsSession->m_iSocketIndex].revents;
+		sPtyEvent = 0;
+
+		if( pclsSession->m_iPtyIndex >= 0 && pclsSession->m_iPtyIndex < (int)clsPollList.size() )
+		{
+			sPtyEvent = clsPollList[pclsSession->m_iPtyIndex].revents;
+		}
+
+		if( pclsSession->m_eState == E_SS_HANDSHAKE )
+		{
+			if( sSocketEvent )
+			{
+				n = pclsSession->m_clsCipher.HandshakeRecv( pclsSession->m_hSocket );
+				if( n == -1 )
+				{
+					CLog::Print( LOG_ERROR, "session(%d) %s handshake error", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+					Delete( pclsSession, E_TM_ABORT );
+					continue;
+				}
+				else if( n == 1 )
+				{
+					if( StartShell( pclsSession ) == false )
+					{
+						Delete( pclsSession, E_TM_ABORT );
+						continue;
+					}
+
+					CLog::Print( LOG_INFO, "session(%d) %s started pid(%d) %s", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str(), pclsSession->m_iPid
+						, pclsSession->m_clsCipher.IsKtls() ? "ktls" : "user-space" );
+					continue;
+				}
+			}
+
+			if( iNow >= pclsSession->m_iDeadline )
+			{
+				CLog::Print( LOG_ERROR, "session(%d) %s handshake timeout", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+				Delete( pclsSession, E_TM_ABORT );
+			}
+
+			continue;
+		}
+
+		if( sSocketEvent & POLLOUT )
+		{
+			gclsScheduler.SetWritable( pclsSession->m_iSessionId );
+		}
+
+		if( pclsSession->m_eState == E_SS_FLUSH )
+		{
+			if( gclsScheduler.GetSessionQueueSize( pclsSession->m_iSessionId ) == 0 || iNow >= pclsSession->m_iDeadline || ( sSocketEvent & ( POLLERR | POLLHUP ) ) )
+			{
+				Delete( pclsSession, E_TM_GRACEFUL );
+			}
+
+			continue;
+		}
+
+		if( sSocketEvent & ( POLLIN | POLLERR | POLLHUP ) )
+		{
+			if( RecvSocket( pclsSession ) == false )
+			{
+				CLog::Print( LOG_INFO, "session(%d) %s closed by client", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+				Delete( pclsSession, E_TM_GRACEFUL );
+				continue;
+			}
+		}
+
+		if( sPtyEvent & POLLOUT )
+		{
+			if( WritePty( pclsSession ) == false )
+			{
+				Delete( pclsSession, E_TM_GRACEFUL );
+				continue;
+			}
+		}
+
+		if( sPtyEvent & ( POLLIN | POLLERR | POLLHUP ) )
+		{
+			if( RecvPty( pclsSession ) == false )
+			{
+				// shell  ǾǷ    Ŀ Ѵ.
+				CLog::Print( LOG_INFO, "session(%d) %s shell exited", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+				pclsSession->m_eState = E_SS_FLUSH;
+				pclsSession->m_iDeadline = iNow + SESSION_FLUSH_SECOND * 1000;
+
+				if( gclsScheduler.GetSessionQueueSize( pclsSession->m_iSessionId ) == 0 ) Delete( pclsSession, E_TM_GRACEFUL );
+			}
+		}
+	}
+
+	m_iSendTimeout = gclsScheduler.Run();
+}
+
+/**
+ * @ingroup Server
+ * @brief ȸ shell μ ǿ Ѵ. ȸ μ ̵   Ƿ  û  ʴ´.
+ * @param iPid ȸ ڽ μ ̵
+ */
+void CSessionMap::SetExit( int iPid )
+{
+	SESSION_PID_MAP::iterator itPid = m_clsPidMap.find( iPid );
+	if( itPid == m_clsPidMap.end() ) return;
+
+	SESSION_MAP::iterator itMap = m_clsMap.find( itPid->second );
+	if( itMap != m_clsMap.end() )
+	{
+		itMap->second->m_iPid = -1;
+	}
+
+	m_clsPidMap.erase( itPid );
+}
+
+/**
+ * @ingroup Server
+ * @brief ٸ thread   ť     Ѵ.
+ * @param pclsCommand   
+ */
+void CSessionMap::Execute( CSessionCommand * pclsCommand )
+{
+	SESSION_MAP::iterator itMap, itNext;
+	struct winsize sttSize;
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); itMap = itNext )
+	{
+		CSession * pclsSession = itMap->second;
+
+		itNext = itMap;
+		++itNext;
+
+		if( pclsCommand->m_iSessionId != -1 && pclsCommand->m_iSessionId != pclsSession->m_iSessionId ) continue;
+		//   Ű ȯ  ǿ Ѵ.
+		if( pclsSession->m_eState != E_SS_RELAY && pclsCommand->m_eCommand != E_SC_KILL ) continue;
+
+		switch( pclsCommand->m_eCommand )
+		{
+		case E_SC_BROADCAST:
+			if( Output( pclsSession, pclsCommand->m_strData.data(), (int)pclsCommand->m_strData.length() ) == false )
+			{
+				Delete( pclsSession, E_TM_ABORT );
+			}
+			break;
+		case E_SC_KILL:
+			CLog::Print( LOG_INFO, "session(%d) %s is killed", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+			Delete( pclsSession, E_TM_GRACEFUL );
+			break;
+		case E_SC_WINDOW_SIZE:
+			memset( &sttSize, 0, sizeof(sttSize) );
+			sttSize.ws_row = pclsCommand->m_iRow;
+			sttSize.ws_col = pclsCommand->m_iCol;
+			ioctl( pclsSession->m_iPtyFd, TIOCSWINSZ, &sttSize );
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief  ׷̵ ο μ    Ѵ.    μ  ȴ.
+ *	- Ű ȯ   X25519 Ű  Ƿ α׸ ϰ RST  Ѵ. Ŭ̾Ʈ ٽ ؾ Ѵ.
+ *	-   ȣȭ Ű ԵǾ Ƿ  Ŀ ؾ Ѵ.
+ * @param clsList    Ʈ
+ */
+void CSessionMap::Export( HANDOVER_SESSION_LIST & clsList )
+{
+	SESSION_MAP::iterator itMap, itNext;
+	std::string strCipher, strUnsent;
+	int32_t arrValue[2];
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); itMap = itNext )
+	{
+		CSession * pclsSession = itMap->second;
+
+		itNext = itMap;
+		++itNext;
+
+		//   close-on-exec  ƴϹǷ   ο μ  ʴ  ´.
+		if( pclsSession->m_eState == E_SS_HANDSHAKE )
+		{
+			CLog::Print( LOG_INFO, "session(%d) %s is closed by upgrade during handshake", pclsSession->m_iSessionId, pclsSession->m_strIp.c_str() );
+			Delete( pclsSession, E_TM_ABORT );
+			continue;
+		}
+
+		strCipher.clear();
+		if( pclsSession->m_clsCipher.Export( strCipher ) == false ) continue;
+
+		// ȣȭ Ű  ʵ Ʈ ߰ ü  Ѵ.
+		clsList.push_back( CHandoverSession() );
+		CHandoverSession & clsSession = clsList.back();
+
+		clsSession.m_hSocket = pclsSession->m_hSocket;
+		clsSession.m_iPtyFd = pclsSession->m_iPtyFd;
+		clsSession.m_iPid = pclsSession->m_iPid;
+
+		arrValue[0] = pclsSession->m_iSessionId;
+		arrValue[1] = pclsSession->m_eState;
+
+		// ٷ ť   ο μ ٷ ť ٽ Ѵ.
+		gclsScheduler.GetUnsent( pclsSession->m_iSessionId, strUnsent );
+
+		// ޸𸮸 ٽ Ҵϸ鼭 ȣȭ Ű  ޸𸮿  ʵ Ѵ.
+		clsSession.m_strBuf.reserve( sizeof(arrValue) + sizeof(uint32_t) * 5 + pclsSession->m_strIp.length() + strCipher.length()
+			+ pclsSession->m_strRecvBuf.length() + pclsSession->m_strPtyBuf.length() + strUnsent.length() );
+		clsSession.m_strBuf.append( (char *)arrValue, sizeof(arrValue) );
+		PutField( clsSession.m_strBuf, pclsSession->m_strIp.data(), (uint32_t)pclsSession->m_strIp.length() );
+		PutField( clsSession.m_strBuf, strCipher.data(), (uint32_t)strCipher.length() );
+		PutField( clsSession.m_strBuf, pclsSession->m_strRecvBuf.data(), (uint32_t)pclsSession->m_strRecvBuf.length() );
+		PutField( clsSession.m_strBuf, pclsSession->m_strPtyBuf.data(), (uint32_t)pclsSession->m_strPtyBuf.length() );
+		PutField( clsSession.m_strBuf, strUnsent.data(), (uint32_t)strUnsent.length() );
+
+		OPENSSL_cleanse( &strCipher[0], strCipher.length() );
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief   μ   ϰ 񽺸 Ѵ.   ùٸ   Ѵ.
+ * @param clsList   μ    Ʈ
+ */
+void CSessionMap::Import( HANDOVER_SESSION_LIST & clsList )
+{
+	HANDOVER_SESSION_LIST::iterator itList;
+	std::string strCipher, strUnsent;
+	int32_t arrValue[2];
+	size_t iPos;
+
+	for( itList = clsList.begin(); itList != clsList.end(); ++itList )
+	{
+		CSession * pclsSession = m_clsPool.Get();
+		bool bRes = false;
+
+		iPos = sizeof(arrValue);
+
+		if( itList->m_strBuf.length() >= sizeof(arrValue) && itList->m_iPtyFd >= 0 )
+		{
+			memcpy( arrValue, itList->m_strBuf.data(), sizeof(arrValue) );
+
+			bRes = ( arrValue[0] > 0 && ( arrValue[1] == E_SS_RELAY || arrValue[1] == E_SS_FLUSH ) && m_clsMap.find( arrValue[0] ) == m_clsMap.end() &&
+				GetField( itList->m_strBuf, iPos, pclsSession->m_strIp ) && GetField( itList->m_strBuf, iPos, strCipher ) &&
+				GetField( itList->m_strBuf, iPos, pclsSession->m_strRecvBuf ) && GetField( itList->m_strBuf, iPos, pclsSession->m_strPtyBuf ) &&
+				GetField( itList->m_strBuf, iPos, strUnsent ) &&
+				pclsSession->m_clsCipher.Import( strCipher.data(), (int)strCipher.length() ) );
+		}
+
+		if( strCipher.empty() == false ) OPENSSL_cleanse( &strCipher[0], strCipher.length() );
+		OPENSSL_cleanse( &itList->m_strBuf[0], itList->m_strBuf.length() );
+
+		if( bRes == false || SetNonBlocking( itList->m_hSocket ) == false || SetNonBlocking( itList->m_iPtyFd ) == false )
+		{
+			CLog::Print( LOG_ERROR, "%s invalid session pid(%d)", __FUNCTION__, itList->m_iPid );
+			gclsTeardown.Add( itList->m_hSocket, itList->m_iPtyFd, itList->m_iPid, E_TM_ABORT );
+			m_clsPool.Put( pclsSession );
+			continue;
+		}
+
+		pclsSession->m_iSessionId = arrValue[0];
+		pclsSession->m_eState = (ESessionState)arrValue[1];
+		pclsSession->m_hSocket = itList->m_hSocket;
+		pclsSession->m_iPtyFd = itList->m_iPtyFd;
+		pclsSession->m_iPid = itList->m_iPid;
+		pclsSession->m_iDeadline = GetMonotonicMs() + SESSION_FLUSH_SECOND * 1000;
+
+		m_clsMap.insert( SESSION_MAP::value_type( pclsSession->m_iSessionId, pclsSession ) );
+
+		gclsScheduler.AddSession( pclsSession->m_iSessionId, pclsSession->m_hSocket, pclsSession->m_strIp.c_str() );
+		if( strUnsent.empty() == false ) gclsScheduler.Send( pclsSession->m_iSessionId, SESSION_SEND_CHANNEL, strUnsent.data(), (int)strUnsent.length() );
+
+		if( pclsSession->m_iPid > 0 )
+		{
+			m_clsPidMap.insert( SESSION_PID_MAP::value_type( pclsSession->m_iPid, pclsSession->m_iSessionId ) );
+			gclsTeardown.AddChild( pclsSession->m_iPid );
+
+			// shell μ ̹  cgroup  ԵǾ Ƿ  cgroup  ϵ ٽ Ѵ.
+			if( gclsCgroup.IsOpen() ) gclsCgroup.AddSession( pclsSession->m_iSessionId, pclsSession->m_iPid );
+		}
+
+		// ο  ̵ ޵  ̵ ߺ ʵ Ѵ.
+		if( pclsSession->m_iSessionId >= m_iNextId ) m_iNextId = pclsSession->m_iSessionId + 1;
+	}
+}
+
+/**
+ * @ingroup Server
+ * @brief   ð ʰǴ  Ǵ ٷ token   ð ´.
+ *	-   Ϸ E_SS_FLUSH  ٷ ϵ 0  Ѵ.
+ * @returns  ð ( milli second  )  Ѵ. ð ˻   -1  Ѵ.
+ */
+int CSessionMap::GetTimeout()
+{
+	SESSION_MAP::iterator itMap;
+	uint64_t iNow = GetMonotonicMs();
+	int iTimeout = m_iSendTimeout;
+
+	for( itMap = m_clsMap.begin(); itMap != m_clsMap.end(); ++itMap )
+	{
+		CSession * pclsSession = itMap->second;
+
+		if( pclsSession->m_eState == E_SS_RELAY ) continue;
+
+		int n = ( pclsSession->m_iDeadline > iNow ) ? (int)( pclsSession->m_iDeadline - iNow ) : 0;
+		if( pclsSession->m_eState == E_SS_FLUSH && gclsScheduler.GetSessionQueueSize( pclsSession->m_iSessionId ) == 0 ) n = 0;
+
+		if( iTimeout == -1 || n < iTimeout ) iTimeout = n;
+	}
+
+	return iTimeout;
+}
+
+/**
+ * @ingroup Server
+ * @brief   ´.
+ * @returns   Ѵ.
+ */
+int CSessionMap::GetCount()
+{
+	return (int)m_clsMap.size();
+}
+
+/**
+ * @ingroup Server
+ * @brief PTY  ϰ shell μ Ѵ.
+ *	- reactor   thread   μ̹Ƿ fork  ڽ μ async-signal-safe Լ ȣ Ŀ exec Ѵ.
+ *	- ׷Ƿ ޸ Ҵ ʿ   ȸ, , ȯ  fork  غѴ.
+ * @param pclsSession 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CSessionMap::StartShell( CSession * pclsSession )
+{
+	struct passwd sttPasswd, * psttPasswd = NULL;
+	struct winsize sttSize;
+	struct rlimit sttLimit;
+	struct sigaction sttAction;
+	std::string strShell, strHome, strArg0, strHomeEnv, strShellEnv, strUserEnv, strLogNameEnv;
+	char szPasswd[16384], szSlave[256];
+	const char * arrArg[2], * arrEnv[7];
+	int iPtyFd, iMaxFd = 1024, arrSync[2];
+	pid_t iPid;
+	char cSync = 0;
+
+	if( getpwuid_r( getuid(), &sttPasswd, szPasswd, sizeof(szPasswd), &psttPasswd ) != 0 || psttPasswd == NULL )
+	{
+		CLog::Print( LOG_ERROR, "%s getpwuid_r error(%d)", __FUNCTION__, errno );
+		return false;
+	}
+
+	strShell = ( psttPasswd->pw_shell && psttPasswd->pw_shell[0] ) ? psttPasswd->pw_shell : "/bin/sh";
+	strHome = ( psttPasswd->pw_dir && psttPasswd->pw_dir[0] ) ? psttPasswd->pw_dir : "/";
+
+	// login shell  ϵ argv[0] տ '-'  δ.
+	const char * pszName = strrchr( strShell.c_str(), '/' );
+	strArg0 = "-";
+	strArg0.append( pszName ? pszName + 1 : strShell.c_str() );
+
+	strHomeEnv = "HOME=" + strHome;
+	strShellEnv = "SHELL=" + strShell;
+	strUserEnv = "USER=";
+	strUserEnv.append( psttPasswd->pw_name );
+	strLogNameEnv = "LOGNAME=";
+	strLogNameEnv.append( psttPasswd->pw_name );
+
+	arrArg[0] = strArg0.c_str();
+	arrArg[1] = NULL;
+
+	arrEnv[0] = strHomeEnv.c_str();
+	arrEnv[1] = strShellEnv.c_str();
+	arrEnv[2] = strUserEnv.c_str();
+	arrEnv[3] = strLogNameEnv.c_str();
+	arrEnv[4] = "TERM=xterm";
+	arrEnv[5] = SESSION_PATH;
+	arrEnv[6] = NULL;
+
+	if( getrlimit( RLIMIT_NOFILE, &sttLimit ) == 0 && sttLimit.rlim_cur != RLIM_INFINITY && sttLimit.rlim_cur < 1048576 )
+	{
+		iMaxFd = (int)sttLimit.rlim_cur;
+	}
+
+	iPtyFd = posix_openpt( O_RDWR | O_NOCTTY | O_CLOEXEC );
+	if( iPtyFd == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s posix_openpt error(%d)", __FUNCTION__, errno );
+		return false;
+	}
+
+	memset( &sttSize, 0, sizeof(sttSize) );
+	sttSize.ws_row = SESSION_ROW;
+	sttSize.ws_col = SESSION_COL;
+
+	if( grantpt( iPtyFd ) == -1 || unlockpt( iPtyFd ) == -1 || ptsname_r( iPtyFd, szSlave, sizeof(szSlave) ) != 0 ||
+			ioctl( iPtyFd, TIOCSWINSZ, &sttSize ) == -1 || SetNonBlocking( iPtyFd ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s pty error(%d)", __FUNCTION__, errno );
+		close( iPtyFd );
+		return false;
+	}
+
+	// shell  ڽ μ ϱ   cgroup  ̵ϵ θ μ AddSession  ȣ  exec  ʴ´.
+	if( pipe2( arrSync, O_CLOEXEC ) == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s pipe error(%d)", __FUNCTION__, errno );
+		close( iPtyFd );
+		return false;
+	}
+
+	memset( &sttAction, 0, sizeof(sttAction) );
+	sttAction.sa_handler = SIG_DFL;
+
+	iPid = fork();
+	if( iPid == -1 )
+	{
+		CLog::Print( LOG_ERROR, "%s fork error(%d)", __FUNCTION__, errno );
+		close( iPtyFd );
+		close( arrSync[0] );
+		close( arrSync[1] );
+		return false;
+	}
+
+	if( iPid == 0 )
+	{
+		close( arrSync[1] );
+
+		// θ μ pipe   EOF  ŵȴ.
+		while( read( arrSync[0], &cSync, 1 ) == -1 && errno == EINTR );
+
+		setsid();
+
+		int iSlaveFd = open( szSlave, O_RDWR );
+		if( iSlaveFd == -1 ) _exit( 127 );
+
+		ioctl( iSlaveFd, TIOCSCTTY, 0 );
+
+		dup2( iSlaveFd, 0 );
+		dup2( iSlaveFd, 1 );
+		dup2( iSlaveFd, 2 );
+
+		//  listen ϰ ٸ   shell   ʴ´.
+#ifdef SYS_close_range
+		if( syscall( SYS_close_range, 3, ~0U, 0 ) == -1 )
+#endif
+		{
+			for( int iFd = 3; iFd < iMaxFd; ++iFd ) close( iFd );
+		}
+
+		CTeardown::RestoreChildSignal();
+		sigaction( SIGPIPE, &sttAction, NULL );
+
+		if( chdir( strHome.c_str() ) == -1 && chdir( "/" ) == -1 ) _exit( 127 );
+
+		execve( strShell.c_str(), (char * const *)arrArg, (char * const *)arrEnv );
+		_exit( 127 );
+	}
+
+	close( arrSync[0] );
+
+	gclsTeardown.AddChild( iPid );
+
+	if( gclsCgroup.IsOpen() && gclsCgroup.AddSession( pclsSession->m_iSessionId, iPid ) == false )
+	{
+		CLog::Print( LOG_ERROR, "%s session(%d) cgroup error(%d)", __FUNCTION__, pclsSession->m_iSessionId, errno );
+	}
+
+	if( write( arrSync[1], &cSync, 1 ) != 1 )
+	{
+		// ڽ μ pipe    Ѵ.
+	}
+
+	close( arrSync[1] );
+
+	pclsSession->m_iPtyFd = iPtyFd;
+	pclsSession->m_iPid = iPid;
+	pclsSession->m_eState = E_SS_RELAY;
+
+	gclsScheduler.AddSession( pclsSession->m_iSessionId, pclsSession->m_hSocket, pclsSession->m_strIp.c_str() );
+
+	m_clsPidMap.insert( SESSION_PID_MAP::value_type( iPid, pclsSession->m_iSessionId ) );
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief Ͽ  ͸ ȣȭϿ PTY  ۿ Ѵ.
+ * @param pclsSession 
+ * @returns ϸ true  ϰ  Ǿų ȣȭ ϸ false  Ѵ.
+ */
+bool CSessionMap::RecvSocket( CSession * pclsSession )
+{
+	int n = recv( pclsSession->m_hSocket, m_szFrame, sizeof(m_szFrame), MSG_DONTWAIT );
+	if( n == -1 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ) return true;
+	if( n <= 0 ) return false;
+
+	// kTLS  Ŀο ȣȭѴ.
+	if( pclsSession->m_clsCipher.IsKtls() )
+	{
+		pclsSession->m_strPtyBuf.append( m_szFrame, n );
+		return true;
+	}
+
+	std::string & strBuf = pclsSession->m_strRecvBuf;
+	size_t iPos = 0;
+
+	strBuf.append( m_szFrame, n );
+
+	while( strBuf.length() - iPos >= AEAD_HEADER_SIZE )
+	{
+		const uint8_t * pszHeader = (const uint8_t *)strBuf.data() + iPos;
+		uint32_t iBodyLen = ( (uint32_t)pszHeader[0] << 24 ) | ( (uint32_t)pszHeader[1] << 16 ) | ( (uint32_t)pszHeader[2] << 8 ) | pszHeader[3];
+
+		if( iBodyLen < AEAD_TAG_SIZE || iBodyLen > AEAD_MAX_PLAIN_SIZE + AEAD_TAG_SIZE ) return false;
+		if( strBuf.length() - iPos < AEAD_HEADER_SIZE + iBodyLen ) break;
+
+		memcpy( m_szFrame, strBuf.data() + iPos, AEAD_HEADER_SIZE + iBodyLen );
+
+		n = pclsSession->m_clsCipher.Open( m_szFrame, AEAD_HEADER_SIZE + iBodyLen );
+		if( n == -1 ) return false;
+
+		pclsSession->m_strPtyBuf.append( m_szFrame + AEAD_HEADER_SIZE, n );
+		iPos += AEAD_HEADER_SIZE + iBodyLen;
+	}
+
+	if( iPos > 0 ) strBuf.erase( 0, iPos );
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief shell  о ȣȭ Ŀ ٷ ť Ѵ.   interactive Ŷ 켱 ۵ȴ.
+ * @param pclsSession 
+ * @returns ϸ true  ϰ shell  Ǿ false  Ѵ.
+ */
+bool CSessionMap::RecvPty( CSession * pclsSession )
+{
+	int n = read( pclsSession->m_iPtyFd, m_szFrame + AEAD_HEADER_SIZE, AEAD_MAX_PLAIN_SIZE );
+	if( n == -1 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ) return true;
+
+	//  slave   EIO  ϵȴ.
+	if( n <= 0 ) return false;
+
+	if( pclsSession->m_clsCipher.IsKtls() )
+	{
+		return gclsScheduler.Send( pclsSession->m_iSessionId, SESSION_SEND_CHANNEL, m_szFrame + AEAD_HEADER_SIZE, n );
+	}
+
+	n = pclsSession->m_clsCipher.Seal( m_szFrame, n );
+	if( n == -1 ) return false;
+
+	return gclsScheduler.Send( pclsSession->m_iSessionId, SESSION_SEND_CHANNEL, m_szFrame, n );
+}
+
+/**
+ * @ingroup Server
+ * @brief shell  ̿ ͸ ȣȭϿ ٷ ť Ѵ.
+ * @param pclsSession	
+ * @param pszData			 
+ * @param iLen				  
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CSessionMap::Output( CSession * pclsSession, const char * pszData, int iLen )
+{
+	int iPos, n;
+
+	for( iPos = 0; iPos < iLen; iPos += n )
+	{
+		n = iLen - iPos;
+		if( n > AEAD_MAX_PLAIN_SIZE ) n = AEAD_MAX_PLAIN_SIZE;
+
+		memcpy( m_szFrame + AEAD_HEADER_SIZE, pszData + iPos, n );
+
+		if( pclsSession->m_clsCipher.IsKtls() )
+		{
+			if( gclsScheduler.Send( pclsSession->m_iSessionId, SESSION_SEND_CHANNEL, m_szFrame + AEAD_HEADER_SIZE, n ) == false ) return false;
+		}
+		else
+		{
+			int iFrameLen = pclsSession->m_clsCipher.Seal( m_szFrame, n );
+			if( iFrameLen == -1 ) return false;
+
+			if( gclsScheduler.Send( pclsSession->m_iSessionId, SESSION_SEND_CHANNEL, m_szFrame, iFrameLen ) == false ) return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief PTY   ͸ shell  Ѵ.
+ * @param pclsSession 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool CSessionMap::WritePty( CSession * pclsSession )
+{
+	std::string & strBuf = pclsSession->m_strPtyBuf;
+
+	if( strBuf.empty() ) return true;
+
+	int n = write( pclsSession->m_iPtyFd, strBuf.data(), strBuf.length() );
+	if( n == -1 ) return ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR );
+
+	strBuf.erase( 0, n );
+
+	return true;
+}
+
+/**
+ * @ingroup Server
+ * @brief  ϰ , PTY, shell μ Ḧ ûѴ.
+ * @param pclsSession	
+ * @param eMode				  
+ */
+void CSessionMap::Delete( CSession * pclsSession, ETeardownMode eMode )
+{
+	if( pclsSession->m_iPid > 0 ) m_clsPidMap.erase( pclsSession->m_iPid );
+	m_clsMap.erase( pclsSession->m_iSessionId );
+
+	// ٷ ť  ʹ    ۿ  ͸    Ѵ.
+	gclsScheduler.DeleteSession( pclsSession->m_iSessionId );
+
+	gclsTeardown.Add( pclsSession->m_hSocket, pclsSession->m_iPtyFd, pclsSession->m_iPid, eMode );
+
+	m_clsPool.Put( pclsSession );
+}
+
+#endif
@@ -0,0 +1,163 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _SESSION_H_
+#define _SESSION_H_
+
+#include "Tcp.h"
+#include "AeadCipher.h"
+#include "Teardown.h"
+#include "Cgroup.h"
+#include "CommandQueue.h"
+#include "Handover.h"
+#include "SendScheduler.h"
+
+#ifdef USE_TLS
+
+#include <vector>
+#include <map>
+#include "ObjectPool.h"
+
+// Ű ȯ timeout (   ). Ű ȯ Ϸ ʴ  RST  Ѵ.
+#define SESSION_HANDSHAKE_SECOND	10
+
+// shell   Ŀ   ϴ ִ ð (   )
+#define SESSION_FLUSH_SECOND			5
+
+//  / PTY     ִ ũ. ʰϸ ݴ   ʴ´.
+#define SESSION_MAX_BUF_SIZE			( 256 * 1024 )
+
+//   ϴ ٷ ä. AEAD  ȣȭ  ؾ ϹǷ   ϳ äη Ѵ.
+#define SESSION_SEND_CHANNEL			0
+
+// PTY â ũ ⺻
+#define SESSION_ROW								24
+#define SESSION_COL								80
+
+/**
+ * @ingroup Server
+ * @brief  
+ */
+enum ESessionState
+{
+	/** Ű ȯ ̴. */
+	E_SS_HANDSHAKE = 0,
+
+	/** ϰ shell PTY ̿ ͸ Ѵ. */
+	E_SS_RELAY,
+
+	/** shell  Ǿ   ϰ ִ. */
+	E_SS_FLUSH
+};
+
+/**
+ * @ingroup Server
+ * @brief Ŭ̾Ʈ  shell μ
+ */
+class CSession
+{
+public:
+	CSession();
+	void Clear();
+
+	int			m_iSessionId;
+	Socket	m_hSocket;
+	int			m_iPtyFd;
+
+	/** shell μ ̵. ȸǾ -1 ̴. */
+	int			m_iPid;
+
+	ESessionState	m_eState;
+
+	/** Ű ȯ Ǵ    ð ( monotonic milli second ) */
+	uint64_t	m_iDeadline;
+
+	std::string	m_strIp;
+	CAeadCipher	m_clsCipher;
+
+	/**  ȣȭ    ϼ   */
+	std::string	m_strRecvBuf;
+
+	/** PTY    .    ʹ gclsScheduler  ȴ. */
+	std::string	m_strPtyBuf;
+
+	/** poll Ͽ ġ. poll   -1 ̴. */
+	int	m_iSocketIndex;
+	int	m_iPtyIndex;
+};
+
+typedef std::map< int, CSession * > SESSION_MAP;
+typedef std::map< int, int > SESSION_PID_MAP;
+
+/**
+ * @ingroup Server
+ * @brief reactor thread    Ű ȯ   non-blocking  óѴ.
+ *	-   Add  ϰ Ű ȯ ϷǸ PTY  shell μ Ѵ.
+ *	- ̺Ʈ  SetPoll  poll Ͽ  ϰ PTY  ߰ϰ poll  ϵǸ Process  ȣѴ.
+ *	-   gclsScheduler  Ͽ ٸ ǰ 뿪 ϰ  interactive  켱 Ѵ.
+ *	-   gclsTeardown  ûѴ.
+ *	-  ׷̵ Export   ο μ Import ϸ  ϰ  Ѵ.
+ *	- ٸ thread  ǿ   ʰ  ť   reactor thread  Execute  Ѵ.
+ */
+class CSessionMap
+{
+public:
+	CSessionMap();
+	~CSessionMap();
+
+	void SetPsk( const std::string & strPsk );
+
+	bool Add( Socket hSocket, const char * pszIp );
+	void SetPoll( std::vector< pollfd > & clsPollList );
+	void Process( std::vector< pollfd > & clsPollList );
+	void SetExit( int iPid );
+	void Execute( CSessionCommand * pclsCommand );
+
+	void Export( HANDOVER_SESSION_LIST & clsList );
+	void Import( HANDOVER_SESSION_LIST & clsList );
+
+	int GetTimeout();
+	int GetCount();
+
+private:
+	bool StartShell( CSession * pclsSession );
+	bool RecvSocket( CSession * pclsSession );
+	bool RecvPty( CSession * pclsSession );
+	bool Output( CSession * pclsSession, const char * pszData, int iLen );
+	bool WritePty( CSession * pclsSession );
+	void Delete( CSession * pclsSession, ETeardownMode eMode );
+
+	std::string	m_strPsk;
+
+	SESSION_MAP	m_clsMap;
+	SESSION_PID_MAP	m_clsPidMap;
+	CObjectPool< CSession > m_clsPool;
+	int	m_iNextId;
+
+	/** gclsScheduler.Run()   token   ð */
+	int	m_iSendTimeout;
+
+	/** ȣȭ / ȣȭ  */
+	char	m_szFrame[AEAD_MAX_FRAME_SIZE];
+};
+
+extern CSessionMap gclsSessionMap;
+
+#endif
+
+#endif
@@ -0,0 +1,434 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "TestTelnet.h"
+#include "AeadCipher.h"
+
+#ifdef USE_TLS
+
+#define TEST_AEAD_PSK		"test-aead-pre-shared-key"
+#define TEST_AEAD_PORT	18890
+
+/**
+ * @ingroup TestTelnet
+ * @brief  
+ */
+enum ETestAeadMode
+{
+	E_TAM_PLAIN = 0,
+	E_TAM_USER,
+	E_TAM_KTLS
+};
+
+static const char * garrModeName[] = { "plain", "user-space", "ktls" };
+
+/**
+ * @ingroup TestTelnet
+ * @brief loopback  thread 
+ */
+class CTestAeadRecv
+{
+public:
+	Socket	m_hListen;
+	ETestAeadMode	m_eMode;
+	uint64_t	m_iRecvSize;
+	bool	m_bKtls;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief socketpair   cipher  Ű non-blocking  ȯѴ.
+ * @param clsClient	Ŭ̾Ʈ cipher
+ * @param clsServer	 cipher
+ * @param eSuite		 AEAD ˰
+ * @param pszClientPsk	Ŭ̾Ʈ    Ű.  TEST_AEAD_PSK  Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool Pair( CAeadCipher & clsClient, CAeadCipher & clsServer, EAeadSuite eSuite, const char * pszClientPsk = TEST_AEAD_PSK )
+{
+	int arrFd[2], iClient = 0, iServer = 0;
+	bool bRes = false;
+
+	if( socketpair( AF_UNIX, SOCK_STREAM, 0, arrFd ) == -1 ) return false;
+
+	clsClient.SetSuite( eSuite );
+	clsServer.SetSuite( eSuite );
+
+	if( clsClient.HandshakeStart( arrFd[0], false, pszClientPsk ) && clsServer.HandshakeStart( arrFd[1], true, TEST_AEAD_PSK ) )
+	{
+		for( int i = 0; i < 100; ++i )
+		{
+			if( iClient == 0 ) iClient = clsClient.HandshakeRecv( arrFd[0] );
+			if( iServer == 0 ) iServer = clsServer.HandshakeRecv( arrFd[1] );
+
+			if( iClient == -1 || iServer == -1 ) break;
+			if( iClient == 1 && iServer == 1 )
+			{
+				bRes = ( clsClient.GetSuite() == eSuite && clsServer.GetSuite() == eSuite );
+				break;
+			}
+		}
+	}
+
+	close( arrFd[0] );
+	close( arrFd[1] );
+
+	return bRes;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief   Ű ٸ Ű ȯ ϰ ȣ̳ tag  1 byte  Ǹ ȣȭ ϴ ˻Ѵ.
+ * @param eSuite	AEAD ˰
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestReject( EAeadSuite eSuite )
+{
+	const char * pszName = ( eSuite == E_AEAD_AES_256_GCM ) ? "aes-256-gcm" : "chacha20-poly1305";
+
+	{
+		CAeadCipher clsClient, clsServer;
+
+		if( Pair( clsClient, clsServer, eSuite, "wrong-aead-pre-shared-key" ) )
+		{
+			printf( "%s handshake with mismatched PSK succeeded\n", pszName );
+			return false;
+		}
+	}
+
+	CAeadCipher clsClient, clsServer;
+	char szFrame[AEAD_HEADER_SIZE+64+AEAD_TAG_SIZE], szCopy[sizeof(szFrame)];
+	int iFrameLen;
+
+	if( Pair( clsClient, clsServer, eSuite ) == false )
+	{
+		printf( "%s handshake error\n", pszName );
+		return false;
+	}
+
+	memset( szFrame, 'a', sizeof(szFrame) );
+	iFrameLen = clsClient.Seal( szFrame, 64 );
+	if( iFrameLen != (int)sizeof(szFrame) ) return false;
+
+	// ù° ȣ byte   tag byte  Ѵ. ȣȭ ϸ    ʴ´.
+	int arrPos[] = { AEAD_HEADER_SIZE, iFrameLen - 1 };
+
+	for( int i = 0; i < 2; ++i )
+	{
+		memcpy( szCopy, szFrame, iFrameLen );
+		szCopy[arrPos[i]] ^= 0x01;
+
+		if( clsServer.Open( szCopy, iFrameLen ) != -1 )
+		{
+			printf( "%s Open accepted a frame with flipped %s byte\n", pszName, i == 0 ? "ciphertext" : "tag" );
+			return false;
+		}
+	}
+
+	if( clsServer.Open( szFrame, iFrameLen ) != 64 )
+	{
+		printf( "%s Open error after rejected frames\n", pszName );
+		return false;
+	}
+
+	printf( "%-18s mismatched PSK and tampered frames rejected\n", pszName );
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief ϳ core  AEAD_MAX_PLAIN_SIZE  ȣȭ / ȣȭ+ȣȭϴ ӵ Ѵ.
+ * @param eSuite	AEAD ˰
+ * @param iSize		 ũ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestSeal( EAeadSuite eSuite, uint64_t iSize )
+{
+	CAeadCipher clsClient, clsServer;
+	static char szFrame[AEAD_MAX_FRAME_SIZE];
+	uint64_t iStart, iSealUs, iOpenUs, i;
+	const char * pszName = ( eSuite == E_AEAD_AES_256_GCM ) ? "aes-256-gcm" : "chacha20-poly1305";
+
+	if( Pair( clsClient, clsServer, eSuite ) == false )
+	{
+		printf( "%s handshake error\n", pszName );
+		return false;
+	}
+
+	memset( szFrame, 'a', sizeof(szFrame) );
+
+	iStart = GetTimeUs();
+
+	for( i = 0; i < iSize; i += AEAD_MAX_PLAIN_SIZE )
+	{
+		if( clsClient.Seal( szFrame, AEAD_MAX_PLAIN_SIZE ) == -1 ) return false;
+	}
+
+	iSealUs = GetTimeUs() - iStart;
+	iStart = GetTimeUs();
+
+	for( i = 0; i < iSize; i += AEAD_MAX_PLAIN_SIZE )
+	{
+		if( clsServer.Seal( szFrame, AEAD_MAX_PLAIN_SIZE ) == -1 ) return false;
+		if( clsClient.Open( szFrame, AEAD_MAX_FRAME_SIZE ) != AEAD_MAX_PLAIN_SIZE )
+		{
+			printf( "%s Open error\n", pszName );
+			return false;
+		}
+	}
+
+	iOpenUs = GetTimeUs() - iStart;
+
+	printf( "%-18s seal %6.2f GB/s  seal+open %6.2f GB/s ( 1 core )\n", pszName
+		, iSealUs ? (double)iSize / iSealUs / 1000 : 0, iOpenUs ? (double)iSize / iOpenUs / 1000 : 0 );
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief loopback  accept Ͽ  ũ⸦ Ѵ.
+ */
+static THREAD_API RecvThread( LPVOID lpParameter )
+{
+	CTestAeadRecv * pclsArg = (CTestAeadRecv *)lpParameter;
+	CAeadCipher clsCipher;
+	static char szFrame[AEAD_MAX_FRAME_SIZE];
+	int n;
+
+	Socket hSocket = accept( pclsArg->m_hListen, NULL, NULL );
+	if( hSocket == INVALID_SOCKET ) return 0;
+
+	if( pclsArg->m_eMode != E_TAM_PLAIN )
+	{
+		clsCipher.SetUseKtls( pclsArg->m_eMode == E_TAM_KTLS );
+
+		if( clsCipher.Handshake( hSocket, true, 10, TEST_AEAD_PSK ) == false )
+		{
+			closesocket( hSocket );
+			return 0;
+		}
+
+		pclsArg->m_bKtls = clsCipher.IsKtls();
+	}
+
+	while( 1 )
+	{
+		if( pclsArg->m_eMode == E_TAM_PLAIN )
+		{
+			n = recv( hSocket, szFrame, sizeof(szFrame), 0 );
+		}
+		else
+		{
+			n = TcpRecvAead( hSocket, clsCipher, szFrame, sizeof(szFrame), 10 );
+		}
+
+		if( n <= 0 ) break;
+
+		pclsArg->m_iRecvSize += n;
+	}
+
+	closesocket( hSocket );
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief loopback TCP  ϴ ӵ CPU  ð ۷ Ѵ.
+ * @param eMode	 
+ * @param iSize	 ũ
+ * @param pbKtls	NULL  ƴϸ   kTLS  Ͽ ϰ ӵ  ʴ´.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestLoopback( ETestAeadMode eMode, uint64_t iSize, bool * pbKtls = NULL )
+{
+	CTestAeadRecv clsArg;
+	CAeadCipher clsCipher;
+	static char szFrame[AEAD_MAX_FRAME_SIZE];
+	pthread_t sttThread;
+	uint64_t iStart, iCpuStart, iUs, iCpuUs, i;
+	bool bRes = true;
+
+	clsArg.m_hListen = TcpListen( TEST_AEAD_PORT, 1, "127.0.0.1" );
+	clsArg.m_eMode = eMode;
+	clsArg.m_iRecvSize = 0;
+	clsArg.m_bKtls = false;
+
+	if( clsArg.m_hListen == INVALID_SOCKET )
+	{
+		printf( "TcpListen(%d) error(%d)\n", TEST_AEAD_PORT, GetError() );
+		return false;
+	}
+
+	if( pthread_create( &sttThread, NULL, RecvThread, &clsArg ) != 0 )
+	{
+		closesocket( clsArg.m_hListen );
+		return false;
+	}
+
+	Socket hSocket = TcpConnect( "127.0.0.1", TEST_AEAD_PORT, 10 );
+	if( hSocket == INVALID_SOCKET )
+	{
+		bRes = false;
+	}
+	else if( eMode != E_TAM_PLAIN )
+	{
+		clsCipher.SetUseKtls( eMode == E_TAM_KTLS );
+		bRes = clsCipher.Handshake( hSocket, false, 10, TEST_AEAD_PSK );
+	}
+
+	memset( szFrame, 'a', sizeof(szFrame) );
+
+	iStart = GetTimeUs();
+	iCpuStart = GetCpuUs();
+
+	for( i = 0; bRes && i < iSize; i += AEAD_MAX_PLAIN_SIZE )
+	{
+		if( eMode == E_TAM_PLAIN )
+		{
+			if( TcpSend( hSocket, szFrame, AEAD_MAX_PLAIN_SIZE ) != AEAD_MAX_PLAIN_SIZE ) bRes = false;
+		}
+		else if( TcpSendAead( hSocket, clsCipher, szFrame, AEAD_MAX_PLAIN_SIZE ) != AEAD_MAX_PLAIN_SIZE )
+		{
+			bRes = false;
+		}
+	}
+
+	if( hSocket != INVALID_SOCKET ) shutdown( hSocket, SHUT_WR );
+
+	//  thread     Ѵ.
+	if( hSocket == INVALID_SOCKET ) shutdown( clsArg.m_hListen, SHUT_RDWR );
+	pthread_join( sttThread, NULL );
+
+	iUs = GetTimeUs() - iStart;
+	iCpuUs = GetCpuUs() - iCpuStart;
+
+	if( hSocket != INVALID_SOCKET ) closesocket( hSocket );
+	closesocket( clsArg.m_hListen );
+
+	if( bRes == false || clsArg.m_iRecvSize != i )
+	{
+		printf( "%-10s error send(" UNSIGNED_LONG_LONG_FORMAT ") recv(" UNSIGNED_LONG_LONG_FORMAT ")\n", garrModeName[eMode], i, clsArg.m_iRecvSize );
+		return false;
+	}
+
+	if( pbKtls )
+	{
+		*pbKtls = ( clsCipher.IsKtls() && clsArg.m_bKtls );
+		return true;
+	}
+
+	if( eMode == E_TAM_KTLS && clsArg.m_bKtls == false )
+	{
+		printf( "%-10s kTLS is not available - measured user-space\n", garrModeName[eMode] );
+	}
+
+	printf( "%-10s %6.2f GB/s  %6.2f GB per CPU second\n", garrModeName[eMode]
+		, iUs ? (double)iSize / iUs / 1000 : 0, iCpuUs ? (double)iSize / iCpuUs / 1000 : 0 );
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief Ŀ TLS ULP  ϸ kTLS  ϰ ׷  user-space ȣȭ ϴ ˻Ѵ.
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestKtls()
+{
+	char szUlp[256];
+	bool bListed = false, bKtls;
+
+	FILE * fd = fopen( "/proc/sys/net/ipv4/tcp_available_ulp", "r" );
+	if( fd )
+	{
+		if( fgets( szUlp, sizeof(szUlp), fd ) )
+		{
+			for( char * pszToken = strtok( szUlp, " \t\r\n" ); pszToken; pszToken = strtok( NULL, " \t\r\n" ) )
+			{
+				if( !strcmp( pszToken, "tls" ) ) bListed = true;
+			}
+		}
+
+		fclose( fd );
+	}
+
+	if( TestLoopback( E_TAM_KTLS, 1024 * 1024, &bKtls ) == false ) return false;
+
+	if( bListed && bKtls == false )
+	{
+		printf( "ktls       tls is listed in tcp_available_ulp but kTLS is not used\n" );
+		return false;
+	}
+
+	printf( "ktls       %s\n", bKtls ? "kTLS is used" : "tls ULP is not available - user-space fallback" );
+
+	//  kTLS      user-space ȣȭ Ѵ.
+	if( TestLoopback( E_TAM_USER, 1024 * 1024, &bKtls ) == false ) return false;
+
+	if( bKtls )
+	{
+		printf( "ktls       kTLS is used although it is disabled\n" );
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief AEAD ˰ ȣȭ ӵ loopback  ӵ Ѵ.
+ *	-  : TestTelnet aead [MB]
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestAead( int argc, char * argv[] )
+{
+	uint64_t iSize = (uint64_t)( argc >= 1 ? atoi( argv[0] ) : 1024 ) * 1024 * 1024;
+
+	if( iSize == 0 ) return false;
+
+	printf( "AES-NI/PCLMUL %s\n", CpuSupportAesNi() ? "supported" : "not supported" );
+
+	if( TestReject( E_AEAD_AES_256_GCM ) == false ) return false;
+	if( TestReject( E_AEAD_CHACHA20_POLY1305 ) == false ) return false;
+
+	if( TestKtls() == false ) return false;
+
+	if( TestSeal( E_AEAD_AES_256_GCM, iSize ) == false ) return false;
+	if( TestSeal( E_AEAD_CHACHA20_POLY1305, iSize ) == false ) return false;
+
+	if( TestLoopback( E_TAM_PLAIN, iSize ) == false ) return false;
+	if( TestLoopback( E_TAM_USER, iSize ) == false ) return false;
+	if( TestLoopback( E_TAM_KTLS, iSize ) == false ) return false;
+
+	return true;
+}
+
+#else
+
+bool TestAead( int argc, char * argv[] )
+{
+	printf( "USE_TLS is not defined\n" );
+	return false;
+}
+
+#endif
@@ -0,0 +1,299 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+
+#include "TestTelnet.h"
+#include "AeadCipher.h"
+
+#if defined(USE_TLS) && !defined(WIN32)
+
+#include <poll.h>
+#include <vector>
+#include <algorithm>
+
+//    ϴ   Ű . Client α׷   Ѵ.
+#define TEST_HANDOVER_PSK_FILE		"TelnetClient.psk"
+#define TEST_HANDOVER_PORT				8888
+
+// ׷̵  / Ŀ   ϴ ð ( milli second  )
+#define TEST_HANDOVER_MS					3000
+
+/**
+ * @ingroup TestTelnet
+ * @brief ׷̵  ϴ 
+ */
+class CTestHandoverSession
+{
+public:
+	CTestHandoverSession() : m_hSocket(INVALID_SOCKET), m_iSendUs(0), m_iMaxGapUs(0), m_iProbe(0), m_bClosed(false)
+	{}
+
+	Socket	m_hSocket;
+	CAeadCipher	m_clsCipher;
+
+	/**  ٸ probe   ð. 0 ̸ ٸ probe  . */
+	uint64_t	m_iSendUs;
+
+	/** probe         ɸ ð */
+	uint64_t	m_iMaxGapUs;
+
+	int		m_iProbe;
+	bool	m_bClosed;
+};
+
+typedef std::vector< CTestHandoverSession * > TEST_HANDOVER_LIST;
+
+/**
+ * @ingroup TestTelnet
+ * @brief shell  echo ϵ 1 byte  Ѵ. Է   ʵ ڿ  Ű  Ѵ.
+ * @param clsSession 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool SendProbe( CTestHandoverSession & clsSession )
+{
+	char szFrame[AEAD_HEADER_SIZE+1+AEAD_TAG_SIZE];
+
+	szFrame[AEAD_HEADER_SIZE] = ( clsSession.m_iProbe++ % 2 ) ? 0x7f : 'x';
+
+	if( TcpSendAead( clsSession.m_hSocket, clsSession.m_clsCipher, szFrame, 1 ) != 1 ) return false;
+
+	clsSession.m_iSendUs = GetTimeUs();
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief ŵ   а probe  ð Ѵ.
+ * @param clsList			 
+ * @param iTimeoutMs	poll  ð ( milli second  )
+ * @returns     Ѵ.
+ */
+static int RecvProbe( TEST_HANDOVER_LIST & clsList, int iTimeoutMs )
+{
+	static char szFrame[AEAD_MAX_FRAME_SIZE];
+	std::vector< pollfd > clsPollList( clsList.size() );
+	uint64_t iNow;
+	int n, iCount = 0;
+
+	for( size_t i = 0; i < clsList.size(); ++i )
+	{
+		TcpSetPollIn( clsPollList[i], clsList[i]->m_bClosed ? -1 : clsList[i]->m_hSocket );
+	}
+
+	if( poll( &clsPollList[0], clsPollList.size(), iTimeoutMs ) <= 0 ) return 0;
+
+	iNow = GetTimeUs();
+
+	for( size_t i = 0; i < clsList.size(); ++i )
+	{
+		CTestHandoverSession * pclsSession = clsList[i];
+
+		if( clsPollList[i].revents == 0 ) continue;
+
+		n = TcpRecvAead( pclsSession->m_hSocket, pclsSession->m_clsCipher, szFrame, sizeof(szFrame), 1 );
+		if( n < 0 )
+		{
+			pclsSession->m_bClosed = true;
+			continue;
+		}
+
+		if( pclsSession->m_iSendUs )
+		{
+			if( iNow - pclsSession->m_iSendUs > pclsSession->m_iMaxGapUs ) pclsSession->m_iMaxGapUs = iNow - pclsSession->m_iSendUs;
+			pclsSession->m_iSendUs = 0;
+			++iCount;
+		}
+	}
+
+	return iCount;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief   Ǹ  probe  ϸ鼭 iMs  Ǻ ִ   Ѵ.
+ * @param clsList	 
+ * @param iMs			 ð ( milli second  )
+ * @param iPid		0  ũ    SIGUSR2    μ ̵
+ * @returns ϸ true  ϰ    false  Ѵ.
+ */
+static bool Measure( TEST_HANDOVER_LIST & clsList, int iMs, int iPid )
+{
+	std::vector< uint64_t > clsGapList;
+	uint64_t iStart, iNow;
+	int iClosed = 0;
+
+	for( size_t i = 0; i < clsList.size(); ++i )
+	{
+		clsList[i]->m_iMaxGapUs = 0;
+	}
+
+	iStart = GetTimeUs();
+
+	if( iPid > 0 && kill( iPid, SIGUSR2 ) != 0 )
+	{
+		printf( "kill(%d) error(%d)\n", iPid, errno );
+		return false;
+	}
+
+	while( ( iNow = GetTimeUs() ) - iStart < (uint64_t)iMs * 1000 )
+	{
+		for( size_t i = 0; i < clsList.size(); ++i )
+		{
+			CTestHandoverSession * pclsSession = clsList[i];
+
+			if( pclsSession->m_bClosed || pclsSession->m_iSendUs ) continue;
+			if( SendProbe( *pclsSession ) == false ) pclsSession->m_bClosed = true;
+		}
+
+		RecvProbe( clsList, 1 );
+	}
+
+	for( size_t i = 0; i < clsList.size(); ++i )
+	{
+		CTestHandoverSession * pclsSession = clsList[i];
+
+		//      probe   Ѵ.
+		if( pclsSession->m_iSendUs && iNow - pclsSession->m_iSendUs > pclsSession->m_iMaxGapUs ) pclsSession->m_iMaxGapUs = iNow - pclsSession->m_iSendUs;
+		if( pclsSession->m_bClosed ) ++iClosed;
+
+		clsGapList.push_back( pclsSession->m_iMaxGapUs );
+	}
+
+	std::sort( clsGapList.begin(), clsGapList.end() );
+
+	printf( "%-9s sessions %d closed %d  max stall per session: p50 %.1f ms  p99 %.1f ms  max %.1f ms\n", iPid > 0 ? "upgrade" : "baseline"
+		, (int)clsList.size(), iClosed, clsGapList[clsGapList.size()/2] / 1000.0, clsGapList[clsGapList.size()*99/100] / 1000.0, clsGapList.back() / 1000.0 );
+
+	return ( iClosed == 0 );
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief     ϰ ׷̵ ( SIGUSR2 )    ʴ ð Ѵ.
+ *	-  : TestTelnet handover { } { PID} [ IP]
+ *	-   TelnetClient.psk  Ű ȯϰ Ǹ 1 byte  Ͽ shell  echo  ٸ.
+ *	-  α "handover ... in N us"  ο μ   ð̴.
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestHandover( int argc, char * argv[] )
+{
+	TEST_HANDOVER_LIST clsList;
+	std::string strPsk;
+	const char * pszIp = "127.0.0.1";
+	int iCount, iPid, iReply;
+	uint64_t iStart;
+	bool bRes = false;
+
+	if( argc < 2 ) return false;
+
+	iCount = atoi( argv[0] );
+	iPid = atoi( argv[1] );
+	if( argc >= 3 ) pszIp = argv[2];
+
+	if( iCount <= 0 || iPid <= 0 ) return false;
+
+	if( LoadPsk( TEST_HANDOVER_PSK_FILE, strPsk ) == false )
+	{
+		printf( "LoadPsk(%s) error\n", TEST_HANDOVER_PSK_FILE );
+		return false;
+	}
+
+	struct rlimit sttLimit;
+
+	// Ǹ  ϳ Ѵ.
+	if( getrlimit( RLIMIT_NOFILE, &sttLimit ) == 0 && sttLimit.rlim_cur < sttLimit.rlim_max )
+	{
+		sttLimit.rlim_cur = sttLimit.rlim_max;
+		setrlimit( RLIMIT_NOFILE, &sttLimit );
+	}
+
+	iStart = GetTimeUs();
+
+	for( int i = 0; i < iCount; ++i )
+	{
+		CTestHandoverSession * pclsSession = new CTestHandoverSession();
+
+		clsList.push_back( pclsSession );
+
+		pclsSession->m_hSocket = TcpConnect( pszIp, TEST_HANDOVER_PORT, 10 );
+		if( pclsSession->m_hSocket == INVALID_SOCKET )
+		{
+			printf( "session(%d) TcpConnect(%s:%d) error(%d)\n", i, pszIp, TEST_HANDOVER_PORT, GetError() );
+			goto FUNC_END;
+		}
+
+		if( pclsSession->m_clsCipher.Handshake( pclsSession->m_hSocket, false, 10, strPsk.c_str() ) == false )
+		{
+			printf( "session(%d) Handshake error\n", i );
+			goto FUNC_END;
+		}
+	}
+
+	printf( "%d sessions connected in %.1f ms\n", iCount, ( GetTimeUs() - iStart ) / 1000.0 );
+
+	//  shell  ۵Ǿ probe    ٸ Ŀ   д´.
+	for( int i = 0; i < iCount; ++i )
+	{
+		if( SendProbe( *clsList[i] ) == false )
+		{
+			printf( "session(%d) send error - check the server log\n", i );
+			goto FUNC_END;
+		}
+	}
+
+	iReply = 0;
+	iStart = GetTimeUs();
+
+	while( iReply < iCount && GetTimeUs() - iStart < 60000000 )
+	{
+		iReply += RecvProbe( clsList, 100 );
+	}
+
+	if( iReply < iCount )
+	{
+		printf( "%d/%d shells answered - check the server log and its open file limit\n", iReply, iCount );
+		goto FUNC_END;
+	}
+
+	iStart = GetTimeUs();
+	while( GetTimeUs() - iStart < 1000000 ) RecvProbe( clsList, 100 );
+
+	bRes = Measure( clsList, TEST_HANDOVER_MS, 0 ) && Measure( clsList, TEST_HANDOVER_MS, iPid );
+
+FUNC_END:
+	for( size_t i = 0; i < clsList.size(); ++i )
+	{
+		if( clsList[i]->m_hSocket != INVALID_SOCKET ) closesocket( clsList[i]->m_hSocket );
+		delete clsList[i];
+	}
+
+	return bRes;
+}
+
+#else
+
+bool TestHandover( int argc, char * argv[] )
+{
+	printf( "USE_TLS is not defined\n" );
+	return false;
+}
+
+#endif
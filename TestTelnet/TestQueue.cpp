@@ -0,0 +1,187 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "TestTelnet.h"
+#include "CommandQueue.h"
+
+#ifndef WIN32
+
+// ִ producer thread 
+#define TEST_QUEUE_MAX_THREAD	64
+
+/**
+ * @ingroup TestTelnet
+ * @brief producer thread 
+ */
+class CTestQueueArg
+{
+public:
+	CCommandQueue * m_pclsQueue;
+	int	m_iIndex;
+	uint32_t	m_iCount;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief  iCount  ߰Ѵ.   ˻ϵ  ̵ thread ȣ, ͹̳ ũ⿡  ȣ Ѵ.
+ */
+static THREAD_API PushThread( LPVOID lpParameter )
+{
+	CTestQueueArg * pclsArg = (CTestQueueArg *)lpParameter;
+
+	for( uint32_t i = 0; i < pclsArg->m_iCount; ++i )
+	{
+		CSessionCommand * pclsCommand = new CSessionCommand( E_SC_WINDOW_SIZE, pclsArg->m_iIndex );
+
+		pclsCommand->m_iRow = (uint16_t)( i >> 16 );
+		pclsCommand->m_iCol = (uint16_t)( i & 0xFFFF );
+
+		pclsArg->m_pclsQueue->Push( pclsCommand );
+	}
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief  producer thread  ÿ  ߰ϰ consumer  eventfd  Ͽ   ´.
+ *	-   Դ, thread    Ǵ, wakeup  ǵ ʴ ˻ϰ ʴ ó  Ѵ.
+ *	-  ť  ִµ poll  timeout Ǹ wakeup  ǵ ̴.
+ *	-  : TestTelnet queue [producer thread ] [thread   ]
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestQueue( int argc, char * argv[] )
+{
+	CCommandQueue clsQueue;
+	CTestQueueArg arrArg[TEST_QUEUE_MAX_THREAD];
+	pthread_t arrThread[TEST_QUEUE_MAX_THREAD];
+	uint32_t arrNext[TEST_QUEUE_MAX_THREAD];
+	int iThreadCount = argc >= 1 ? atoi( argv[0] ) : 4;
+	uint32_t iCount = argc >= 2 ? (uint32_t)atoi( argv[1] ) : 1000000;
+	uint64_t iTotal, iPopCount = 0, iWakeCount = 0, iStart, iUs;
+	CSessionCommand * pclsCommand;
+	pollfd sttPoll[1];
+	bool bRes = true;
+	int i, n;
+
+	if( iThreadCount <= 0 || iThreadCount > TEST_QUEUE_MAX_THREAD || iCount == 0 ) return false;
+
+	if( clsQueue.Open() == false )
+	{
+		printf( "Open error\n" );
+		return false;
+	}
+
+	iTotal = (uint64_t)iThreadCount * iCount;
+	iStart = GetTimeUs();
+
+	for( i = 0; i < iThreadCount; ++i )
+	{
+		arrArg[i].m_pclsQueue = &clsQueue;
+		arrArg[i].m_iIndex = i;
+		arrArg[i].m_iCount = iCount;
+		arrNext[i] = 0;
+
+		if( pthread_create( &arrThread[i], NULL, PushThread, &arrArg[i] ) != 0 )
+		{
+			printf( "pthread_create error\n" );
+			iThreadCount = i;
+			iTotal = (uint64_t)iThreadCount * iCount;
+			bRes = false;
+			break;
+		}
+	}
+
+	while( iPopCount < iTotal )
+	{
+		TcpSetPollIn( sttPoll[0], clsQueue.GetEventFd() );
+
+		n = poll( sttPoll, 1, 1000 );
+		if( n == -1 )
+		{
+			if( errno == EINTR ) continue;
+			bRes = false;
+			break;
+		}
+
+		bool bTimeout = ( n == 0 );
+
+		++iWakeCount;
+		clsQueue.ClearEvent();
+
+		while( ( pclsCommand = clsQueue.Pop() ) != NULL )
+		{
+			int iIndex = pclsCommand->m_iSessionId;
+			uint32_t iSeq = ( (uint32_t)pclsCommand->m_iRow << 16 ) | pclsCommand->m_iCol;
+
+			if( iIndex < 0 || iIndex >= iThreadCount || arrNext[iIndex] != iSeq )
+			{
+				printf( "order error thread(%d) seq(%u)\n", iIndex, iSeq );
+				bRes = false;
+			}
+			else
+			{
+				++arrNext[iIndex];
+			}
+
+			if( bTimeout )
+			{
+				printf( "lost wakeup - command is queued without event\n" );
+				bRes = false;
+				bTimeout = false;
+			}
+
+			delete pclsCommand;
+			++iPopCount;
+		}
+
+		if( bRes == false ) break;
+	}
+
+	iUs = GetTimeUs() - iStart;
+
+	for( i = 0; i < iThreadCount; ++i )
+	{
+		pthread_join( arrThread[i], NULL );
+	}
+
+	clsQueue.Close();
+
+	if( bRes == false || iPopCount != iTotal )
+	{
+		printf( "pop(" UNSIGNED_LONG_LONG_FORMAT ") total(" UNSIGNED_LONG_LONG_FORMAT ")\n", iPopCount, iTotal );
+		return false;
+	}
+
+	printf( "producer(%d) commands(" UNSIGNED_LONG_LONG_FORMAT ") wakeup(" UNSIGNED_LONG_LONG_FORMAT ") %.0f commands/sec\n", iThreadCount, iTotal, iWakeCount
+		, iUs ? (double)iTotal * 1000000 / iUs : 0 );
+
+	return true;
+}
+
+#else
+
+bool TestQueue( int argc, char * argv[] )
+{
+	printf( "eventfd is not supported\n" );
+	return false;
+}
+
+#endif
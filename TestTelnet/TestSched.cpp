@@ -0,0 +1,407 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+
+#include "TestTelnet.h"
+#include "SendScheduler.h"
+
+#ifndef WIN32
+
+#include <poll.h>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <netinet/tcp.h>
+
+#define TEST_SCHED_PORT					18892
+
+// ִ bulk  
+#define TEST_SCHED_MAX_BULK			64
+
+// interactive  echo û  û  ( milli second  )
+#define TEST_SCHED_PING_COUNT		200
+#define TEST_SCHED_PING_MS			10
+
+// interactive  echo  ũ. shell    ϴ ũ ϰ Ѵ.
+#define TEST_SCHED_ECHO_SIZE		64
+
+// bulk  ѹ ť ϴ ũ ť ϴ ũ.  relay  SESSION_MAX_BUF_SIZE  PTY  ť Ѵ.
+#define TEST_SCHED_BULK_SIZE		16384
+#define TEST_SCHED_BULK_QUEUE		( 256 * 1024 )
+
+/**
+ * @ingroup TestTelnet
+ * @brief   Ŷ   ϳ ť Ѵ. ٷ  NIC ť  Ѵ.
+ */
+class CTestFifo
+{
+public:
+	CTestFifo();
+
+	void Send( int iIndex, const char * pszData, int iLen );
+	int Run( std::vector< Socket > & clsSocketList );
+
+	/** Ǻ   ũ */
+	std::vector< int > m_clsQueueSizeList;
+
+	/**   Ŷ   ۰   POLLOUT  ٸ .  -1 ̴. */
+	int	m_iBlocked;
+
+	CTokenBucket	m_clsLinkBucket;
+
+private:
+	/**  ȣ Ŷ */
+	std::deque< std::pair< int, std::string > > m_clsQueue;
+
+	/**   Ŷ  ũ */
+	size_t	m_iSentLen;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief  thread 
+ */
+class CTestSchedPeer
+{
+public:
+	Socket	m_hSocket;
+
+	/** interactive  echo պ ð  ( micro second  ) */
+	std::vector< uint64_t > m_clsRttList;
+
+	/** bulk   ũ */
+	uint64_t	m_iRecvSize;
+
+	/** interactive    true  Ѵ. */
+	volatile bool	m_bStop;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief 
+ */
+CTestFifo::CTestFifo() : m_iBlocked(-1), m_iSentLen(0)
+{
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief Ŷ ť  ڿ Ѵ.
+ */
+void CTestFifo::Send( int iIndex, const char * pszData, int iLen )
+{
+	m_clsQueue.push_back( std::pair< int, std::string >( iIndex, std::string( pszData, iLen ) ) );
+	m_clsQueueSizeList[iIndex] += iLen;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief ũ token   ִ  ť   Ŷ Ѵ.
+ * @returns token  Ǳ⸦ ٸ  ð ( milli second  )  ϰ ׷  -1  Ѵ.
+ */
+int CTestFifo::Run( std::vector< Socket > & clsSocketList )
+{
+	m_clsLinkBucket.Update( GetTimeUs() );
+
+	while( m_clsQueue.empty() == false && m_iBlocked == -1 )
+	{
+		if( m_clsLinkBucket.IsAvailable() == false ) return (int)( ( m_clsLinkBucket.GetWaitUs() + 999 ) / 1000 );
+
+		int iIndex = m_clsQueue.front().first;
+		std::string & strData = m_clsQueue.front().second;
+
+		int n = send( clsSocketList[iIndex], strData.data() + m_iSentLen, strData.length() - m_iSentLen, MSG_DONTWAIT | MSG_NOSIGNAL );
+		if( n <= 0 )
+		{
+			m_iBlocked = iIndex;
+			break;
+		}
+
+		m_clsLinkBucket.Consume( n );
+		m_clsQueueSizeList[iIndex] -= n;
+		m_iSentLen += n;
+
+		if( m_iSentLen == strData.length() )
+		{
+			m_clsQueue.pop_front();
+			m_iSentLen = 0;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief TEST_SCHED_PING_MS  1 byte  ϰ TEST_SCHED_ECHO_SIZE ũ    ð Ѵ.
+ */
+static THREAD_API PingThread( LPVOID lpParameter )
+{
+	CTestSchedPeer * pclsPeer = (CTestSchedPeer *)lpParameter;
+	char szBuf[TEST_SCHED_ECHO_SIZE];
+
+	for( int i = 0; i < TEST_SCHED_PING_COUNT; ++i )
+	{
+		uint64_t iStart = GetTimeUs();
+
+		if( TcpSend( pclsPeer->m_hSocket, "p", 1 ) != 1 || TcpRecvSize( pclsPeer->m_hSocket, szBuf, sizeof(szBuf), 10 ) != sizeof(szBuf) ) break;
+
+		pclsPeer->m_clsRttList.push_back( GetTimeUs() - iStart );
+		usleep( TEST_SCHED_PING_MS * 1000 );
+	}
+
+	pclsPeer->m_bStop = true;
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief    Ѵ.
+ */
+static THREAD_API BulkThread( LPVOID lpParameter )
+{
+	CTestSchedPeer * pclsPeer = (CTestSchedPeer *)lpParameter;
+	static char szBuf[65536];
+	int n;
+
+	while( ( n = recv( pclsPeer->m_hSocket, szBuf, sizeof(szBuf), 0 ) ) > 0 )
+	{
+		pclsPeer->m_iRecvSize += n;
+	}
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief loopback TCP  ϳ interactive ǰ iBulkCount  bulk  ϰ iRate  ѵ ũ   echo  ð Ѵ.
+ *	- 0   interactive ̰   ť TEST_SCHED_BULK_QUEUE ̻ ϴ bulk ̴.
+ * @param bSched			CSendScheduler  Ϸ true  Էϰ ϳ FIFO ť Ϸ false  ԷѴ.
+ * @param iBulkCount	bulk  
+ * @param iRate				ũ ӵ ( ʴ byte )
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestLink( bool bSched, int iBulkCount, uint64_t iRate )
+{
+	CSendScheduler clsScheduler;
+	CTestFifo clsFifo;
+	std::vector< CTestSchedPeer > clsPeerList( iBulkCount + 1 );
+	std::vector< pthread_t > clsThreadList;
+	std::vector< Socket > clsSocketList;
+	std::vector< pollfd > clsPollList;
+	char szBuf[TEST_SCHED_BULK_SIZE];
+	uint64_t iStart, iRecvSize = 0;
+	pthread_t sttThread;
+	pollfd sttPoll;
+	int i, n, iTimeout;
+	bool bRes = true;
+
+	Socket hListen = TcpListen( TEST_SCHED_PORT, 255, "127.0.0.1" );
+	if( hListen == INVALID_SOCKET )
+	{
+		printf( "TcpListen(%d) error(%d)\n", TEST_SCHED_PORT, GetError() );
+		return false;
+	}
+
+	// poll timeout  milli second ̹Ƿ 1 ms ̻   ִ burst  Ѵ.
+	uint64_t iBurst = iRate / 500;
+	if( iBurst < 65536 ) iBurst = 65536;
+
+	clsScheduler.SetLinkLimit( iRate, iBurst );
+	clsFifo.m_clsLinkBucket.Set( iRate, iBurst );
+	clsFifo.m_clsQueueSizeList.resize( iBulkCount + 1, 0 );
+
+	for( i = 0; i <= iBulkCount; ++i )
+	{
+		clsPeerList[i].m_hSocket = TcpConnect( "127.0.0.1", TEST_SCHED_PORT, 10 );
+		clsPeerList[i].m_iRecvSize = 0;
+		clsPeerList[i].m_bStop = false;
+
+		Socket hConn = ( clsPeerList[i].m_hSocket == INVALID_SOCKET ) ? INVALID_SOCKET : accept( hListen, NULL, NULL );
+		if( hConn == INVALID_SOCKET )
+		{
+			bRes = false;
+			break;
+		}
+
+		n = 1;
+		setsockopt( hConn, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(n) );
+		setsockopt( clsPeerList[i].m_hSocket, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(n) );
+
+		clsSocketList.push_back( hConn );
+		clsScheduler.AddSession( i, hConn, "127.0.0.1" );
+	}
+
+	closesocket( hListen );
+
+	for( i = 0; bRes && i <= iBulkCount; ++i )
+	{
+		if( pthread_create( &sttThread, NULL, i == 0 ? PingThread : BulkThread, &clsPeerList[i] ) != 0 )
+		{
+			bRes = false;
+			break;
+		}
+
+		clsThreadList.push_back( sttThread );
+	}
+
+	memset( szBuf, 'b', sizeof(szBuf) );
+	iStart = GetTimeUs();
+
+	while( bRes && clsPeerList[0].m_bStop == false )
+	{
+		// bulk  PTY   ߻ϴ ǰ  ť ä.
+		for( i = 1; i <= iBulkCount; ++i )
+		{
+			if( bSched )
+			{
+				while( clsScheduler.GetSessionQueueSize( i ) < TEST_SCHED_BULK_QUEUE ) clsScheduler.Send( i, 0, szBuf, sizeof(szBuf) );
+			}
+			else
+			{
+				while( clsFifo.m_clsQueueSizeList[i] < TEST_SCHED_BULK_QUEUE ) clsFifo.Send( i, szBuf, sizeof(szBuf) );
+			}
+		}
+
+		iTimeout = bSched ? clsScheduler.Run() : clsFifo.Run( clsSocketList );
+		if( iTimeout == -1 || iTimeout > TEST_SCHED_PING_MS ) iTimeout = TEST_SCHED_PING_MS;
+
+		clsPollList.clear();
+
+		for( i = 0; i <= iBulkCount; ++i )
+		{
+			memset( &sttPoll, 0, sizeof(sttPoll) );
+			sttPoll.fd = clsSocketList[i];
+
+			if( i == 0 ) sttPoll.events |= POLLIN;
+			if( bSched ? clsScheduler.IsBlocked( i ) : ( clsFifo.m_iBlocked == i ) ) sttPoll.events |= POLLOUT;
+
+			clsPollList.push_back( sttPoll );
+		}
+
+		if( poll( &clsPollList[0], clsPollList.size(), iTimeout ) <= 0 ) continue;
+
+		for( i = 0; i <= iBulkCount; ++i )
+		{
+			if( ( clsPollList[i].revents & POLLOUT ) == 0 ) continue;
+
+			if( bSched )
+			{
+				clsScheduler.SetWritable( i );
+			}
+			else
+			{
+				clsFifo.m_iBlocked = -1;
+			}
+		}
+
+		if( clsPollList[0].revents & POLLIN )
+		{
+			n = recv( clsSocketList[0], szBuf, sizeof(szBuf), MSG_DONTWAIT );
+			if( n <= 0 ) break;
+
+			// û shell    ϴ Ͱ  Ѵ.
+			for( int j = 0; j < n; ++j )
+			{
+				if( bSched )
+				{
+					clsScheduler.Send( 0, 0, szBuf, TEST_SCHED_ECHO_SIZE );
+				}
+				else
+				{
+					clsFifo.Send( 0, szBuf, TEST_SCHED_ECHO_SIZE );
+				}
+			}
+
+			memset( szBuf, 'b', sizeof(szBuf) );
+
+			if( bSched ) clsScheduler.Run();
+			else clsFifo.Run( clsSocketList );
+		}
+	}
+
+	uint64_t iElapsedUs = GetTimeUs() - iStart;
+
+	//  thread  ǵ   ݴ´.
+	for( i = 0; i < (int)clsSocketList.size(); ++i )
+	{
+		shutdown( clsSocketList[i], SHUT_RDWR );
+		closesocket( clsSocketList[i] );
+	}
+
+	for( i = 0; i < (int)clsThreadList.size(); ++i )
+	{
+		pthread_join( clsThreadList[i], NULL );
+	}
+
+	for( i = 0; i <= iBulkCount; ++i )
+	{
+		if( clsPeerList[i].m_hSocket != INVALID_SOCKET ) closesocket( clsPeerList[i].m_hSocket );
+		iRecvSize += clsPeerList[i].m_iRecvSize;
+	}
+
+	std::vector< uint64_t > & clsRttList = clsPeerList[0].m_clsRttList;
+
+	if( bRes == false || clsRttList.size() != TEST_SCHED_PING_COUNT )
+	{
+		printf( "%-9s error\n", bSched ? "scheduler" : "fifo" );
+		return false;
+	}
+
+	std::sort( clsRttList.begin(), clsRttList.end() );
+
+	printf( "%-9s echo p50 %8.2f ms  p99 %8.2f ms  max %8.2f ms  bulk %7.2f MB/s\n", bSched ? "scheduler" : "fifo"
+		, clsRttList[TEST_SCHED_PING_COUNT / 2] / 1000.0, clsRttList[TEST_SCHED_PING_COUNT * 99 / 100] / 1000.0
+		, clsRttList[TEST_SCHED_PING_COUNT - 1] / 1000.0, iElapsedUs ? (double)iRecvSize / iElapsedUs : 0 );
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief bulk  ũ ȭŲ ¿ interactive  echo  ð FIFO ۰ CSendScheduler  Ѵ.
+ *	-  : TestTelnet sched [bulk session] [link MB/s]
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestSched( int argc, char * argv[] )
+{
+	int iBulkCount = argc >= 1 ? atoi( argv[0] ) : 4;
+	uint64_t iRate = (uint64_t)( argc >= 2 ? atoi( argv[1] ) : 50 ) * 1000 * 1000;
+
+	if( iBulkCount < 1 || iBulkCount > TEST_SCHED_MAX_BULK || iRate == 0 ) return false;
+
+	printf( "%d bulk sessions, link " UNSIGNED_LONG_LONG_FORMAT " MB/s\n", iBulkCount, iRate / 1000000 );
+
+	if( TestLink( false, iBulkCount, iRate ) == false ) return false;
+	if( TestLink( true, iBulkCount, iRate ) == false ) return false;
+
+	return true;
+}
+
+#else
+
+bool TestSched( int argc, char * argv[] )
+{
+	printf( "send scheduler test is not supported\n" );
+	return false;
+}
+
+#endif
@@ -0,0 +1,369 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+
+#include "TestTelnet.h"
+#include "ShmRing.h"
+#include "Handover.h"
+
+#ifndef WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <netinet/tcp.h>
+
+#define TEST_SHM_PORT				18891
+
+// պ  ð ϴ 1 byte ޽ 
+#define TEST_SHM_PING_COUNT	100000
+
+//  ӵ   ѹ ϴ ũ
+#define TEST_SHM_BUF_SIZE		( 64 * 1024 )
+
+// CShmRing     ġ
+#define TEST_SHM_DATA_OFFSET	4096
+
+/**
+ * @ingroup TestTelnet
+ * @brief  . m_pclsChannel  NULL ̸ TCP  Ѵ.
+ */
+class CTestShmConn
+{
+public:
+	CTestShmConn();
+
+	int Send( const char * pszBuf, int iLen );
+	int Recv( char * pszBuf, int iBufSize );
+
+	Socket	m_hSocket;
+	CShmChannel * m_pclsChannel;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief echo thread 
+ */
+class CTestShmPeer
+{
+public:
+	/** TCP listen  Ǵ  ޸ ä  Unix   */
+	Socket	m_hSocket;
+	bool		m_bShm;
+	uint64_t	m_iSize;
+	bool		m_bRes;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief 
+ */
+CTestShmConn::CTestShmConn() : m_hSocket(INVALID_SOCKET), m_pclsChannel(NULL)
+{
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief ͸  Ѵ.
+ */
+int CTestShmConn::Send( const char * pszBuf, int iLen )
+{
+	if( m_pclsChannel ) return m_pclsChannel->Send( pszBuf, iLen, 10 );
+
+	return TcpSend( m_hSocket, pszBuf, iLen );
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief ŵ ͸ ´.
+ */
+int CTestShmConn::Recv( char * pszBuf, int iBufSize )
+{
+	if( m_pclsChannel ) return m_pclsChannel->Recv( pszBuf, iBufSize, 10 );
+
+	return TcpRecv( m_hSocket, pszBuf, iBufSize, 10 );
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief 1 byte ޽ TEST_SHM_PING_COUNT  ǵ  m_iSize ŭ  Ŀ 1 byte  ȮѴ.
+ */
+static THREAD_API EchoThread( LPVOID lpParameter )
+{
+	CTestShmPeer * pclsPeer = (CTestShmPeer *)lpParameter;
+	CTestShmConn clsConn;
+	CShmChannel clsChannel;
+	static char szBuf[TEST_SHM_BUF_SIZE];
+	uint64_t iRecvSize = 0;
+	int i, n;
+
+	if( pclsPeer->m_bShm )
+	{
+		if( clsChannel.Import( pclsPeer->m_hSocket, 10 ) == false ) return 0;
+		clsConn.m_pclsChannel = &clsChannel;
+	}
+	else
+	{
+		clsConn.m_hSocket = accept( pclsPeer->m_hSocket, NULL, NULL );
+		if( clsConn.m_hSocket == INVALID_SOCKET ) return 0;
+
+		n = 1;
+		setsockopt( clsConn.m_hSocket, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(n) );
+	}
+
+	for( i = 0; i < TEST_SHM_PING_COUNT; ++i )
+	{
+		if( clsConn.Recv( szBuf, 1 ) != 1 || clsConn.Send( szBuf, 1 ) != 1 ) break;
+	}
+
+	while( i == TEST_SHM_PING_COUNT && iRecvSize < pclsPeer->m_iSize )
+	{
+		n = clsConn.Recv( szBuf, sizeof(szBuf) );
+		if( n <= 0 ) break;
+
+		iRecvSize += n;
+	}
+
+	if( iRecvSize == pclsPeer->m_iSize && clsConn.Send( "A", 1 ) == 1 )
+	{
+		pclsPeer->m_bRes = true;
+	}
+
+	if( clsConn.m_hSocket != INVALID_SOCKET ) closesocket( clsConn.m_hSocket );
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief 1 byte պ  ð  ӵ Ѵ.
+ * @param bShm	 ޸ ä Ϸ true  Էϰ loopback TCP  Ϸ false  ԷѴ.
+ * @param iSize	 ũ
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestTransport( bool bShm, uint64_t iSize )
+{
+	CTestShmPeer clsPeer;
+	CTestShmConn clsConn;
+	CShmChannel clsChannel;
+	static char szBuf[TEST_SHM_BUF_SIZE];
+	pthread_t sttThread;
+	uint64_t iStart, iPingUs = 0, iStreamUs = 0, i;
+	int arrFd[2] = { -1, -1 }, n;
+	bool bRes = true;
+	const char * pszName = bShm ? "shm ring" : "tcp";
+
+	clsPeer.m_bShm = bShm;
+	clsPeer.m_iSize = iSize;
+	clsPeer.m_bRes = false;
+
+	if( bShm )
+	{
+		if( socketpair( AF_UNIX, SOCK_STREAM, 0, arrFd ) == -1 ) return false;
+		clsPeer.m_hSocket = arrFd[1];
+	}
+	else
+	{
+		clsPeer.m_hSocket = TcpListen( TEST_SHM_PORT, 1, "127.0.0.1" );
+		if( clsPeer.m_hSocket == INVALID_SOCKET )
+		{
+			printf( "TcpListen(%d) error(%d)\n", TEST_SHM_PORT, GetError() );
+			return false;
+		}
+	}
+
+	if( pthread_create( &sttThread, NULL, EchoThread, &clsPeer ) != 0 )
+	{
+		closesocket( clsPeer.m_hSocket );
+		if( arrFd[0] != -1 ) close( arrFd[0] );
+		return false;
+	}
+
+	if( bShm )
+	{
+		bRes = clsChannel.Create() && clsChannel.Export( arrFd[0] );
+		clsConn.m_pclsChannel = &clsChannel;
+	}
+	else
+	{
+		clsConn.m_hSocket = TcpConnect( "127.0.0.1", TEST_SHM_PORT, 10 );
+		if( clsConn.m_hSocket == INVALID_SOCKET )
+		{
+			bRes = false;
+		}
+		else
+		{
+			n = 1;
+			setsockopt( clsConn.m_hSocket, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(n) );
+		}
+	}
+
+	if( bRes )
+	{
+		iStart = GetTimeUs();
+
+		for( i = 0; i < TEST_SHM_PING_COUNT; ++i )
+		{
+			if( clsConn.Send( "p", 1 ) != 1 || clsConn.Recv( szBuf, 1 ) != 1 )
+			{
+				bRes = false;
+				break;
+			}
+		}
+
+		iPingUs = GetTimeUs() - iStart;
+	}
+
+	if( bRes )
+	{
+		memset( szBuf, 'a', sizeof(szBuf) );
+		iStart = GetTimeUs();
+
+		for( i = 0; i < iSize; i += n )
+		{
+			n = ( iSize - i < sizeof(szBuf) ) ? (int)( iSize - i ) : (int)sizeof(szBuf);
+
+			if( clsConn.Send( szBuf, n ) != n )
+			{
+				bRes = false;
+				break;
+			}
+		}
+
+		//  thread     Ѵ.
+		if( bRes && clsConn.Recv( szBuf, 1 ) != 1 ) bRes = false;
+
+		iStreamUs = GetTimeUs() - iStart;
+	}
+
+	// echo thread  ϰ  ٷ ǵ Ѵ.
+	clsChannel.Close();
+	if( clsConn.m_hSocket != INVALID_SOCKET ) shutdown( clsConn.m_hSocket, SHUT_RDWR );
+	if( bShm == false ) shutdown( clsPeer.m_hSocket, SHUT_RDWR );
+
+	pthread_join( sttThread, NULL );
+
+	if( clsConn.m_hSocket != INVALID_SOCKET ) closesocket( clsConn.m_hSocket );
+	closesocket( clsPeer.m_hSocket );
+	if( arrFd[0] != -1 ) close( arrFd[0] );
+
+	if( bRes == false || clsPeer.m_bRes == false )
+	{
+		printf( "%-10s error\n", pszName );
+		return false;
+	}
+
+	printf( "%-10s round trip %6.2f us  stream %6.2f GB/s\n", pszName
+		, (double)iPingUs / TEST_SHM_PING_COUNT, iStreamUs ? (double)iSize / iStreamUs / 1000 : 0 );
+
+	return true;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief    ޸𸮸 CShmRing  źϴ ˻Ѵ.
+ *	- ũⰡ   memfd  Import  ؾ Ѵ.
+ *	- head  ring ũ⸦ ʰϸ Read  ؾ Ѵ.
+ * @param bSeal	memfd ũ⸦ Ϸ true  ԷѴ.
+ * @returns źϿ true  ϰ ׷  false  Ѵ.
+ */
+static bool TestForge( bool bSeal )
+{
+	SHM_RING_HEADER * psttHeader;
+	CShmRing clsRing;
+	char szBuf[16];
+	int arrFd[3], arrUnix[2];
+	bool bRes = false;
+
+	arrFd[0] = memfd_create( "test-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+	arrFd[1] = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+	arrFd[2] = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+
+	if( arrFd[0] == -1 || arrFd[1] == -1 || arrFd[2] == -1 ) return false;
+	if( ftruncate( arrFd[0], TEST_SHM_DATA_OFFSET + 4096 ) == -1 ) return false;
+	if( bSeal && fcntl( arrFd[0], F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL ) == -1 ) return false;
+
+	psttHeader = (SHM_RING_HEADER *)mmap( NULL, TEST_SHM_DATA_OFFSET + 4096, PROT_READ | PROT_WRITE, MAP_SHARED, arrFd[0], 0 );
+	if( psttHeader == MAP_FAILED ) return false;
+
+	psttHeader->iSize = 4096;
+	psttHeader->iHead = 0x10000;
+	psttHeader->iTail = 0;
+
+	if( socketpair( AF_UNIX, SOCK_STREAM, 0, arrUnix ) == 0 )
+	{
+		if( SendFd( arrUnix[0], arrFd, 3, "R", 1 ) )
+		{
+			bool bImport = clsRing.Import( arrUnix[1], 1 );
+
+			if( bSeal )
+			{
+				bRes = bImport && ( clsRing.Read( szBuf, sizeof(szBuf), 1 ) == SOCKET_ERROR );
+			}
+			else
+			{
+				bRes = ( bImport == false );
+			}
+		}
+
+		close( arrUnix[0] );
+		close( arrUnix[1] );
+	}
+
+	clsRing.Close();
+	munmap( psttHeader, TEST_SHM_DATA_OFFSET + 4096 );
+
+	for( int i = 0; i < 3; ++i ) close( arrFd[i] );
+
+	printf( "forged ring ( %s ) %s\n", bSeal ? "head overflow" : "unsealed memfd", bRes ? "rejected" : "accepted" );
+
+	return bRes;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief  ޸ äΰ loopback TCP  պ  ð  ӵ ϰ ۵ ring  źϴ ˻Ѵ.
+ *	-  : TestTelnet shm [MB]
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestShm( int argc, char * argv[] )
+{
+	uint64_t iSize = (uint64_t)( argc >= 1 ? atoi( argv[0] ) : 1024 ) * 1024 * 1024;
+
+	if( iSize == 0 ) return false;
+
+	if( TestForge( false ) == false ) return false;
+	if( TestForge( true ) == false ) return false;
+
+	if( TestTransport( true, iSize ) == false ) return false;
+	if( TestTransport( false, iSize ) == false ) return false;
+
+	return true;
+}
+
+#else
+
+bool TestShm( int argc, char * argv[] )
+{
+	printf( "shared memory ring is not supported\n" );
+	return false;
+}
+
+#endif
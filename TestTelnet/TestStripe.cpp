@@ -0,0 +1,501 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "TestTelnet.h"
+#include "StripeTransfer.h"
+
+#ifdef USE_TLS
+
+#include <poll.h>
+#include <math.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <deque>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define TEST_STRIPE_PSK					"test-stripe-pre-shared-key"
+
+//  Ʈ  / ս ߰ϴ proxy Ʈ
+#define TEST_STRIPE_PORT				18893
+#define TEST_STRIPE_PROXY_PORT	18894
+
+#define TEST_STRIPE_FILE				"TestStripe.bin"
+#define TEST_STRIPE_DIR					"TestStripe.recv"
+
+// proxy  ѹ ϴ ũ
+#define TEST_STRIPE_SEGMENT			16384
+
+// ս Ȯ ϴ Ŷ ũ ( Ethernet MSS )
+#define TEST_STRIPE_MSS					1448
+
+// Ằ ִ window ũ.  ۸   ȣƮ   ϳ  ӵ window / RTT  Ѵ.
+#define TEST_STRIPE_WINDOW			( 1024 * 1024 )
+
+//   ̸   ٸ ִ ð ( milli second  )
+#define TEST_STRIPE_WAIT_MS			10000
+
+/**
+ * @ingroup TestTelnet
+ * @brief proxy ũ 
+ */
+class CTestStripeLink
+{
+public:
+	/** ܹ  ð ( milli second  ) */
+	int			m_iDelayMs;
+
+	/** Ŷ ս Ȯ ( % ) */
+	double	m_dLoss;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief   proxy  thread 
+ */
+class CTestStripePipe
+{
+public:
+	Socket	m_hRecv;
+	Socket	m_hSend;
+	CTestStripeLink * m_pclsLink;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief Ǿ ޵ segment
+ */
+class CTestStripeSegment
+{
+public:
+	/**  ð window  ȯǴ ð ( micro second  ) */
+	uint64_t	m_iDeliverUs;
+	uint64_t	m_iAckUs;
+
+	int	m_iLen;
+	std::string	m_strData;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief listen     Ǵ proxy  ϴ thread 
+ */
+class CTestStripeAccept
+{
+public:
+	Socket	m_hListen;
+	CStripeReceiver * m_pclsReceiver;
+	CTestStripeLink * m_pclsLink;
+};
+
+/**
+ * @ingroup TestTelnet
+ * @brief netem     ͸  / սǽѼ Ѵ.
+ *	- Ḷ TCP   window ŭ   ͸ ϰ window  RTT Ŀ ȯȴ.
+ *	- սǵ Ŷ  RTT Ŀ ۵ Ͱ  Ű  segment   Ű window   δ.
+ *	- window  ȯ  TCP congestion avoidance   Ų.
+ */
+static void RunPipe( CTestStripePipe * pclsPipe )
+{
+	CTestStripeLink * pclsLink = pclsPipe->m_pclsLink;
+	std::deque< CTestStripeSegment > clsQueue, clsAckList;
+	char szBuf[TEST_STRIPE_SEGMENT];
+	uint64_t iDelayUs = (uint64_t)pclsLink->m_iDelayMs * 1000, iLastDeliverUs = 0;
+	double dWindow = TEST_STRIPE_WINDOW;
+	unsigned int iSeed = (unsigned int)( GetTimeUs() ^ pclsPipe->m_hRecv );
+	int iInFlight = 0, iTimeout, n;
+	bool bEof = false, bError = false;
+	pollfd sttPoll[1];
+
+	while( 1 )
+	{
+		uint64_t iNow = GetTimeUs();
+
+		while( clsQueue.empty() == false && clsQueue.front().m_iDeliverUs <= iNow )
+		{
+			std::string & strData = clsQueue.front().m_strData;
+
+			if( TcpSend( pclsPipe->m_hSend, strData.data(), (int)strData.length() ) != (int)strData.length() )
+			{
+				bError = true;
+				break;
+			}
+
+			clsAckList.push_back( clsQueue.front() );
+			clsAckList.back().m_strData.clear();
+			clsQueue.pop_front();
+		}
+
+		if( bError ) break;
+
+		while( clsAckList.empty() == false && clsAckList.front().m_iAckUs <= iNow )
+		{
+			iInFlight -= clsAckList.front().m_iLen;
+			clsAckList.pop_front();
+
+			dWindow += (double)TEST_STRIPE_SEGMENT * TEST_STRIPE_SEGMENT / dWindow;
+			if( dWindow > TEST_STRIPE_WINDOW ) dWindow = TEST_STRIPE_WINDOW;
+		}
+
+		if( bEof && clsQueue.empty() )
+		{
+			shutdown( pclsPipe->m_hSend, SHUT_WR );
+			break;
+		}
+
+		//   Ǵ window ȯ ð Ѵ.
+		uint64_t iNextUs = 0;
+
+		if( clsQueue.empty() == false ) iNextUs = clsQueue.front().m_iDeliverUs;
+		if( clsAckList.empty() == false && ( iNextUs == 0 || clsAckList.front().m_iAckUs < iNextUs ) ) iNextUs = clsAckList.front().m_iAckUs;
+
+		iTimeout = ( iNextUs == 0 ) ? 1000 : (int)( ( iNextUs - iNow + 999 ) / 1000 );
+
+		if( bEof || iInFlight + TEST_STRIPE_SEGMENT > (int)dWindow )
+		{
+			poll( NULL, 0, iTimeout );
+			continue;
+		}
+
+		TcpSetPollIn( sttPoll[0], pclsPipe->m_hRecv );
+		if( poll( sttPoll, 1, iTimeout ) <= 0 ) continue;
+
+		n = recv( pclsPipe->m_hRecv, szBuf, sizeof(szBuf), 0 );
+		if( n <= 0 )
+		{
+			bEof = true;
+			continue;
+		}
+
+		iNow = GetTimeUs();
+
+		// segment  Ե Ŷ  ϳ սǵǸ ۵  segment   segment  ȴ.
+		double dLossRate = 1.0 - pow( 1.0 - pclsLink->m_dLoss / 100.0, (double)( n + TEST_STRIPE_MSS - 1 ) / TEST_STRIPE_MSS );
+		bool bLost = ( (double)rand_r( &iSeed ) / RAND_MAX < dLossRate );
+
+		CTestStripeSegment clsSegment;
+
+		clsSegment.m_iDeliverUs = iNow + iDelayUs + ( bLost ? iDelayUs * 2 : 0 );
+		if( clsSegment.m_iDeliverUs < iLastDeliverUs ) clsSegment.m_iDeliverUs = iLastDeliverUs;
+		clsSegment.m_iAckUs = clsSegment.m_iDeliverUs + iDelayUs;
+		clsSegment.m_iLen = n;
+		clsSegment.m_strData.assign( szBuf, n );
+
+		iLastDeliverUs = clsSegment.m_iDeliverUs;
+		iInFlight += n;
+
+		if( bLost )
+		{
+			dWindow /= 2;
+			if( dWindow < TEST_STRIPE_SEGMENT ) dWindow = TEST_STRIPE_SEGMENT;
+		}
+
+		clsQueue.push_back( clsSegment );
+	}
+
+	// ٸ  thread  ǵ Ѵ.
+	if( bError )
+	{
+		shutdown( pclsPipe->m_hRecv, SHUT_RDWR );
+		shutdown( pclsPipe->m_hSend, SHUT_RDWR );
+	}
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief  ->   proxy thread
+ */
+static THREAD_API PipeThread( LPVOID lpParameter )
+{
+	RunPipe( (CTestStripePipe *)lpParameter );
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief proxy  thread.  Ͽ   / սǽѼ Ѵ.
+ */
+static THREAD_API ProxyThread( LPVOID lpParameter )
+{
+	CTestStripePipe * pclsPipe = (CTestStripePipe *)lpParameter;
+	CTestStripePipe clsReverse;
+	pthread_t sttThread;
+
+	pclsPipe->m_hSend = TcpConnect( "127.0.0.1", TEST_STRIPE_PORT, 10 );
+	if( pclsPipe->m_hSend != INVALID_SOCKET )
+	{
+		clsReverse.m_hRecv = pclsPipe->m_hSend;
+		clsReverse.m_hSend = pclsPipe->m_hRecv;
+		clsReverse.m_pclsLink = pclsPipe->m_pclsLink;
+
+		if( pthread_create( &sttThread, NULL, PipeThread, &clsReverse ) == 0 )
+		{
+			RunPipe( pclsPipe );
+			pthread_join( sttThread, NULL );
+		}
+
+		closesocket( pclsPipe->m_hSend );
+	}
+
+	closesocket( pclsPipe->m_hRecv );
+	delete pclsPipe;
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief listen     Ѵ.  Ǿ   ϰ ׷  proxy thread  Ѵ.
+ */
+static THREAD_API AcceptThread( LPVOID lpParameter )
+{
+	CTestStripeAccept * pclsAccept = (CTestStripeAccept *)lpParameter;
+	pthread_t sttThread;
+	Socket hConn;
+
+	while( ( hConn = accept( pclsAccept->m_hListen, NULL, NULL ) ) != INVALID_SOCKET )
+	{
+		if( pclsAccept->m_pclsReceiver )
+		{
+			pclsAccept->m_pclsReceiver->Add( hConn );
+			continue;
+		}
+
+		CTestStripePipe * pclsPipe = new CTestStripePipe();
+
+		pclsPipe->m_hRecv = hConn;
+		pclsPipe->m_hSend = INVALID_SOCKET;
+		pclsPipe->m_pclsLink = pclsAccept->m_pclsLink;
+
+		if( pthread_create( &sttThread, NULL, ProxyThread, pclsPipe ) != 0 )
+		{
+			closesocket( hConn );
+			delete pclsPipe;
+			continue;
+		}
+
+		pthread_detach( sttThread );
+	}
+
+	return 0;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief     ˻Ѵ.
+ */
+static bool CompareFile( const char * pszFileName, const char * pszOtherName )
+{
+	static char szBuf[2][65536];
+	int iFd = open( pszFileName, O_RDONLY ), iOtherFd = open( pszOtherName, O_RDONLY );
+	bool bRes = ( iFd != -1 && iOtherFd != -1 );
+	int n;
+
+	while( bRes )
+	{
+		n = read( iFd, szBuf[0], sizeof(szBuf[0]) );
+		if( n < 0 || read( iOtherFd, szBuf[1], n ) != n || memcmp( szBuf[0], szBuf[1], n ) )
+		{
+			bRes = false;
+			break;
+		}
+
+		if( n == 0 ) break;
+	}
+
+	if( bRes && read( iOtherFd, szBuf[1], 1 ) != 0 ) bRes = false;
+
+	if( iFd != -1 ) close( iFd );
+	if( iOtherFd != -1 ) close( iOtherFd );
+
+	return bRes;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief    ӽ  Ѵ.
+ * @param clsReceiver  ü
+ * @returns ӽ    ʾ true  ϰ ׷  false  Ѵ.
+ */
+static bool CheckPartFile( CStripeReceiver & clsReceiver )
+{
+	bool bRes = true;
+
+	//     Ŀ ӽ  Ѵ.
+	for( int i = 0; i < TEST_STRIPE_WAIT_MS / 10 && clsReceiver.GetFileCount() > 0; ++i )
+	{
+		usleep( 10000 );
+	}
+
+	DIR * psttDir = opendir( TEST_STRIPE_DIR );
+	if( psttDir == NULL ) return false;
+
+	struct dirent * psttEntry;
+
+	while( ( psttEntry = readdir( psttDir ) ) != NULL )
+	{
+		if( strncmp( psttEntry->d_name, ".stripe_", 8 ) ) continue;
+
+		std::string strFileName = TEST_STRIPE_DIR "/";
+
+		strFileName.append( psttEntry->d_name );
+		printf( "temporary file %s is left\n", strFileName.c_str() );
+		unlink( strFileName.c_str() );
+		bRes = false;
+	}
+
+	closedir( psttDir );
+
+	return bRes;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief  / ս ִ ũ   Ͽ  Ͽ     ӵ ϰ,   ڵ ϴ ۰ Ѵ.
+ *	- tc netem   ʾƵ ǵ loopback  user-space proxy  , ս, Ằ window  Ѵ.
+ *	-  Ϸ Ŀ   ӽ    Ѵ.
+ *	-  : TestTelnet stripe [delay ms] [loss %] [MB]
+ * @param argc	 
+ * @param argv	 
+ * @returns ϸ true  ϰ ׷  false  Ѵ.
+ */
+bool TestStripe( int argc, char * argv[] )
+{
+	static CStripeReceiver clsReceiver;
+	CTestStripeLink clsLink;
+	CTestStripeAccept clsRecvAccept, clsProxyAccept;
+	pthread_t sttRecvThread, sttProxyThread;
+	std::string strPsk = TEST_STRIPE_PSK, strRecvName = TEST_STRIPE_DIR "/" TEST_STRIPE_FILE;
+	char szBuf[65536];
+	bool bRes = true;
+	int i, iSizeMb;
+
+	clsLink.m_iDelayMs = argc >= 1 ? atoi( argv[0] ) : 25;
+	clsLink.m_dLoss = argc >= 2 ? atof( argv[1] ) : 0.01;
+	iSizeMb = argc >= 3 ? atoi( argv[2] ) : 64;
+
+	if( clsLink.m_iDelayMs < 1 || clsLink.m_dLoss < 0 || clsLink.m_dLoss >= 100 || iSizeMb < 1 ) return false;
+
+	printf( "delay %d ms ( rtt %d ms ), loss %.3f %%, window %d KB, file %d MB\n", clsLink.m_iDelayMs, clsLink.m_iDelayMs * 2, clsLink.m_dLoss
+		, TEST_STRIPE_WINDOW / 1024, iSizeMb );
+
+	int iFd = open( TEST_STRIPE_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( iFd == -1 )
+	{
+		printf( "open(%s) error(%d)\n", TEST_STRIPE_FILE, errno );
+		return false;
+	}
+
+	// ȣȭ  ϰ  ˻  ֵ ġ ٸ  Ѵ.
+	for( i = 0; bRes && i < iSizeMb * 16; ++i )
+	{
+		for( int j = 0; j < (int)sizeof(szBuf); j += 4 )
+		{
+			uint32_t iValue = (uint32_t)i * sizeof(szBuf) + j;
+			memcpy( szBuf + j, &iValue, 4 );
+		}
+
+		if( write( iFd, szBuf, sizeof(szBuf) ) != sizeof(szBuf) ) bRes = false;
+	}
+
+	close( iFd );
+	if( bRes == false ) return false;
+
+	clsReceiver.SetPsk( strPsk );
+	if( clsReceiver.Open( TEST_STRIPE_DIR ) == false ) return false;
+
+	clsRecvAccept.m_hListen = TcpListen( TEST_STRIPE_PORT, 255, "127.0.0.1" );
+	clsRecvAccept.m_pclsReceiver = &clsReceiver;
+	clsRecvAccept.m_pclsLink = NULL;
+
+	clsProxyAccept.m_hListen = TcpListen( TEST_STRIPE_PROXY_PORT, 255, "127.0.0.1" );
+	clsProxyAccept.m_pclsReceiver = NULL;
+	clsProxyAccept.m_pclsLink = &clsLink;
+
+	if( clsRecvAccept.m_hListen == INVALID_SOCKET || clsProxyAccept.m_hListen == INVALID_SOCKET )
+	{
+		printf( "TcpListen error(%d)\n", GetError() );
+		return false;
+	}
+
+	if( pthread_create( &sttRecvThread, NULL, AcceptThread, &clsRecvAccept ) != 0 || pthread_create( &sttProxyThread, NULL, AcceptThread, &clsProxyAccept ) != 0 )
+	{
+		printf( "pthread_create error\n" );
+		exit( 1 );
+	}
+
+	//  STRIPE_INIT_STREAM  Ͽ   ڵ Ѵ.
+	for( int iStream = 1; bRes && iStream <= STRIPE_MAX_STREAM * 2; iStream *= 2 )
+	{
+		CStripeSender clsSender;
+		bool bTune = ( iStream > STRIPE_MAX_STREAM );
+		int iMaxStream = bTune ? STRIPE_MAX_STREAM : iStream;
+
+		unlink( strRecvName.c_str() );
+		clsSender.SetPsk( strPsk );
+
+		uint64_t iStart = GetTimeUs();
+
+		if( clsSender.Send( "127.0.0.1", TEST_STRIPE_PROXY_PORT, TEST_STRIPE_FILE, iMaxStream, bTune ? STRIPE_INIT_STREAM : iMaxStream ) == false )
+		{
+			printf( "%-5s stream %2d : Send error\n", bTune ? "tuned" : "fixed", iMaxStream );
+			bRes = false;
+			break;
+		}
+
+		uint64_t iElapsedUs = GetTimeUs() - iStart;
+
+		//     Ŀ ӽ  ̸ Ѵ.
+		struct stat sttStat;
+
+		for( i = 0; i < TEST_STRIPE_WAIT_MS / 10 && stat( strRecvName.c_str(), &sttStat ) == -1; ++i )
+		{
+			usleep( 10000 );
+		}
+
+		bRes = CompareFile( TEST_STRIPE_FILE, strRecvName.c_str() );
+
+		printf( "%-5s stream %2d %8.2f MB/s %s\n", bTune ? "tuned" : "fixed", clsSender.GetStreamCount()
+			, iElapsedUs ? (double)clsSender.GetFileSize() / iElapsedUs : 0, bRes ? "ok" : "received file is different" );
+
+		if( CheckPartFile( clsReceiver ) == false ) bRes = false;
+	}
+
+	shutdown( clsRecvAccept.m_hListen, SHUT_RDWR );
+	shutdown( clsProxyAccept.m_hListen, SHUT_RDWR );
+	pthread_join( sttRecvThread, NULL );
+	pthread_join( sttProxyThread, NULL );
+	closesocket( clsRecvAccept.m_hListen );
+	closesocket( clsProxyAccept.m_hListen );
+
+	unlink( strRecvName.c_str() );
+	unlink( TEST_STRIPE_FILE );
+
+	return bRes;
+}
+
+#else
+
+bool TestStripe( int argc, char * argv[] )
+{
+	printf( "stripe transfer test is not supported\n" );
+	return false;
+}
+
+#endif
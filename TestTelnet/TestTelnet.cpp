@@ -0,0 +1,112 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#include "TestTelnet.h"
+
+/**
+ * @ingroup TestTelnet
+ * @brief  ð micro second  ´.
+ * @returns  ð Ѵ.
+ */
+uint64_t GetTimeUs()
+{
+	struct timeval sttTime;
+
+	gettimeofday( &sttTime, NULL );
+
+	return (uint64_t)sttTime.tv_sec * 1000000 + sttTime.tv_usec;
+}
+
+/**
+ * @ingroup TestTelnet
+ * @brief  μ  thread   CPU ð ( user + system )  micro second  ´.
+ * @returns CPU ð Ѵ.
+ */
+uint64_t GetCpuUs()
+{
+#ifdef WIN32
+	return 0;
+#else
+	struct rusage sttUsage;
+
+	getrusage( RUSAGE_SELF, &sttUsage );
+
+	return (uint64_t)( sttUsage.ru_utime.tv_sec + sttUsage.ru_stime.tv_sec ) * 1000000 + sttUsage.ru_utime.tv_usec + sttUsage.ru_stime.tv_usec;
+#endif
+}
+
+int main( int argc, char * argv[] )
+{
+	if( argc < 2 )
+	{
+		printf( "[Usage] %s aead [MB]\n", argv[0] );
+		printf( "        %s queue [producer thread] [command per thread]\n", argv[0] );
+		printf( "        %s shm [MB]\n", argv[0] );
+		printf( "        %s sched [bulk session] [link MB/s]\n", argv[0] );
+		printf( "        %s stripe [delay ms] [loss %%] [MB]\n", argv[0] );
+		printf( "        %s handover {session} {server pid} [server ip]\n", argv[0] );
+		return 0;
+	}
+
+	InitNetwork();
+
+#ifndef WIN32
+	signal( SIGPIPE, SIG_IGN );
+#endif
+
+	bool bRes = false;
+
+	if( !strcmp( argv[1], "aead" ) )
+	{
+		bRes = TestAead( argc - 2, argv + 2 );
+	}
+	else if( !strcmp( argv[1], "queue" ) )
+	{
+		bRes = TestQueue( argc - 2, argv + 2 );
+	}
+	else if( !strcmp( argv[1], "shm" ) )
+	{
+		bRes = TestShm( argc - 2, argv + 2 );
+	}
+	else if( !strcmp( argv[1], "sched" ) )
+	{
+		bRes = TestSched( argc - 2, argv + 2 );
+	}
+	else if( !strcmp( argv[1], "stripe" ) )
+	{
+		bRes = TestStripe( argc - 2, argv + 2 );
+	}
+	else if( !strcmp( argv[1], "handover" ) )
+	{
+		bRes = TestHandover( argc - 2, argv + 2 );
+	}
+	else
+	{
+		printf( "unknown test(%s)\n", argv[1] );
+	}
+
+	if( bRes == false )
+	{
+		printf( "ERROR\n" );
+		return 1;
+	}
+
+	printf( "OK\n" );
+
+	return 0;
+}
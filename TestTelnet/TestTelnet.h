@@ -0,0 +1,41 @@
+/* 
+ * Copyright (C) 2023 Yee Young Han <websearch@naver.com> (http://blog.naver.com/websearch)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA 
+ */
+
+#ifndef _TEST_TELNET_H_
+#define _TEST_TELNET_H_
+
+#include "Define.h"
+#include "Tcp.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#include <signal.h>
+#include <sys/resource.h>
+#endif
+
+uint64_t GetTimeUs();
+uint64_t GetCpuUs();
+
+bool TestAead( int argc, char * argv[] );
+bool TestQueue( int argc, char * argv[] );
+bool TestShm( int argc, char * argv[] );
+bool TestSched( int argc, char * argv[] );
+bool TestStripe( int argc, char * argv[] );
+bool TestHandover( int argc, char * argv[] );
+
+#endif